@@ -166,9 +166,11 @@ namespace OAKForUnity
             if (!device.replayResults)
             {
                 // Plugin lib pipeline results implementation
-                bodyPoseResults = Marshal.PtrToStringAnsi(BodyPoseResults(out frameInfo, GETPreview, 300, 300, UseDepth, drawBodyPoseInPreview, bodyLandmarkThreshold, retrieveSystemInformation,
+                IntPtr resultsPtr = BodyPoseResults(out frameInfo, GETPreview, 300, 300, UseDepth, drawBodyPoseInPreview, bodyLandmarkThreshold, retrieveSystemInformation,
                     useIMU,
-                    useSpatialLocator, (int) device.deviceNum));
+                    useSpatialLocator, (int) device.deviceNum);
+                bodyPoseResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
             }
             // if replay read results from file
             else
@@ -40,6 +40,16 @@ namespace OAKForUnity
         */    
         private static extern IntPtr FaceDetectorResults(out FrameInfo frameInfo, bool getPreview, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum);
 
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+        * Pipeline results, binary interface. Same parameters as FaceDetectorResults
+        * Read with ResultsValid, ResultsNumDetections, ResultsBest and ResultsDetection (PredefinedBase)
+        *
+        * @param results buffer of Marshal.SizeOf(typeof(FrameResults)) bytes or IntPtr.Zero to use plugin owned results
+        * @returns FrameResults pointer
+        */
+        private static extern IntPtr FaceDetectorResultsBinary(out FrameInfo frameInfo, bool getPreview, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, IntPtr results);
+
         
         // Editor attributes
         [Header("RGB Camera")] 
@@ -58,6 +68,9 @@ namespace OAKForUnity
         public bool drawBestFaceInPreview;
         public bool drawAllFacesInPreview;
         public float faceScoreThreshold; 
+        // Display preview size (e.g. 640x360) resized on device from full camera view. 0: preview is NN input (300x300 letterbox)
+        public int displayWidth = 0;
+        public int displayHeight = 0;
         private const bool GETPreview = true;
         private const bool UseDepth = true;
 
@@ -76,7 +89,8 @@ namespace OAKForUnity
         // Init textures. Each PredefinedBase implementation handles textures. Decoupled from external viz (Canvas, VFX, ...)
         void InitTexture()
         {
-            colorTexture = new Texture2D(300, 300, TextureFormat.ARGB32, false);
+            bool display = displayWidth > 0 && displayHeight > 0;
+            colorTexture = new Texture2D(display ? displayWidth : 300, display ? displayHeight : 300, TextureFormat.ARGB32, false);
             _colorPixel32 = colorTexture.GetPixels32();
             //Pin pixel32 array
             _colorPixelHandle = GCHandle.Alloc(_colorPixel32, GCHandleType.Pinned);
@@ -136,6 +150,8 @@ namespace OAKForUnity
             if (useIMU) config.freq = 400;
             if (retrieveSystemInformation) config.rate = 30.0f;
             config.medianFilter = (int) medianFilter;
+            config.displayWidth = displayWidth;
+            config.displayHeight = displayHeight;
             
             // Face NN model
             config.nnPath1 = _dataPath +
@@ -159,9 +175,11 @@ namespace OAKForUnity
             if (!device.replayResults)
             {
                 // Plugin lib pipeline results implementation
-                faceDetectorResults = Marshal.PtrToStringAnsi(FaceDetectorResults(out frameInfo, GETPreview, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, UseDepth, retrieveSystemInformation,
+                IntPtr resultsPtr = FaceDetectorResults(out frameInfo, GETPreview, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, UseDepth, retrieveSystemInformation,
                     useIMU,
-                    (int) device.deviceNum));
+                    (int) device.deviceNum);
+                faceDetectorResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
             }
             // if replay read results from file
             else
@@ -234,7 +252,7 @@ namespace OAKForUnity
                         cubeCharacter.transform.localPosition = new Vector3((float)depthx/100.0f,(float)depthy/100.0f,(float)depthz/100.0f);
                     }
                 }
-                else cubeCharacter.transform.localPosition = new Vector3((float)(150-centerx)/100.0f,(float)-(centery-150)/100.0f,cubeCharacter.transform.localPosition.z);
+                else cubeCharacter.transform.localPosition = new Vector3((float)(colorTexture.width/2-centerx)/100.0f,(float)-(centery-colorTexture.height/2)/100.0f,cubeCharacter.transform.localPosition.z);
             }
             
             if (!retrieveSystemInformation || obj == null) return;
@@ -158,9 +158,11 @@ namespace OAKForUnity
             if (!device.replayResults)
             {
                 // Plugin lib pipeline results implementation
-                faceEmotionResults = Marshal.PtrToStringAnsi(FaceEmotionResults(out frameInfo, GETPreview, 300,300,drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, UseDepth, retrieveSystemInformation,
+                IntPtr resultsPtr = FaceEmotionResults(out frameInfo, GETPreview, 300,300,drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, UseDepth, retrieveSystemInformation,
                     useIMU,
-                    (int) device.deviceNum));
+                    (int) device.deviceNum);
+                faceEmotionResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
             }
             // if replay read results from file
             else
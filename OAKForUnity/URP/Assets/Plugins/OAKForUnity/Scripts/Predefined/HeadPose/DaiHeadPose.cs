@@ -167,9 +167,11 @@ namespace OAKForUnity
             if (!device.replayResults)
             {
                 // Plugin lib pipeline results implementation
-                headPoseResults = Marshal.PtrToStringAnsi(HeadPoseResults(out frameInfo, GETPreview, 300,300,drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, UseDepth, retrieveSystemInformation,
+                IntPtr resultsPtr = HeadPoseResults(out frameInfo, GETPreview, 300,300,drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, UseDepth, retrieveSystemInformation,
                     useIMU,
-                    (int) device.deviceNum));
+                    (int) device.deviceNum);
+                headPoseResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
             }
             // if replay read results from file
             else
@@ -145,7 +145,9 @@ namespace OAKForUnity
             if (!device.replayResults)
             {
                 // Plugin lib pipeline results implementation
-                objectDetectorResults = Marshal.PtrToStringAnsi(ObjectDetectorResults(out frameInfo, GETPreview, detectionScoreThreshold, UseDepth, retrieveSystemInformation, useIMU, (int) device.deviceNum));
+                IntPtr resultsPtr = ObjectDetectorResults(out frameInfo, GETPreview, detectionScoreThreshold, UseDepth, retrieveSystemInformation, useIMU, (int) device.deviceNum);
+                objectDetectorResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
             }
             // if replay read results from file
             else
@@ -21,6 +21,114 @@ namespace OAKForUnity
          */
         private static extern void DAICloseDevice(int deviceNum);
 
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Release json string returned by any *Results function, once copied.
+         * Plugin keeps two buffers per device and writes new results into the released one.
+         * @param result string pointer returned by plugin
+         */
+        protected static extern void DAIReleaseResult(IntPtr result);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Publish results and color frames of device into shared memory ring (unity_bridge/shared_ring.py)
+         * @param deviceNum Device selection on unity dropdown
+         * @param name segment name, null stops publishing
+         * @param slotCount number of records in flight
+         * @param slotSize slot capacity in bytes
+         */
+        [return: MarshalAs(UnmanagedType.I1)]
+        protected static extern bool DAIPublishResults(int deviceNum, string name, int slotCount, int slotSize);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * IMU samples (accelerometer, gyroscope, rotation vector) collected since previous call. Requires freq in pipeline creation.
+         * @param deviceNum Device selection on unity dropdown
+         * @param samples array of maxSamples IMUSample
+         * @param maxSamples size of samples. Oldest samples are skipped if there are more
+         * @returns number of samples written
+         */
+        protected static extern int DAIGetIMUSamples(int deviceNum, [Out] IMUSample[] samples, int maxSamples);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * IMU sensor value interpolated at timestamp (orientation at frame time)
+         * @param deviceNum Device selection on unity dropdown
+         * @param sensor IMUSensor
+         * @param timestamp host steady clock in microseconds. 0: latest
+         * @param sample interpolated sample
+         * @returns false if no report of sensor is available
+         */
+        [return: MarshalAs(UnmanagedType.I1)]
+        protected static extern bool DAIGetIMUAt(int deviceNum, IMUSensor sensor, long timestamp, out IMUSample sample);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Latest system information of device, collected in background. Requires rate in pipeline creation.
+         * @param deviceNum Device selection on unity dropdown
+         * @param sample latest snapshot. version increases with every new message
+         * @returns false if nothing was received yet
+         */
+        [return: MarshalAs(UnmanagedType.I1)]
+        protected static extern bool DAIGetSysInfo(int deviceNum, out SysInfoSample sample);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * System information history of device (last 120 messages), oldest first
+         * @param deviceNum Device selection on unity dropdown
+         * @param samples array of maxSamples SysInfoSample
+         * @param maxSamples size of samples. Newest samples are kept if there are more
+         * @returns number of samples written
+         */
+        protected static extern int DAIGetSysInfoHistory(int deviceNum, [Out] SysInfoSample[] samples, int maxSamples);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Boot of every started device: state (BOOTING, RUNNING, FAILED) and enumeration, boot and start times in ms
+         * @returns json array, owned by plugin (Marshal.PtrToStringAnsi), valid until next call
+         */
+        protected static extern IntPtr DAIGetBootInfo();
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Change stereo config of running pipeline, applied from next depth frame. Requires confidenceThreshold in pipeline creation.
+         * @param confidenceThreshold disparity confidence threshold 0-255
+         * @param medianFilter 0: off, 1: 3x3, 2: 5x5, 3: 7x7
+         * @param leftRightCheck enable left-right check
+         * @param deviceNum Device selection on unity dropdown
+         * @returns true if config was sent to device
+         */
+        [return: MarshalAs(UnmanagedType.I1)]
+        protected static extern bool DAISetStereoConfig(int confidenceThreshold, int medianFilter, [MarshalAs(UnmanagedType.I1)] bool leftRightCheck, int deviceNum);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Change color camera focus of running pipeline
+         * @param manualFocus lens position 1-255. 0: continuous auto focus
+         * @param deviceNum Device selection on unity dropdown
+         * @returns true if control was sent to device
+         */
+        [return: MarshalAs(UnmanagedType.I1)]
+        protected static extern bool DAISetCameraFocus(int manualFocus, int deviceNum);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Change color camera exposure of running pipeline
+         * @param exposureTimeUs exposure time in microseconds. 0: auto exposure
+         * @param sensitivityIso sensitivity as ISO value (100-1600)
+         * @param deviceNum Device selection on unity dropdown
+         * @returns true if control was sent to device
+         */
+        [return: MarshalAs(UnmanagedType.I1)]
+        protected static extern bool DAISetCameraExposure(int exposureTimeUs, int sensitivityIso, int deviceNum);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+         * Change spatial depth thresholds (mm), used from next results call. Negative: pipeline default
+         * @param deviceNum Device selection on unity dropdown
+         */
+        protected static extern void DAISetSpatialThresholds(float lowerThreshold, float upperThreshold, int deviceNum);
+
         /*
         * FrameInfo contains pointers to all the images available on OAK devices. Mirroring FrameInfo on plugin lib.
         *
@@ -117,8 +225,237 @@ namespace OAKForUnity
             
             // Use SpatialLocator node
             public bool useSpatialLocator;
+            
+            // Host queues of acquired streams. queueMaxSize 0: default (1)
+            public int queueMaxSize;
+            [MarshalAs(UnmanagedType.I1)] public bool queueBlocking;
+
+            // Depth/disparity visualization. 0: default (equalized for depth, JET for disparity), 1: grayscale, 2: JET, 3: TURBO, 4: equalized
+            public int depthColorMap;
+            public int disparityColorMap;
+            // Depth mapped to last color of grayscale/JET/TURBO in meters. 0: max depth of each frame
+            public float depthColorRange;
+
+            // Streams pipeline outputs (1: preview, 2: depth, 4: disparity, 8: monoR, 16: monoL). 0: all streams
+            public int streamMask;
+            // Route outputs through a Script node, so they can be paused/resumed at runtime (SetStreamsEnabled)
+            [MarshalAs(UnmanagedType.I1)] public bool streamGating;
+
+            // Display preview resized on device from full camera field of view. 0: preview is NN input (passthrough)
+            public int displayWidth, displayHeight;
+
+            // Encoded transport of preview and mono streams, decoded on plugin lib. 0: raw, 1: MJPEG
+            public int videoEncoding;
+            // Encoder quality 1-100. 0: default (80)
+            public int encoderQuality;
+
+            // Boot device on background thread, Init returns once device is claimed. Device is not running until boot is done
+            [MarshalAs(UnmanagedType.I1)] public bool asyncBoot;
         };
 
+        /*
+        * Binary results returned by *ResultsBinary functions. Mirroring Results.hpp on plugin lib.
+        * Increase RESULTS_VERSION on any layout change.
+        */
+        public const int RESULTS_VERSION = 2;
+        // detections past MAX_DETECTIONS are not reported, only counted (ResultsDroppedDetections)
+        public const int MAX_DETECTIONS = 32;
+        public const int MAX_LANDMARKS = 17;
+
+        // 0: OK, 1: NO_DEVICE, 2: DEVICE_NOT_RUNNING
+        public enum ResultsError
+        {
+            OK,
+            NO_DEVICE,
+            DEVICE_NOT_RUNNING,
+        }
+
+        // Box normalized [0,1], center in preview pixels, spatial coordinates in mm
+        [StructLayout(LayoutKind.Sequential)]
+        public struct DetectionResult
+        {
+            public int label;
+            public float score;
+            public float xmin, ymin, xmax, ymax;
+            public int xcenter, ycenter;
+            public int hasSpatial;
+            public int X, Y, Z;
+        }
+
+        // Angles in degrees
+        [StructLayout(LayoutKind.Sequential)]
+        public struct HeadPoseResult
+        {
+            public int valid;
+            public float yaw, pitch, roll;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct EmotionResult
+        {
+            public int valid;
+            public float neutral, happy, sad, surprise, anger;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct LandmarkResult
+        {
+            public int index;
+            public int xpos, ypos;
+            public int hasSpatial;
+            public int X, Y, Z;
+        }
+
+        // Memory in MiB, cpu usage in %
+        [StructLayout(LayoutKind.Sequential)]
+        public struct SysInfoResult
+        {
+            public int valid;
+            public float ddrUsed, ddrTotal;
+            public float leonCssHeapUsed, leonCssHeapTotal;
+            public float leonMssHeapUsed, leonMssHeapTotal;
+            public float cmxUsed, cmxTotal;
+            public float chipTempAvg;
+            public float cpuUsage;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct IMUResult
+        {
+            public int valid;
+            public float i, j, k, real;
+            public float accuracy;
+        }
+
+        /*
+        * One system information message. Mirroring SysInfoSample on plugin lib
+        */
+        [StructLayout(LayoutKind.Sequential)]
+        public struct SysInfoSample
+        {
+            // increases with every message since pipeline start
+            public long version;
+            // host steady clock in microseconds, when message was received
+            public long timestamp;
+            public SysInfoResult info;
+            public float mssCpuUsage;
+            public float tempCss, tempMss, tempUpa, tempDss;
+        }
+
+        // Sensor of IMUSample. Mirroring IMUSensorType on plugin lib
+        public enum IMUSensor
+        {
+            Accelerometer = 0,
+            Gyroscope = 1,
+            RotationVector = 2
+        }
+
+        /*
+        * One IMU report. Mirroring IMUSample on plugin lib.
+        * Accelerometer x,y,z (m/s^2), gyroscope x,y,z (rad/s), rotation vector quaternion x,y,z,w
+        */
+        [StructLayout(LayoutKind.Sequential)]
+        public struct IMUSample
+        {
+            // host steady clock in microseconds
+            public long timestamp;
+            public IMUSensor sensor;
+            public float accuracy;
+            public float x, y, z, w;
+        }
+
+        /*
+        * Layout of FrameResults. Used for offsets, read single fields with the helpers below
+        * so no managed arrays are allocated per frame.
+        */
+        [StructLayout(LayoutKind.Sequential)]
+        public struct FrameResults
+        {
+            public int version;
+            public int size;
+            public int error;
+            public int sequence;
+            public int previewWidth, previewHeight;
+
+            public int numDetections;
+            public int best;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = MAX_DETECTIONS)] public DetectionResult[] detections;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = MAX_DETECTIONS)] public HeadPoseResult[] headPoses;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = MAX_DETECTIONS)] public EmotionResult[] emotions;
+
+            public int numLandmarks;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = MAX_LANDMARKS)] public LandmarkResult[] landmarks;
+
+            public int numPoints;
+            public int depthError;
+
+            public SysInfoResult sysinfo;
+            public IMUResult imu;
+
+            public int droppedDetections;
+        }
+
+        private static readonly int _detectionsOffset = Marshal.OffsetOf(typeof(FrameResults), "detections").ToInt32();
+        private static readonly int _headPosesOffset = Marshal.OffsetOf(typeof(FrameResults), "headPoses").ToInt32();
+        private static readonly int _emotionsOffset = Marshal.OffsetOf(typeof(FrameResults), "emotions").ToInt32();
+        private static readonly int _landmarksOffset = Marshal.OffsetOf(typeof(FrameResults), "landmarks").ToInt32();
+        private static readonly int _numLandmarksOffset = Marshal.OffsetOf(typeof(FrameResults), "numLandmarks").ToInt32();
+        private static readonly int _numPointsOffset = Marshal.OffsetOf(typeof(FrameResults), "numPoints").ToInt32();
+        private static readonly int _sysinfoOffset = Marshal.OffsetOf(typeof(FrameResults), "sysinfo").ToInt32();
+        private static readonly int _imuOffset = Marshal.OffsetOf(typeof(FrameResults), "imu").ToInt32();
+        private static readonly int _droppedDetectionsOffset = Marshal.OffsetOf(typeof(FrameResults), "droppedDetections").ToInt32();
+
+        /*
+         * Check results returned by *ResultsBinary
+         * @returns True if layout matches and results have no error, false otherwise.
+         */
+        protected static bool ResultsValid(IntPtr results)
+        {
+            if (results == IntPtr.Zero) return false;
+            if (Marshal.ReadInt32(results, 0) != RESULTS_VERSION || Marshal.ReadInt32(results, 4) != Marshal.SizeOf(typeof(FrameResults)))
+            {
+                Debug.LogError("Plugin results layout doesn't match. Update depthai-unity plugin.");
+                return false;
+            }
+            return Marshal.ReadInt32(results, 8) == (int) ResultsError.OK;
+        }
+
+        protected static int ResultsNumDetections(IntPtr results) { return Marshal.ReadInt32(results, 24); }
+        protected static int ResultsBest(IntPtr results) { return Marshal.ReadInt32(results, 28); }
+        protected static int ResultsNumLandmarks(IntPtr results) { return Marshal.ReadInt32(results, _numLandmarksOffset); }
+        protected static int ResultsNumPoints(IntPtr results) { return Marshal.ReadInt32(results, _numPointsOffset); }
+        protected static int ResultsDroppedDetections(IntPtr results) { return Marshal.ReadInt32(results, _droppedDetectionsOffset); }
+
+        protected static DetectionResult ResultsDetection(IntPtr results, int i)
+        {
+            return Marshal.PtrToStructure<DetectionResult>(results + _detectionsOffset + i * Marshal.SizeOf(typeof(DetectionResult)));
+        }
+
+        protected static HeadPoseResult ResultsHeadPose(IntPtr results, int i)
+        {
+            return Marshal.PtrToStructure<HeadPoseResult>(results + _headPosesOffset + i * Marshal.SizeOf(typeof(HeadPoseResult)));
+        }
+
+        protected static EmotionResult ResultsEmotion(IntPtr results, int i)
+        {
+            return Marshal.PtrToStructure<EmotionResult>(results + _emotionsOffset + i * Marshal.SizeOf(typeof(EmotionResult)));
+        }
+
+        protected static LandmarkResult ResultsLandmark(IntPtr results, int i)
+        {
+            return Marshal.PtrToStructure<LandmarkResult>(results + _landmarksOffset + i * Marshal.SizeOf(typeof(LandmarkResult)));
+        }
+
+        protected static SysInfoResult ResultsSysInfo(IntPtr results)
+        {
+            return Marshal.PtrToStructure<SysInfoResult>(results + _sysinfoOffset);
+        }
+
+        protected static IMUResult ResultsIMU(IntPtr results)
+        {
+            return Marshal.PtrToStructure<IMUResult>(results + _imuOffset);
+        }
+
         // public enums
         
         // Indicates to work on standard Start/Update unity lifecycle or start pipeline in separate Thread
@@ -22,6 +22,28 @@ namespace OAKForUnity
         private static extern IntPtr PointCloudVFXResults(out FrameInfo frameInfo, bool getPreview, bool useDepth,
             bool retrieveInformation, bool useIMU, int deviceNum);
 
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        private static extern void PointCloudVFXSetPointCloud(in PointCloudConfig config, IntPtr points, int maxPoints, int deviceNum);
+
+        /*
+        * PointCloudConfig contains point cloud generation options. Mirroring PointCloudConfig on plugin lib.
+        */
+        [StructLayout(LayoutKind.Sequential)]
+        public struct PointCloudConfig
+        {
+            public int stride;
+            public float minDepth, maxDepth;
+            public int format;
+            [MarshalAs(UnmanagedType.U1)] public bool useIntensity;
+            public float voxelSize;
+        }
+
+        public enum PointFormat
+        {
+            Float,
+            Half
+        }
+
 
         // public attributes
         
@@ -45,6 +67,23 @@ namespace OAKForUnity
         public bool useAlignment = false;
         public bool useSubpixel = true;
 
+        [Tooltip("Depth read directly from device frame buffer (no copy). Only with UnityThread process mode")]
+        public bool zeroCopyDepth = false;
+
+        [Header("Host Point Cloud")]
+        [Tooltip("Generate packed xyz(+intensity) points on plugin side")]
+        public bool generatePointCloud = false;
+        [Tooltip("Subsampling step in pixels")]
+        public int pointCloudStride = 1;
+        [Tooltip("Depth range in meters. Max 0: no limit")]
+        public float minDepth = 0.2f;
+        public float maxDepth = 0.0f;
+        public PointFormat pointFormat = PointFormat.Float;
+        public bool pointIntensity = false;
+        [Tooltip("Voxel grid downsampling, voxel edge in meters. 0: no downsampling")]
+        public float voxelSize = 0.0f;
+        public int maxPoints = 1280 * 800;
+
         [Header("Point Cloud VFX Results")] 
         public Texture2D colorTexture;
         public Texture2D monoRTexture;
@@ -69,6 +108,13 @@ namespace OAKForUnity
         public ushort[] depthU;
         public GCHandle depthGC;
         public IntPtr depthPtr;
+        private int _depthW;
+        private int _depthH;
+
+        // packed points (float or half, 3 or 4 components). numPoints updated on each results call
+        public float[] points;
+        public int numPoints;
+        private GCHandle _pointsHandle;
         
         /*
          * Init textures. In this case we allocate them but copy data in unity side with loadrawdata
@@ -126,16 +172,24 @@ namespace OAKForUnity
             frameInfo.colorPreviewData = _colorPixelPtr;
             frameInfo.rectifiedRData = _monoRPixelPtr;
 
-            if (useAlignment)
-            {
-                if (rgbResolution == RGBResolution.THE_800_P)
-                    depthU = new ushort[640 * 400];
-                else depthU = new ushort[640 * 360];
-            }
-            else depthU = new ushort[640 * 400];
+            _depthW = depthTexture.width;
+            _depthH = depthTexture.height;
+
+            // zero-copy: plugin returns pointer to depth frame and its size on each results call
+            if (UseZeroCopyDepth()) return;
+
+            depthU = new ushort[_depthW * _depthH];
             depthGC = GCHandle.Alloc(depthU, GCHandleType.Pinned);
             depthPtr = depthGC.AddrOfPinnedObject();
             frameInfo.depthData = depthPtr;
+            frameInfo.depthWidth = _depthW;
+            frameInfo.depthHeight = _depthH;
+        }
+
+        // Zero-copy pointer is only valid until next results call, so results and processing must run on same thread
+        bool UseZeroCopyDepth()
+        {
+            return zeroCopyDepth && processMode == ProcessMode.UnityThread;
         }
 
         // Prepare Pipeline Configuration and call pipeline init implementation
@@ -182,6 +236,22 @@ namespace OAKForUnity
 
             // Plugin lib init pipeline implementation
             deviceRunning = InitPointCloudVFX(config);
+
+            // register points buffer for host side point cloud generation
+            if (deviceRunning && generatePointCloud)
+            {
+                var pcConfig = new PointCloudConfig
+                {
+                    stride = pointCloudStride, minDepth = minDepth, maxDepth = maxDepth,
+                    format = (int) pointFormat, useIntensity = pointIntensity, voxelSize = voxelSize
+                };
+                if (points == null)
+                {
+                    points = new float[maxPoints * 4];
+                    _pointsHandle = GCHandle.Alloc(points, GCHandleType.Pinned);
+                }
+                PointCloudVFXSetPointCloud(pcConfig, _pointsHandle.AddrOfPinnedObject(), maxPoints, (int) device.deviceNum);
+            }
             
             // Check if was possible to init device with pipeline. Base class handles replay data if possible.
             if (!deviceRunning)
@@ -197,10 +267,14 @@ namespace OAKForUnity
             // if not doing replay
             if (!device.replayResults)
             {
+                if (UseZeroCopyDepth()) frameInfo.depthData = IntPtr.Zero;
+
                 // Plugin lib pipeline results implementation
-                pointCloudVFXResults = Marshal.PtrToStringAnsi(PointCloudVFXResults(out frameInfo, GETPreview, UseDepth,
+                IntPtr resultsPtr = PointCloudVFXResults(out frameInfo, GETPreview, UseDepth,
                     retrieveSystemInformation, useIMU,
-                    (int) device.deviceNum));
+                    (int) device.deviceNum);
+                pointCloudVFXResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
             }
             else
             {
@@ -220,9 +294,16 @@ namespace OAKForUnity
                 monoRTexture.SetPixels32(_monoRPixel32);
                 monoRTexture.Apply();
 
-                if (!useAlignment) depthTexture.LoadRawTextureData(depthPtr, 640 * 400 *2);
-                else if (rgbResolution == RGBResolution.THE_800_P) depthTexture.LoadRawTextureData(depthPtr, 640 * 400 *2);
-                else depthTexture.LoadRawTextureData(depthPtr, 640 * 360 *2);
+                if (UseZeroCopyDepth())
+                {
+                    if (frameInfo.depthData != IntPtr.Zero)
+                    {
+                        if (depthTexture.width != frameInfo.depthWidth || depthTexture.height != frameInfo.depthHeight)
+                            depthTexture.Reinitialize(frameInfo.depthWidth, frameInfo.depthHeight);
+                        depthTexture.LoadRawTextureData(frameInfo.depthData, frameInfo.depthWidth * frameInfo.depthHeight * 2);
+                    }
+                }
+                else depthTexture.LoadRawTextureData(depthPtr, _depthW * _depthH * 2);
                 depthTexture.Apply();
 
                 // If recording data
@@ -257,6 +338,7 @@ namespace OAKForUnity
 
             // EXAMPLE HOW TO PARSE INFO
             var obj = JSON.Parse(pointCloudVFXResults);
+            if (obj != null && obj["points"] != null) numPoints = obj["points"];
             if (!retrieveSystemInformation || obj == null) return;
             
             float ddrUsed = obj["sysinfo"]["ddr_used"];
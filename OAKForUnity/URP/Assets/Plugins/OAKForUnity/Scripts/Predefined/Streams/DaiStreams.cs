@@ -38,6 +38,37 @@ namespace OAKForUnity
         private static extern IntPtr StreamsResults(out FrameInfo frameInfo, bool getPreview, bool useDepth,
             bool retrieveInformation, bool useIMU, int deviceNum);
 
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+        * Pause/resume outputs without restarting device. Requires streamGating in pipeline creation.
+        *
+        * @param streamMask enabled outputs
+        * @param deviceNum Device selection on unity dropdown
+        * @returns true if mask was sent to device
+        */
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool SetStreamsEnabled(int streamMask, int deviceNum);
+
+        [DllImport("depthai-unity", CallingConvention = CallingConvention.Cdecl)]
+        /*
+        * Stats of acquired streams: fps, link bandwidth (kbps) and host conversion/decode time (convert_us)
+        *
+        * @param deviceNum Device selection on unity dropdown
+        * @returns Json with stats per stream. Owned by plugin lib, valid until next call
+        */
+        private static extern IntPtr DAIStreamStats(int deviceNum);
+
+        // Output streams. Mirroring StreamMask on plugin lib
+        [Flags]
+        public enum StreamMask
+        {
+            Preview = 1,
+            Depth = 2,
+            Disparity = 4,
+            MonoR = 8,
+            MonoL = 16
+        }
+
         
         // Editor attributes
         [Header("RGB Camera")] 
@@ -53,6 +84,16 @@ namespace OAKForUnity
         public MedianFilter medianFilter;
         public bool useIMU = false;
         public bool retrieveSystemInformation = false;
+        // Streams produced by device. Without gating, disabled streams are not created
+        public StreamMask enabledStreams = StreamMask.Preview | StreamMask.Depth | StreamMask.Disparity | StreamMask.MonoR | StreamMask.MonoL;
+        // Allows to change enabledStreams while running (uses device CPU)
+        public bool streamGating = false;
+        // Preview and mono streams encoded on device (MJPEG) and decoded on plugin lib. Reduces link bandwidth
+        public bool encodedTransport = false;
+        [Range(1, 100)] public int encoderQuality = 80;
+        public bool retrieveStreamStats = false;
+        // Device boots in background (several devices boot in parallel). Results are empty until device runs pipeline
+        public bool asyncBoot = false;
         private const bool GETPreview = true;
         private const bool UseDepth = true;
 
@@ -64,8 +105,11 @@ namespace OAKForUnity
         public Texture2D depthTexture;
         public string streamsResults;
         public string systemInfo;
+        public string streamStats;
 
         // private attributes
+        private StreamMask _sentStreams;
+
         private Color32[] _colorPixel32;
         private GCHandle _colorPixelHandle;
         private IntPtr _colorPixelPtr;
@@ -166,6 +210,12 @@ namespace OAKForUnity
             if (useIMU) config.freq = 400;
             if (retrieveSystemInformation) config.rate = 30.0f;
             config.medianFilter = (int) medianFilter;
+            config.streamMask = (int) enabledStreams;
+            config.streamGating = streamGating;
+            _sentStreams = enabledStreams;
+            config.videoEncoding = encodedTransport ? 1 : 0;
+            config.encoderQuality = encoderQuality;
+            config.asyncBoot = asyncBoot;
 
             // Plugin lib init pipeline implementation
             deviceRunning = InitStreams(config);
@@ -184,10 +234,18 @@ namespace OAKForUnity
             // if not doing replay
             if (!device.replayResults)
             {
+                // Runtime pause/resume of streams
+                if (streamGating && enabledStreams != _sentStreams &&
+                    SetStreamsEnabled((int) enabledStreams, (int) device.deviceNum)) _sentStreams = enabledStreams;
+
                 // Plugin lib pipeline results implementation
-                streamsResults = Marshal.PtrToStringAnsi(StreamsResults(out frameInfo, GETPreview, UseDepth, retrieveSystemInformation,
+                IntPtr resultsPtr = StreamsResults(out frameInfo, GETPreview, UseDepth, retrieveSystemInformation,
                     useIMU,
-                    (int) device.deviceNum));
+                    (int) device.deviceNum);
+                streamsResults = Marshal.PtrToStringAnsi(resultsPtr);
+                DAIReleaseResult(resultsPtr);
+
+                if (retrieveStreamStats) streamStats = Marshal.PtrToStringAnsi(DAIStreamStats((int) device.deviceNum));
             }
             // if replay read results from file
             else
@@ -18,6 +18,8 @@ public class TcpClientBehaviour : MonoBehaviour
 {
     public string host;
     public int port;
+    // Binary framing of native bridge server (depthai-unity-bridge). False: json/jpeg delimiters of python unity_bridge
+    public bool binaryFraming;
     
     private TcpClient client;
     private Thread clientThread;
@@ -36,6 +38,21 @@ public class TcpClientBehaviour : MonoBehaviour
     private int _getJson = 1;
     private const string DELIMITER = "<<END_OF_JSON>>";
     private const string DELIMITER_END = "<<END>>";
+
+    // BridgeMessageHeader (BridgeServer.hpp)
+    private const uint BRIDGE_MAGIC = 0x42494144;
+    private const int BRIDGE_HEADER_SIZE = 32;
+    private const int BRIDGE_FRAME_RAW = 1;
+    private const int BRIDGE_FRAME_JPEG = 2;
+    private const int BRIDGE_RESULTS_BINARY = 3;
+    private const int BRIDGE_RESULTS_JSON = 4;
+
+    // binary framing: messages completed on network thread, consumed on Update
+    private readonly object _bridgeLock = new object();
+    private MemoryStream bridgeStream = new MemoryStream();
+    private bool _pendingRaw;
+    private int _pendingWidth, _pendingHeight;
+    private byte[] _resultsBinary;
     void Start()
     {
         _connected = false;
@@ -68,6 +85,11 @@ public class TcpClientBehaviour : MonoBehaviour
             // Remember to marshal this call back to the main thread if you're updating Unity objects
             //Debug.Log("GET JSON: "+_getJson);
             //Debug.Log("DATA: "+data.Length+" 0:"+data[0]);
+            if (binaryFraming)
+            {
+                ParseBridgeMessages(data);
+                return;
+            }
             
             byte[] delimiterBytes = Encoding.ASCII.GetBytes(DELIMITER); 
             byte[] delimiterEndBytes = Encoding.ASCII.GetBytes(DELIMITER_END);
@@ -136,6 +158,106 @@ public class TcpClientBehaviour : MonoBehaviour
 
     }
 
+    // Split received bytes into bridge messages. Incomplete message is kept for next data
+    void ParseBridgeMessages(byte[] data)
+    {
+        bridgeStream.Write(data, 0, data.Length);
+        byte[] buffer = bridgeStream.GetBuffer();
+        int length = (int)bridgeStream.Length;
+        int offset = 0;
+
+        while (length - offset >= BRIDGE_HEADER_SIZE)
+        {
+            if (BitConverter.ToUInt32(buffer, offset) != BRIDGE_MAGIC)
+            {
+                Debug.LogError("Bridge framing error");
+                offset = length;
+                break;
+            }
+
+            int type = BitConverter.ToUInt16(buffer, offset + 6);
+            int size = (int)BitConverter.ToUInt32(buffer, offset + 8);
+            if (length - offset - BRIDGE_HEADER_SIZE < size) break;
+
+            byte[] payload = new byte[size];
+            Array.Copy(buffer, offset + BRIDGE_HEADER_SIZE, payload, 0, size);
+
+            lock (_bridgeLock)
+            {
+                if (type == BRIDGE_FRAME_RAW || type == BRIDGE_FRAME_JPEG)
+                {
+                    // older frame not displayed yet is dropped
+                    _pendingImageData = payload;
+                    _pendingRaw = type == BRIDGE_FRAME_RAW;
+                    _pendingWidth = BitConverter.ToInt32(buffer, offset + 24);
+                    _pendingHeight = BitConverter.ToInt32(buffer, offset + 28);
+                }
+                else if (type == BRIDGE_RESULTS_JSON) _pendingJsonData = payload;
+                else if (type == BRIDGE_RESULTS_BINARY) _resultsBinary = payload;
+            }
+
+            offset += BRIDGE_HEADER_SIZE + size;
+        }
+
+        int remaining = length - offset;
+        if (remaining > 0) Buffer.BlockCopy(buffer, offset, buffer, 0, remaining);
+        bridgeStream.SetLength(remaining);
+        bridgeStream.Position = remaining;
+    }
+
+    private void UpdateBinary()
+    {
+        byte[] image, json;
+        bool raw;
+        int width, height;
+        lock (_bridgeLock)
+        {
+            image = _pendingImageData;
+            json = _pendingJsonData;
+            raw = _pendingRaw;
+            width = _pendingWidth;
+            height = _pendingHeight;
+            _pendingImageData = null;
+            _pendingJsonData = null;
+        }
+
+        if (json != null) _json = Encoding.UTF8.GetString(json);
+        if (image == null) return;
+
+        if (!raw)
+        {
+            if (!_texture.LoadImage(image)) Debug.LogError("Failed to create texture from received image data");
+            return;
+        }
+
+        // BGR top-down to RGB24 bottom-up
+        if (_texture.width != width || _texture.height != height || _texture.format != TextureFormat.RGB24)
+        {
+            _texture = new Texture2D(width, height, TextureFormat.RGB24, false);
+        }
+        byte[] rgb = new byte[width * height * 3];
+        int rowSize = width * 3;
+        for (int y = 0; y < height; y++)
+        {
+            int src = y * rowSize;
+            int dst = (height - 1 - y) * rowSize;
+            for (int x = 0; x < rowSize; x += 3)
+            {
+                rgb[dst + x] = image[src + x + 2];
+                rgb[dst + x + 1] = image[src + x + 1];
+                rgb[dst + x + 2] = image[src + x];
+            }
+        }
+        _texture.LoadRawTextureData(rgb);
+        _texture.Apply();
+    }
+
+    // Latest FrameResults received with binary framing (--binary-results), null otherwise
+    public byte[] GetResultsBinary()
+    {
+        lock (_bridgeLock) return _resultsBinary;
+    }
+
     // Helper method to find the delimiter in the data
     int FindDelimiterIndex(byte[] data, byte[] delimiter)
     {
@@ -163,6 +285,12 @@ public class TcpClientBehaviour : MonoBehaviour
     }
     private void Update()
     {
+        if (binaryFraming)
+        {
+            UpdateBinary();
+            return;
+        }
+
         if (_pendingImageData != null && _getJson == 0)
         {
             if (!_texture.LoadImage(_pendingImageData))
@@ -6,6 +6,106 @@
 extern dai::SpatialLocationCalculatorConfigData sconfig;
 extern dai::SpatialLocationCalculatorAlgorithm calculationAlgorithm;
 
+/**
+* Host side spatial location engine
+*
+* Intrinsics come from device calibration for the actual depth stream resolution (mono right, or RGB if depth is aligned).
+* Per-column and per-row tangent tables are cached per resolution.
+* update() builds summed-area tables of valid depth (sum and count) once per frame, so mean depth of any ROI is O(1).
+* MIN, MAX, MODE, MEDIAN and percentiles scan ROI row-major into reusable scratch buffers (histogram for MODE, nth_element otherwise).
+*/
+class SpatialEngine
+{
+public:
+    /**
+    * Set calibration used to get intrinsics of depth frames
+    *
+    * @param calibration device calibration
+    * @param socket camera depth is aligned to (RIGHT by default, RGB if depth is aligned to color camera)
+    */
+    void setCalibration(const dai::CalibrationHandler& calibration, dai::CameraBoardSocket socket);
+
+    /**
+    * Set depth frame used by next compute calls and build summed-area tables
+    *
+    * @param depthFrame depth frame CV_16UC1 in mm
+    * @param depth_thresh_low depth minimum threshold (exclusive)
+    * @param depth_thresh_high depth maximum threshold (exclusive)
+    */
+    void update(const cv::Mat& depthFrame, float depth_thresh_low, float depth_thresh_high);
+
+    /**
+    * Compute spatial info of rois on current depth frame
+    *
+    * @param rois vector of regions of interest to compute depth
+    * @param mode compute average or min depth of roi. 0: average, 1: min
+    * @return vector of spatial locations
+    */
+    std::vector<dai::SpatialLocations> compute(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, int mode);
+
+    /**
+    * Compute spatial info of rois on current depth frame, same algorithms as SpatialLocationCalculator node
+    *
+    * @param rois vector of regions of interest to compute depth
+    * @param algorithm AVERAGE, MIN, MAX, MODE or MEDIAN
+    * @return vector of spatial locations
+    */
+    std::vector<dai::SpatialLocations> compute(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, dai::SpatialLocationCalculatorAlgorithm algorithm);
+
+    /**
+    * Compute spatial info of rois on current depth frame using depth percentile
+    *
+    * @param rois vector of regions of interest to compute depth
+    * @param percentile [0,100]. 50: median
+    * @return vector of spatial locations
+    */
+    std::vector<dai::SpatialLocations> computePercentile(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, float percentile);
+
+    int width() const { return depth.cols; }
+    int height() const { return depth.rows; }
+
+private:
+    void updateTangents(int width, int height);
+    std::vector<dai::SpatialLocations> compute(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, dai::SpatialLocationCalculatorAlgorithm algorithm, float percentile);
+    // valid depth values of roi into scratch
+    void gather(int xmin, int ymin, int xmax, int ymax);
+
+    dai::CalibrationHandler calibration;
+    dai::CameraBoardSocket socket = dai::CameraBoardSocket::RIGHT;
+    bool calibrated = false;
+
+    // tangent tables of current resolution: x = z * tanX[col], y = -z * tanY[row]
+    int tanWidth = 0, tanHeight = 0;
+    std::vector<float> tanX, tanY;
+
+    // current frame and its summed-area tables ((width+1) x (height+1))
+    cv::Mat depth;
+    float low = 0.0f, high = 0.0f;
+    std::vector<double> sums;
+    std::vector<int> counts;
+
+    // reusable scratch: valid depth values of current roi and 16 bit histogram (all zero between rois)
+    std::vector<unsigned short> values;
+    std::vector<unsigned int> histogram;
+};
+
+/**
+* Spatial engine of device
+*
+* @param deviceNum Device selection on unity dropdown. Not checked, deviceNum of a running device
+* @return spatial engine
+*/
+SpatialEngine& GetSpatialEngine(int deviceNum);
+
+/**
+* Init spatial engine of device with device calibration
+*
+* @param deviceNum Device selection on unity dropdown
+* @param device running device
+* @param alignedToRGB true if depth is aligned to color camera
+*/
+void InitSpatialEngine(int deviceNum, std::shared_ptr<dai::Device> device, bool alignedToRGB);
+
 /**
 * Compute spatial info
 *
@@ -28,10 +128,22 @@ std::vector<dai::SpatialLocations> getSpatialInfo1(cv::Mat depthFrame, std::vect
 * @param depthFrameOrig depth frame
 * @return vector of spatial locations
 *
-* @todo Replace and use proper spatial location node. Remove hardcoded values. 
+* @todo Replace and use proper spatial location node.
 */
 std::vector<dai::SpatialLocations> computeDepth(float mx, float my, int frameRows, cv::Mat depthFrameOrig);
 
+/**
+* Compute 3D position of ROI around image point (mx,my) using current depth frame of spatial engine
+*
+* @param engine spatial engine, updated with current depth frame
+* @param mx x-axis position
+* @param my y-axis position
+* @param frameRows normalization between rgb and depth frames
+* @param algorithm depth of roi, MEDIAN by default as SpatialLocationCalculator node configuration
+* @return vector of spatial locations
+*/
+std::vector<dai::SpatialLocations> computeDepth(SpatialEngine& engine, float mx, float my, int frameRows, dai::SpatialLocationCalculatorAlgorithm algorithm = dai::SpatialLocationCalculatorAlgorithm::MEDIAN);
+
 /**
 * Compute 3D position of ROI around image point (mx,my) using depth image
 * Using spatialLocation node
@@ -40,8 +152,23 @@ std::vector<dai::SpatialLocations> computeDepth(float mx, float my, int frameRow
 * @param frame rgb frame
 * @param mx x-axis position
 * @param my y-axis position
-* @param mode 0: crop, 1: letterbox
+* @param mode 0: crop, 1: letterbox, 2: resize (same field of view)
 * @return mapped rect from rgb to depth
 *
 */
-dai::Rect prepareComputeDepth(cv::Mat depthFrame, cv::Mat frame, float mx, float my, int mode);
\ No newline at end of file
+dai::Rect prepareComputeDepth(cv::Mat depthFrame, cv::Mat frame, float mx, float my, int mode);
+
+/**
+* SpatialLocationCalculator reply for ROIs sent on "spatialCalcConfig", doesn't wait
+*
+* Calculator keeps computing last ROIs on every depth frame, so latest acquired "spatialData" message can still belong
+* to ROIs of previous call. It is used if it has same ROIs as cfg (same count and rectangles, in order), as on calls
+* between new detections. Otherwise last matched reply of device is reported (previous ROIs, about one depth frame
+* old) if it has as many ROIs as cfg, else nothing.
+*
+* @param deviceNum Device selection on unity dropdown
+* @param cfg config sent to device
+* @param spatialData out: spatial locations in cfg ROI order, empty if there is no reply to report
+* @return true if spatialData was computed for cfg ROIs
+*/
+bool getSpatialReply(int deviceNum, const dai::SpatialLocationCalculatorConfig& cfg, std::vector<dai::SpatialLocations>& spatialData);
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+* Network bridge server
+*
+* Native replacement of unity_bridge/unity_bridge.py. One I/O thread serves every client with non-blocking sockets and epoll,
+* no thread per client and no polling. Each message is built once and shared by all client queues (fan-out of one acquisition).
+* Slow clients don't slow down others: every client queue keeps at most maxQueued messages and drops the oldest ones
+* (never the message being sent).
+*
+* Binary framing (little endian), mirrored by TcpClientBehaviour.cs. Increase DAI_BRIDGE_VERSION on any change.
+*   BridgeMessageHeader (32 bytes) followed by size bytes of payload
+*/
+#define DAI_BRIDGE_MAGIC 0x42494144 // "DAIB"
+#define DAI_BRIDGE_VERSION 1
+
+enum BridgeMessageType
+{
+    BRIDGE_FRAME_RAW = 1,         // BGR pixels, width * 3 bytes per row
+    BRIDGE_FRAME_JPEG = 2,        // JPEG encoded frame
+    BRIDGE_RESULTS_BINARY = 3,    // FrameResults (Results.hpp)
+    BRIDGE_RESULTS_JSON = 4,      // json results, not null terminated
+};
+
+struct BridgeMessageHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;
+    // payload size in bytes
+    uint32_t size;
+    // frame sequence, same for frame and results of one acquisition
+    uint32_t sequence;
+    // steady clock of server in microseconds, when message was built
+    int64_t timestamp;
+    // frames only, 0 otherwise
+    int32_t width, height;
+};
+
+// header and payload, shared by all client queues
+typedef std::shared_ptr<const std::vector<std::uint8_t>> BridgeMessage;
+
+class BridgeServer
+{
+public:
+    /**
+    * @param maxQueued messages queued per client before oldest ones are dropped
+    */
+    explicit BridgeServer(int maxQueued = 4);
+    ~BridgeServer();
+
+    /**
+    * Listen on address and start I/O thread
+    *
+    * @param host address to bind, "0.0.0.0" for every interface
+    * @param port TCP port
+    * @returns true if listening
+    */
+    bool start(const std::string& host, int port);
+    void stop();
+
+    /**
+    * Build message with header
+    *
+    * @param width frame width, 0 for results
+    * @param height frame height, 0 for results
+    */
+    static BridgeMessage makeMessage(BridgeMessageType type, uint32_t sequence, int width, int height, const void* data, size_t size);
+
+    /**
+    * Queue message to every connected client. Thread safe, doesn't wait on sockets
+    */
+    void broadcast(const BridgeMessage& message);
+
+    int clientCount() const { return numClients; }
+    // messages dropped because of slow clients, all clients
+    uint64_t droppedCount() const { return dropped; }
+
+private:
+    struct Client
+    {
+        int fd;
+        std::deque<BridgeMessage> queue;
+        // bytes of front message already sent
+        size_t offset = 0;
+        bool waitWritable = false;
+    };
+
+    void run();
+    void acceptClients();
+    // false if client was disconnected
+    bool receive(Client& client);
+    void enqueue(Client& client, const BridgeMessage& message);
+    bool flush(Client& client);
+    void watchWritable(Client& client, bool enable);
+    void closeClient(int fd);
+
+    int maxQueued;
+    int listenFd = -1;
+    int epollFd = -1;
+    // eventfd waking I/O thread on broadcast/stop
+    int wakeFd = -1;
+
+    std::mutex mutex;
+    std::vector<BridgeMessage> pending;
+
+    std::unordered_map<int, Client> clients;
+    std::atomic<int> numClients{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> running{false};
+    std::thread worker;
+};
@@ -0,0 +1,394 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "DeviceNum.hpp"
+
+/**
+* Host side acquisition engine
+*
+* One worker thread per device drains every XLinkOut queue as soon as messages arrive, converts image frames
+* and publishes the latest message of each stream into a lock-free triple buffer.
+* Results calls (StreamsResults, FaceDetectorResults, ...) only swap the front slot and never wait on the device,
+* so Unity render loop at 60/90 Hz is decoupled from camera fps and device latency.
+*
+* Streams of a bundle (BundlePolicy) are matched by sequence number or device timestamp, so results use preview,
+* detections and depth of the same camera frame. Matched bundles are published in their own triple buffer.
+*
+* Streams used as request/response (second stage NN inputs/outputs) are not acquired and stay on the device queues.
+* Every XLinkIn/XLinkOut queue handle is resolved once when pipeline starts (stream registry), results path only looks them up.
+*/
+
+/**
+* Host queue policy of acquired output streams. Mirrors queueMaxSize/queueBlocking on PipelineConfig
+*/
+struct StreamPolicy
+{
+    /**
+    * @param maxSize host queue size. 0 or negative for default (1, only latest message is used)
+    * @param blocking if true device waits when host queue is full, otherwise oldest messages are dropped
+    */
+    StreamPolicy(int maxSize = 0, bool blocking = false) : maxSize(maxSize > 0 ? maxSize : 1), blocking(blocking) {}
+
+    int maxSize;
+    bool blocking;
+};
+
+/**
+* Output streams matched into bundles (frames of same capture). Bundled streams are only available through GetBundle
+*/
+struct BundlePolicy
+{
+    /**
+    * @param streams output streams to match. Streams missing on pipeline are ignored. Empty: no bundles
+    * @param toleranceMs max device timestamp difference of bundled messages. Negative: match by sequence number (same camera)
+    * @param bufferSize messages buffered per stream waiting for a match. Oldest ones are dropped
+    */
+    BundlePolicy(const std::vector<std::string>& streams = {}, float toleranceMs = 10.0f, int bufferSize = 8)
+        : streams(streams), toleranceMs(toleranceMs), bufferSize(bufferSize > 0 ? bufferSize : 1) {}
+
+    std::vector<std::string> streams;
+    float toleranceMs;
+    int bufferSize;
+};
+
+/**
+* Lock-free single producer / single consumer triple buffer.
+* Producer writes back() and publish(), consumer calls update() and reads front().
+* Each side owns its slot exclusively until next publish/update.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    // producer slot
+    T& back() { return slots[backIndex]; }
+
+    // producer: make back slot the latest one and take the free slot
+    void publish()
+    {
+        int prev = middle.exchange(backIndex | DIRTY, std::memory_order_acq_rel);
+        backIndex = prev & INDEX_MASK;
+    }
+
+    // consumer: swap front with latest published slot. False if nothing new was published
+    bool update()
+    {
+        if ((middle.load(std::memory_order_acquire) & DIRTY) == 0) return false;
+        int prev = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = prev & INDEX_MASK;
+        return true;
+    }
+
+    // consumer slot
+    T& front() { return slots[frontIndex]; }
+
+private:
+    static const int DIRTY = 4;
+    static const int INDEX_MASK = 3;
+
+    T slots[3];
+    std::atomic<int> middle{1};
+    int backIndex = 0;
+    int frontIndex = 2;
+};
+
+/**
+* Latest message of one stream
+*/
+struct AcquiredMessage
+{
+    // raw message as received from device
+    std::shared_ptr<dai::ADatatype> msg;
+    // ImgFrame messages: BGR for color frames, zero-copy view for mono/depth/disparity. Empty otherwise
+    cv::Mat frame;
+    // owned conversion buffer backing frame when it's not a view
+    cv::Mat buffer;
+
+    template <typename T>
+    std::shared_ptr<T> get() const
+    {
+        return std::dynamic_pointer_cast<T>(msg);
+    }
+};
+
+/**
+* Messages of same capture, one per bundled stream
+*/
+struct AcquiredBundle
+{
+    // same order as BundlePolicy streams present on pipeline
+    std::vector<std::string> names;
+    std::vector<AcquiredMessage> messages;
+    // sequence number and device timestamp (microseconds) of first stream message
+    int64_t sequenceNum = 0;
+    int64_t timestamp = 0;
+
+    AcquiredMessage* get(const std::string& name)
+    {
+        for (size_t i = 0; i < names.size(); i++) if (names[i] == name) return &messages[i];
+        return NULL;
+    }
+};
+
+/**
+* Bundle matching counters since pipeline start
+*/
+struct BundleStats
+{
+    uint64_t bundles = 0;
+    // messages dropped because they were stale (newer bundle matched) or buffer was full
+    uint64_t dropped = 0;
+    // messages without sequence number/timestamp, can't be matched
+    uint64_t unmatchable = 0;
+};
+
+/**
+* Link and host cost of one acquired stream, measured over last full second
+*/
+struct StreamStats
+{
+    // messages received per second (including messages replaced before being read)
+    float fps = 0.0f;
+    // payload bytes received per second (link bandwidth of stream)
+    float bytesPerSecond = 0.0f;
+    // mean host conversion time per frame (decode for encoded streams) in microseconds
+    float convertMicros = 0.0f;
+    // stream is encoded bitstream (MJPEG), decoded on acquisition thread
+    bool encoded = false;
+    // last runtime control affecting stream (see Control.hpp): time from send until first frame captured after it arrived,
+    // and frames received meanwhile (including that frame). -1 if nothing was measured
+    float controlLatencyMs = -1.0f;
+    int controlFrames = 0;
+};
+
+/**
+* Acquisition worker of one device
+*/
+class DeviceAcquisition
+{
+public:
+    /**
+    * @param device running device
+    * @param policy host queue policy of acquired streams
+    * @param syncStreams output streams read synchronously by results path (request/response). Not acquired.
+    * @param bundle output streams matched into bundles
+    */
+    DeviceAcquisition(std::shared_ptr<dai::Device> device, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+        const BundlePolicy& bundle = BundlePolicy());
+    ~DeviceAcquisition();
+
+    void start();
+    void stop();
+
+    /**
+    * Latest message of stream
+    *
+    * @param stream stream name
+    * @param isNew optional. Set to true if message was published after previous call
+    * @returns latest message or NULL if stream is not acquired or nothing was received yet. Valid until next call for same stream.
+    */
+    AcquiredMessage* latest(const std::string& stream, bool* isNew);
+
+    /**
+    * Latest matched bundle
+    *
+    * @param isNew optional. Set to true if bundle was published after previous call
+    * @returns latest bundle or NULL if there are no bundled streams or nothing was matched yet. Valid until next call.
+    */
+    AcquiredBundle* bundle(bool* isNew);
+
+    /**
+    * Output queue of stream not acquired (sync streams, sysinfo, imu)
+    *
+    * @param stream stream name
+    * @returns queue handle or nullptr if pipeline has no such output
+    */
+    std::shared_ptr<dai::DataOutputQueue> output(const std::string& stream) const;
+
+    /**
+    * Input queue of XLinkIn stream
+    *
+    * @param stream stream name
+    * @returns queue handle or nullptr if pipeline has no such input
+    */
+    std::shared_ptr<dai::DataInputQueue> input(const std::string& stream) const;
+
+    /**
+    * Stats of every acquired stream
+    */
+    std::vector<std::pair<std::string, StreamStats>> stats();
+    BundleStats bundleStats();
+
+    /**
+    * Measure control latency on next frames of stream (StreamStats controlLatencyMs)
+    *
+    * @param stream stream affected by control
+    * @param sent host steady clock in microseconds when control was sent (same clock as device timestamps)
+    */
+    void probe(const std::string& stream, int64_t sent);
+
+private:
+    // bundled message waiting for match
+    struct Pending
+    {
+        std::shared_ptr<dai::ADatatype> msg;
+        int64_t sequenceNum;
+        int64_t timestamp;
+    };
+
+    struct Stream
+    {
+        std::shared_ptr<dai::DataOutputQueue> queue;
+        TripleBuffer<AcquiredMessage> slots;
+        bool received = false;
+        // bundled streams: messages waiting for match, oldest first
+        bool bundled = false;
+        std::deque<Pending> pending;
+        bool encoded = false;
+
+        // control probe: send time (0 if none), set by probe(). Frames received since probe being counted (acquisition thread)
+        std::atomic<int64_t> probeSent{0};
+        int64_t probeCounted = 0;
+        int probeFrames = 0;
+
+        // counters of current second (acquisition thread) and stats of last second (guarded by statsMutex)
+        uint64_t messages = 0, bytes = 0, converted = 0;
+        std::chrono::microseconds convertTime{0};
+        std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+        StreamStats last;
+    };
+
+    void run();
+    void drain(Stream& stream);
+    void convert(Stream& stream, const std::shared_ptr<dai::ImgFrame>& imgFrame, AcquiredMessage& slot);
+    void addPending(Stream& stream, const std::shared_ptr<dai::ADatatype>& msg);
+    void matchBundle();
+    void checkProbe(Stream& stream, const std::vector<std::shared_ptr<dai::ADatatype>>& msgs);
+    // publish stats of last window once it lasted a second (acquisition thread)
+    void rollStats(Stream& stream, std::chrono::steady_clock::time_point now);
+
+    std::shared_ptr<dai::Device> device;
+    std::unordered_map<std::string, std::unique_ptr<Stream>> streams;
+    std::unordered_map<std::string, std::shared_ptr<dai::DataOutputQueue>> outputs;
+    std::unordered_map<std::string, std::shared_ptr<dai::DataInputQueue>> inputs;
+    std::vector<std::string> names;
+
+    // bundled streams in bundle order, matched bundles and counters (guarded by statsMutex)
+    std::vector<Stream*> bundleStreams;
+    std::vector<std::string> bundleNames;
+    int64_t bundleTolerance = 0;
+    size_t bundleBufferSize = 1;
+    TripleBuffer<AcquiredBundle> bundles;
+    bool bundleReceived = false;
+    BundleStats bundleCounters;
+
+    std::atomic<bool> running{false};
+    std::thread worker;
+    std::mutex statsMutex;
+};
+
+/**
+* Start acquisition worker for device. Replaces previous worker on same deviceNum.
+* Runs on boot thread with async boot: workers are swapped atomically, the previous one is freed once no results call
+* holds it (GetAcquisition)
+*
+* @param deviceNum Device selection on unity dropdown
+* @param device running device
+* @param policy host queue policy of acquired streams
+* @param syncStreams output streams read synchronously by results path. Not acquired.
+* @param bundle output streams matched into bundles (GetBundle)
+*/
+void StartAcquisition(int deviceNum, std::shared_ptr<dai::Device> device, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+    const BundlePolicy& bundle = BundlePolicy());
+
+/**
+* Stop acquisition worker for device. Must be called before closing device.
+*
+* @param deviceNum Device selection on unity dropdown
+*/
+void StopAcquisition(int deviceNum);
+
+/**
+* Acquisition worker of device. Results calls hold it until their last read of acquired messages and frames: with
+* async boot the boot thread can replace the worker (StartAcquisition) while a results call is still reading its slots.
+*
+* @param deviceNum Device selection on unity dropdown
+* @returns worker or nullptr if device is not acquired
+*/
+std::shared_ptr<DeviceAcquisition> GetAcquisition(int deviceNum);
+
+/**
+* Latest message of stream acquired for device
+*
+* @param acquisition worker of device (GetAcquisition), must be held while message is used
+* @param stream XLinkOut stream name
+* @param isNew optional. Set to true if message was published after previous call
+* @returns latest message or NULL if nothing received yet
+*/
+AcquiredMessage* GetAcquired(const std::shared_ptr<DeviceAcquisition>& acquisition, const std::string& stream, bool* isNew = NULL);
+
+/**
+* Latest bundle of device (messages of same capture from BundlePolicy streams)
+*
+* @param acquisition worker of device (GetAcquisition), must be held while bundle is used
+* @param isNew optional. Set to true if bundle was published after previous call
+* @returns latest bundle or NULL if nothing matched yet
+*/
+AcquiredBundle* GetBundle(const std::shared_ptr<DeviceAcquisition>& acquisition, bool* isNew = NULL);
+
+/**
+* Bundle matching counters of device
+*
+* @param deviceNum Device selection on unity dropdown
+*/
+BundleStats GetBundleStats(int deviceNum);
+
+/**
+* Output queue of stream not acquired for device (sync streams, sysinfo, imu)
+*
+* @param deviceNum Device selection on unity dropdown
+* @param stream XLinkOut stream name
+* @returns queue handle or nullptr if not available
+*/
+std::shared_ptr<dai::DataOutputQueue> GetOutputQueue(int deviceNum, const std::string& stream);
+
+/**
+* Stats of every stream acquired for device (fps, link bandwidth, host conversion/decode time)
+*
+* @param deviceNum Device selection on unity dropdown
+* @returns stats per stream name, empty if device is not acquired
+*/
+std::vector<std::pair<std::string, StreamStats>> GetStreamStats(int deviceNum);
+
+/**
+* Measure latency of runtime control on next frames of stream
+*
+* @param deviceNum Device selection on unity dropdown
+* @param stream stream affected by control, ignored if not acquired
+* @param sent host steady clock in microseconds when control was sent
+*/
+void ProbeControl(int deviceNum, const std::string& stream, int64_t sent);
+
+/**
+* Input queue of device
+*
+* @param deviceNum Device selection on unity dropdown
+* @param stream XLinkIn stream name
+* @returns queue handle or nullptr if not available
+*/
+std::shared_ptr<dai::DataInputQueue> GetInputQueue(int deviceNum, const std::string& stream);
@@ -0,0 +1,58 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+/**
+* Color maps of depth/disparity visualization. Mirroring depthColorMap/disparityColorMap on Unity PipelineConfig.
+*/
+enum class ColorMap
+{
+    DEFAULT,    // stream default: EQUALIZED for depth, JET for disparity
+    GRAY,
+    JET,
+    TURBO,
+    EQUALIZED,  // histogram equalized grayscale
+};
+
+/**
+* Depth/disparity colorizer writing straight into Unity texture memory (ARGB32 read back as Color32)
+*
+* Every input value (256 entries for CV_8UC1, 64K for CV_16UC1) is mapped to its final RGBA color with a lookup table,
+* so colorization is a single gather pass per frame. Tables are rebuilt only when color map or range change.
+* Equalized map keeps a smoothed histogram of a subsampled frame and only rewrites table entries whose level changed.
+* Value 0 (invalid depth / disparity) is black. One instance per stream.
+*/
+class Colorizer
+{
+public:
+    /**
+    * Colorize frame
+    *
+    * @param frame depth (CV_16UC1, mm) or disparity (CV_8UC1 or CV_16UC1 subpixel) frame
+    * @param map color map. DEFAULT must be resolved by caller
+    * @param range value mapped to last color (same units as frame). 0 or negative: max value of current frame
+    * @param ptr destination pointer (pinned Color32 array on Unity), frame.cols*frame.rows*4 bytes
+    */
+    void colorize(const cv::Mat& frame, ColorMap map, float range, void* ptr);
+
+private:
+    void scan(const cv::Mat& frame, bool histogram);
+    void updateLinear(ColorMap map, int range);
+    void updateEqualized();
+
+    std::vector<std::uint32_t> lut;
+    int lutType = -1;
+    ColorMap lutMap = ColorMap::DEFAULT;
+    int lutRange = 0;
+
+    // subsampled frame statistics: max value and histogram of value >> binShift
+    int frameMax = 0;
+    int binShift = 0;
+    std::vector<int> hist;
+    std::vector<float> levels;
+    std::vector<std::uint8_t> levelBytes;
+};
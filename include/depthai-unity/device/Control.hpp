@@ -0,0 +1,48 @@
+#pragma once
+
+// std
+#include <memory>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "DeviceNum.hpp"
+
+/**
+* Runtime control of running pipelines
+*
+* Builders link XLinkIn control inputs to color camera ("colorControl" -> CameraControl) and stereo ("stereoConfig" ->
+* StereoDepthConfig), so camera and stereo knobs of PipelineConfig change without closing the device (firmware boot).
+* Nodes apply controls to the next frame they process. StereoDepthConfig replaces whole stereo config, so the config
+* built by the pipeline is kept per device and only changed fields are updated before sending.
+* Spatial depth thresholds are host side, used for ROIs sent to SpatialLocationCalculator and host spatial engine.
+*
+* Every control starts a latency probe on affected streams, reported by DAIStreamStats (control_ms, control_frames).
+*/
+
+/**
+* Link camera control input. Resets runtime control state of device, call once per pipeline before AddStereoControl
+*
+* @param pipeline pipeline being built
+* @param deviceNum Device selection on unity dropdown
+* @param colorCam color camera of pipeline
+*/
+void AddCameraControl(dai::Pipeline& pipeline, int deviceNum, std::shared_ptr<dai::node::ColorCamera> colorCam);
+
+/**
+* Link stereo config input. Call once stereo initialConfig is set
+*
+* @param pipeline pipeline being built
+* @param deviceNum Device selection on unity dropdown
+* @param stereo stereo node of pipeline
+*/
+void AddStereoControl(dai::Pipeline& pipeline, int deviceNum, std::shared_ptr<dai::node::StereoDepth> stereo);
+
+/**
+* Spatial depth thresholds of device
+*
+* @param deviceNum Device selection on unity dropdown
+* @param lower in: pipeline default. out: threshold set at runtime if any (mm)
+* @param upper in: pipeline default. out: threshold set at runtime if any (mm)
+*/
+void GetSpatialThresholds(int deviceNum, float& lower, float& upper);
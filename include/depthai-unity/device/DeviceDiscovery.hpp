@@ -0,0 +1,91 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+/**
+* Background device discovery
+*
+* XLink is scanned every DAI_DISCOVERY_INTERVAL_MS on a discovery thread into a cached device table, so device listing
+* (GetAllDevices, Unity dropdown) and availability checks read a snapshot instead of blocking on a USB/network scan.
+* Devices missing from a scan are kept (not present) for DAI_DISCOVERY_LOST_MS, as devices re-enumerate while booting.
+* Every change of the table (device found, lost or changing state) increases sequence.
+*/
+#define DAI_DISCOVERY_INTERVAL_MS 1000
+#define DAI_DISCOVERY_LOST_MS 3000
+
+struct DiscoveredDevice
+{
+    // MxId
+    std::string deviceId;
+    // XLink device info of last scan seeing device
+    dai::DeviceInfo info;
+    // seen on last scan
+    bool present = false;
+    std::chrono::steady_clock::time_point firstSeen;
+    std::chrono::steady_clock::time_point lastSeen;
+};
+
+class DeviceDiscovery
+{
+public:
+    static DeviceDiscovery& instance();
+
+    // start discovery thread, no-op if running. First scan is done before returning if there is none yet
+    void start();
+    // stop discovery thread. Table stays readable and is refreshed by scan()
+    void stop();
+
+    /**
+    * Cached device table, starts discovery if needed
+    *
+    * @param sequence optional, table sequence of snapshot
+    * @returns devices found on last scans, present or lost for less than DAI_DISCOVERY_LOST_MS
+    */
+    std::vector<DiscoveredDevice> snapshot(uint64_t* sequence = nullptr);
+
+    // table sequence, increases with every change
+    uint64_t sequence();
+
+    /**
+    * Devices present on a scan not older than maxAgeMs, scanning now if last scan is older
+    *
+    * @param maxAgeMs accepted age of last scan. 0 always scans
+    */
+    std::vector<dai::DeviceInfo> devices(int maxAgeMs);
+
+    // scan XLink now and update table
+    std::vector<dai::DeviceInfo> scan();
+
+private:
+    DeviceDiscovery() = default;
+    ~DeviceDiscovery();
+
+    void run();
+    // under mutex: merge scan into table
+    void update(const std::vector<dai::DeviceInfo>& found, std::chrono::steady_clock::time_point now);
+    // under mutex: present devices
+    std::vector<dai::DeviceInfo> presentDevices() const;
+
+    // one XLink scan at a time (discovery thread and scan())
+    std::mutex scanMutex;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<DiscoveredDevice> table;
+    uint64_t tableSequence = 0;
+    std::chrono::steady_clock::time_point scanned;
+    bool hasScan = false;
+
+    std::thread thread;
+    bool running = false;
+};
@@ -3,6 +3,10 @@
 // std
 #include <thread>
 
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/DeviceRegistry.hpp"
+#include "depthai-unity/device/Results.hpp"
+
 /**
 * FrameInfo contains pointers to all the images available on OAK devices. Mirroring FrameInfo on Unity.
 *
@@ -95,6 +99,32 @@ struct PipelineConfig
 
     // Use Spatial Locator for 3D compute
     bool useSpatialLocator;
+
+    // Host queues of acquired streams. queueMaxSize 0: default (1)
+    int queueMaxSize;
+    bool queueBlocking;
+
+    // Depth/disparity visualization. 0: default (equalized for depth, JET for disparity), 1: grayscale, 2: JET, 3: TURBO, 4: equalized
+    int depthColorMap;
+    int disparityColorMap;
+    // Depth mapped to last color of grayscale/JET/TURBO in meters. 0: max depth of each frame
+    float depthColorRange;
+
+    // Streams pipeline outputs (StreamMask). Streams not in mask are not created. 0: all streams
+    int streamMask;
+    // Route outputs through a Script node, so they can be paused/resumed at runtime (SetStreamsEnabled). Uses device CPU.
+    // Every output is created, streamMask is the initial set of enabled outputs
+    bool streamGating;
+
+    // Display preview resized on device (ImageManip) from full camera field of view. 0: preview is NN input (passthrough)
+    int displayWidth, displayHeight;
+
+    // Encoded transport of preview and mono streams (VideoEncoder on device, decoded on acquisition thread). 0: raw, 1: MJPEG
+    int videoEncoding;
+    // Encoder quality 1-100. 0: default (80)
+    int encoderQuality;
+    // Boot device on background thread, Init returns once device is claimed; results report not running until pipeline runs
+    bool asyncBoot;
 };
 
 /**
@@ -124,7 +154,32 @@ bool IsDeviceRunning(int deviceNum);
 bool DAIStartPipeline(dai::Pipeline pipeline, int deviceNum, const char* deviceId);
 
 /**
-* Check for available specific device or first available device
+* Start DepthAI pipeline with specific device mxid or first available device.
+* Output streams are acquired on background thread (see Acquisition.hpp) except syncStreams
+*
+* @param pipeline DepthAI pipeline
+* @param deviceNum Device selection on unity dropdown
+* @param deviceId Device MxId
+* @param policy host queue policy of acquired streams (PipelineConfig queueMaxSize, queueBlocking)
+* @param syncStreams output streams read synchronously by results path (request/response like second stage NN)
+* @param bundle output streams matched by capture (preview, detections, depth of same frame). See GetBundle
+* @returns True if device available and start pipeline, false otherwise 
+*/
+bool DAIStartPipeline(dai::Pipeline pipeline, int deviceNum, const char* deviceId, const StreamPolicy& policy, const std::vector<std::string>& syncStreams = {},
+    const BundlePolicy& bundle = BundlePolicy());
+
+/**
+* Same as DAIStartPipeline but device boots on background thread (see DeviceRegistry), so several devices boot in parallel.
+* Device is not running (GetDevice returns nullptr) until boot and acquisition start are done. Progress on DAIGetBootInfo
+*
+* @param onStarted optional, called on boot thread once acquisition is started (e.g. read calibration)
+* @returns True if device available and claimed, false otherwise
+*/
+bool DAIStartPipelineAsync(dai::Pipeline pipeline, int deviceNum, const char* deviceId, const StreamPolicy& policy, const std::vector<std::string>& syncStreams = {},
+    const BundlePolicy& bundle = BundlePolicy(), DeviceRegistry::StartedCallback onStarted = nullptr);
+
+/**
+* Check for available specific device or first available device. Reads discovery table, doesn't scan XLink
 *
 * @param deviceId Device MxId
 * @returns True if specific device or there is any device with state different than X_LINK_BOOTED
@@ -133,17 +188,18 @@ bool CheckForAvailableDevice(const char* deviceId);
 
 // common methods to retrieve device stats and IMU
 /**
-* Get device system info. Needs pipeline definition
+* Get device system info (cached, latest SystemLogger message). Needs pipeline definition
 *
-* @param device Smart pointer to device
-* @returns Json with system info: ddr_used, ddr_total, leoncss_heap_used, leoncss_heap_total, leonmss_heap_used, leonmss_heap_total, cmx_used,cmx_total, chip_temp_avg and cpu_usage
+* @param deviceNum Device selection on unity dropdown
+* @param sysinfo system info: ddr, leon css/mss heap and cmx memory (used/total), chip temperature average and cpu usage. valid is 0 if not available
 */
-nlohmann::json GetDeviceInfo(std::shared_ptr<dai::Device> device);
+void GetDeviceInfo(int deviceNum, SysInfoResult& sysinfo);
 
 /**
 * Get IMU information from device. Needs device with IMU and pipeline definition
 *
-* @param device Smart pointer to device
-* @returns Json with IMU info: I,J,K, Real and accuracy 
+* @param deviceNum Device selection on unity dropdown
+* @param imu rotation vector I,J,K, Real and accuracy. valid is 0 if not available
+* @param timestamp frame timestamp (host steady clock, microseconds) to interpolate rotation vector at. 0: latest report
 */
-nlohmann::json GetIMU(std::shared_ptr<dai::Device> device);
\ No newline at end of file
+void GetIMU(int deviceNum, IMUResult& imu, int64_t timestamp = 0);
\ No newline at end of file
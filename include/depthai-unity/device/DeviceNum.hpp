@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+* deviceNum is the device handle of every plugin call (Unity dropdown index)
+*
+* Per device state of every module (acquisition, collectors, controls, results buffers, ...) lives in fixed tables indexed
+* by deviceNum. DeviceRegistry refuses to start devices out of [0, DAI_MAX_DEVICES) and every entry point taking a
+* deviceNum checks it, so an invalid handle behaves as a device that isn't running.
+*/
+#define DAI_MAX_DEVICES 10
+
+inline bool ValidDeviceNum(int deviceNum)
+{
+    return deviceNum >= 0 && deviceNum < DAI_MAX_DEVICES;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+// std
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "depthai-unity/device/DeviceDiscovery.hpp"
+#include "depthai-unity/device/DeviceNum.hpp"
+
+/**
+* Thread safe registry of running devices, keyed by deviceNum (handle used by every plugin call)
+*
+* Devices are claimed from the discovery table (scanned again if older than DAI_ENUMERATION_MAX_AGE_MS or when no
+* device matches), so several devices started at once don't rescan XLink each and never claim the same device.
+* Boot (firmware and pipeline upload) runs on the calling thread or on a background thread per device (async),
+* so N devices boot concurrently in about the time of one.
+*/
+#define DAI_ENUMERATION_MAX_AGE_MS 2000
+
+enum DeviceBootState
+{
+    DEVICE_BOOTING = 1,
+    DEVICE_RUNNING = 2,
+    DEVICE_FAILED = 3,
+};
+
+/**
+* Boot of one device, kept after device is closed until deviceNum is started again
+*/
+struct DeviceBootInfo
+{
+    int deviceNum = 0;
+    // MxId of claimed device
+    std::string deviceId;
+    DeviceBootState state = DEVICE_BOOTING;
+    // device enumeration before claim, about 0 if discovery table was recent
+    float enumerateMs = 0.0f;
+    // device boot and pipeline upload (dai::Device constructor)
+    float bootMs = 0.0f;
+    // acquisition and collectors start
+    float startMs = 0.0f;
+    // exception message if boot failed
+    std::string error;
+};
+
+class DeviceRegistry
+{
+public:
+    // called on boot thread once device runs the pipeline, before device is reported as running
+    typedef std::function<void(std::shared_ptr<dai::Device>)> StartedCallback;
+
+    static DeviceRegistry& instance();
+
+    /**
+    * Claim device and boot it with pipeline
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @param pipeline DepthAI pipeline
+    * @param deviceId Device MxId, NULL for first available device
+    * @param onStarted optional, called once pipeline is running
+    * @param async if true returns once device is claimed and boots on background thread
+    * @returns false if deviceNum is invalid, booting/running or no device is available. Sync: false if boot failed
+    */
+    bool start(int deviceNum, dai::Pipeline pipeline, const char* deviceId, StartedCallback onStarted, bool async);
+
+    /**
+    * Remove device, waiting for its boot
+    *
+    * @returns device to close, nullptr if device was not running
+    */
+    std::shared_ptr<dai::Device> release(int deviceNum);
+
+    // running device or nullptr (booting, failed or not started)
+    std::shared_ptr<dai::Device> device(int deviceNum);
+    bool running(int deviceNum);
+
+    // boot info of every started device
+    std::vector<DeviceBootInfo> bootInfo();
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<dai::Device> device;
+        DeviceBootInfo info;
+        std::thread boot;
+    };
+
+    DeviceRegistry() = default;
+    ~DeviceRegistry();
+
+    void boot(std::shared_ptr<Entry> entry, dai::Pipeline pipeline, dai::DeviceInfo deviceInfo, StartedCallback onStarted);
+    // without mutex: devices of discovery table, scanned now if force or table is old
+    std::vector<dai::DeviceInfo> scan(bool force);
+    // takes mutex: available device of enumeration not claimed by any entry
+    bool claim(const std::vector<dai::DeviceInfo>& enumeration, const char* deviceId, dai::DeviceInfo& deviceInfo);
+
+    std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<Entry>> entries;
+    std::unordered_set<std::string> claimed;
+    // boot info of closed devices
+    std::unordered_map<int, DeviceBootInfo> closed;
+    // device states changed (closed or failed boot), don't trust discovery table
+    bool forceScan = false;
+};
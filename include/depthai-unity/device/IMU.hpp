@@ -0,0 +1,108 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "Results.hpp"
+
+/**
+* IMU collector
+*
+* Every accelerometer, gyroscope and rotation vector report of the "imu" stream is stored with its timestamp in a
+* lock-free ring per device. Reports are collected by a callback on the device queue as soon as packets arrive
+* (batches set by batchReportThreshold/maxBatchReports), so no report is dropped between results calls.
+* Timestamps are host steady clock in microseconds, same clock as frame timestamps (AcquiredBundle, ImgFrame::getTimestamp).
+*/
+
+// sensor of IMUSample
+enum IMUSensorType
+{
+    IMU_ACCELEROMETER = 0,    // x, y, z in m/s^2
+    IMU_GYROSCOPE = 1,        // x, y, z in rad/s
+    IMU_ROTATION_VECTOR = 2,  // quaternion x (i), y (j), z (k), w (real)
+};
+
+/**
+* One IMU report. Mirrored on PredefinedBase.cs
+*/
+struct IMUSample
+{
+    // host steady clock in microseconds
+    int64_t timestamp;
+    int32_t sensor;
+    // rotation vector accuracy in radians, sensor accuracy status otherwise
+    float accuracy;
+    float x, y, z, w;
+};
+
+/**
+* Single producer ring of IMU samples. Readers don't block producer: samples overwritten while being read are discarded
+*/
+class IMURing
+{
+public:
+    static const size_t CAPACITY = 8192;
+
+    // producer
+    void push(const IMUSample& sample);
+
+    /**
+    * Copy samples written since cursor
+    *
+    * @param cursor index of next sample to read, updated. Samples older than ring capacity are skipped
+    * @param samples destination
+    * @param maxSamples destination size. Oldest samples are skipped if there are more
+    * @returns number of samples copied
+    */
+    size_t read(uint64_t& cursor, IMUSample* samples, size_t maxSamples) const;
+
+    // index of next sample written
+    uint64_t end() const { return writeIndex.load(std::memory_order_acquire); }
+
+private:
+    IMUSample slots[CAPACITY];
+    std::atomic<uint64_t> writeIndex{0};
+};
+
+/**
+* Start collecting IMU reports of device. Replaces previous collector on same deviceNum
+*
+* @param deviceNum Device selection on unity dropdown
+* @param queue "imu" output queue, nothing is collected if nullptr
+*/
+void StartIMU(int deviceNum, std::shared_ptr<dai::DataOutputQueue> queue);
+
+/**
+* Stop collecting IMU reports of device. Collected samples stay readable
+*
+* @param deviceNum Device selection on unity dropdown
+*/
+void StopIMU(int deviceNum);
+
+/**
+* Samples collected since previous call (one reader per device)
+*
+* @param deviceNum Device selection on unity dropdown
+* @param samples destination
+* @param maxSamples destination size. Oldest samples are skipped if there are more
+* @returns number of samples copied
+*/
+size_t GetIMUSamples(int deviceNum, IMUSample* samples, size_t maxSamples);
+
+/**
+* Sensor value at timestamp, interpolated between the two reports around it (slerp for rotation vector).
+* Latest report if timestamp is newer than every report or 0
+*
+* @param deviceNum Device selection on unity dropdown
+* @param sensor IMUSensorType
+* @param timestamp host steady clock in microseconds. 0: latest
+* @param sample interpolated sample
+* @returns false if no report of sensor is available
+*/
+bool GetIMUAt(int deviceNum, int sensor, int64_t timestamp, IMUSample& sample);
@@ -0,0 +1,68 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+* Streaming json writer
+*
+* Serializes straight into a growable text buffer, no json tree. clear() keeps capacity,
+* so a writer reused for every results call stops allocating once it reached the biggest payload.
+* Commas are handled by the writer, callers only open/close containers and write keys and values.
+* Non finite floats are written as null (same as nlohmann).
+*/
+class JsonWriter
+{
+public:
+    /**
+    * Start new document. Keeps buffer capacity
+    */
+    void clear();
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    /**
+    * Object key. Next call writes its value
+    *
+    * @param name key, written escaped
+    */
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(int v);
+    JsonWriter& value(float v);
+    JsonWriter& value(double v) { return value((float) v); }
+    JsonWriter& value(bool v);
+    JsonWriter& value(const char* v);
+    JsonWriter& value(const std::string& v);
+    JsonWriter& null();
+
+    /**
+    * Key and value in one call
+    */
+    template <typename T>
+    JsonWriter& field(const char* name, const T& v)
+    {
+        return key(name).value(v);
+    }
+
+    // null terminated document
+    const char* c_str() const { return buffer.c_str(); }
+    size_t size() const { return buffer.size(); }
+
+private:
+    // comma before value if container already has elements
+    void separator();
+    void open(char c);
+    void close(char c);
+    void string(const char* s);
+
+    std::string buffer;
+    // per open container: true if it has no elements yet
+    std::vector<bool> first;
+    bool afterKey = false;
+};
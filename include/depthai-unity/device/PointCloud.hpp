@@ -0,0 +1,88 @@
+#pragma once
+
+// std
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+/**
+* PointCloudConfig contains point cloud generation options. Mirroring PointCloudConfig on Unity.
+*/
+struct PointCloudConfig
+{
+    // subsampling step in pixels (1: full resolution, 2: every second pixel on each axis, ...)
+    int stride;
+    // depth range in meters, points outside are culled. maxDepth 0: no limit
+    float minDepth, maxDepth;
+    // 0: float (4 bytes per component), 1: half float (2 bytes per component)
+    int format;
+    // add 4th component with intensity [0,1] from rectified right image
+    bool useIntensity;
+    // voxel grid downsampling, voxel edge in meters. One point (centroid) per occupied voxel. 0: no downsampling
+    float voxelSize;
+};
+
+/**
+* Host side point cloud generator
+*
+* Unprojects depth frame (CV_16UC1, mm) with camera intrinsics into packed point buffer:
+* x,y,z (+ intensity) per point in meters, Unity coordinates (x right, y up, z forward).
+* Rays are cached per resolution and stride. Rectified depth has no distortion, so ray table is separable (one x per column, one y per row).
+* Optional voxel grid filter keeps one point per voxel using open addressing hash. All buffers are reused between frames.
+*/
+class PointCloudGenerator
+{
+public:
+    /**
+    * Set calibration used to get intrinsics of depth frames
+    *
+    * @param calibration device calibration
+    * @param socket camera depth is aligned to (RIGHT by default, RGB if depth is aligned to color camera)
+    */
+    void setCalibration(const dai::CalibrationHandler& calibration, dai::CameraBoardSocket socket);
+
+    /**
+    * Generate point cloud
+    *
+    * @param depth depth frame CV_16UC1 in mm
+    * @param intensity rectified image CV_8UC1 with same size as depth. Only used if config.useIntensity
+    * @param config generation options
+    * @param dst destination buffer, at least maxPoints * (3 or 4 components) * (4 or 2 bytes)
+    * @param maxPoints destination capacity in points
+    * @returns number of points written
+    */
+    int generate(const cv::Mat& depth, const cv::Mat& intensity, const PointCloudConfig& config, void* dst, int maxPoints);
+
+private:
+    struct Voxel
+    {
+        uint64_t key;
+        uint32_t stamp;
+        uint32_t count;
+        float sum[4];
+    };
+
+    void updateRays(int width, int height, int stride);
+    int unproject(const cv::Mat& depth, const cv::Mat& intensity, const PointCloudConfig& config, int format, void* dst, int maxPoints);
+    int voxelFilter(const float* points, int numPoints, int comps, float voxelSize, int format, void* dst, int maxPoints);
+
+    dai::CalibrationHandler calibration;
+    dai::CameraBoardSocket socket = dai::CameraBoardSocket::RIGHT;
+    bool calibrated = false;
+
+    // ray table of current resolution and stride
+    int width = 0, height = 0, stride = 0;
+    std::vector<float> rayX, rayY;
+
+    // first output point of each subsampled row
+    std::vector<int> rowOffsets;
+
+    // voxel filter arena: unfiltered points, hash table (slots valid if stamp matches current frame) and occupied slots in insertion order
+    std::vector<float> arena;
+    std::vector<Voxel> voxels;
+    std::vector<int> occupied;
+    uint32_t stamp = 0;
+};
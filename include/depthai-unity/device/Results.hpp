@@ -0,0 +1,199 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+#include "DeviceNum.hpp"
+#include "JsonWriter.hpp"
+
+/**
+* Binary results interface
+*
+* Every *Results function has a *ResultsBinary twin filling FrameResults: fixed layout POD structs (32 bit fields only, no pointers)
+* readable on Unity with blittable marshalling. No json tree, no strings and no result allocation per frame.
+* Results are written into caller memory or, if caller passes NULL, into plugin owned ring of FrameResults per device.
+* Json interface is built from the same FrameResults and is kept for debugging and recording.
+* Json strings are written by JsonWriter into plugin owned buffers per device (see BeginJsonResults).
+*
+* Mirroring FrameResults on Unity (PredefinedBase.cs). Increase DAI_RESULTS_VERSION on any layout change.
+*/
+#define DAI_RESULTS_VERSION 2
+// detections past DAI_MAX_DETECTIONS (binary and json) are not reported, only counted in droppedDetections
+#define DAI_MAX_DETECTIONS 32
+#define DAI_MAX_LANDMARKS 17
+// plugin owned results per device. Returned pointer is valid for next DAI_RESULTS_RING-1 calls
+#define DAI_RESULTS_RING 4
+// json results buffers per device, returned strings held by Unity until released
+#define DAI_JSON_BUFFERS 3
+
+enum ResultsError
+{
+    RESULTS_OK = 0,
+    RESULTS_NO_DEVICE = 1,
+    RESULTS_DEVICE_NOT_RUNNING = 2,
+};
+
+/**
+* Detection (face, object). Box normalized [0,1], center in preview pixels, spatial coordinates in mm
+*/
+struct DetectionResult
+{
+    int32_t label;
+    float score;
+    float xmin, ymin, xmax, ymax;
+    int32_t xcenter, ycenter;
+    int32_t hasSpatial;
+    int32_t X, Y, Z;
+};
+
+/**
+* Head pose of detection with same index. Angles in degrees
+*/
+struct HeadPoseResult
+{
+    int32_t valid;
+    float yaw, pitch, roll;
+};
+
+/**
+* Emotion scores of detection with same index
+*/
+struct EmotionResult
+{
+    int32_t valid;
+    float neutral, happy, sad, surprise, anger;
+};
+
+/**
+* Body landmark. Position in preview pixels, spatial coordinates in mm
+*/
+struct LandmarkResult
+{
+    int32_t index;
+    int32_t xpos, ypos;
+    int32_t hasSpatial;
+    int32_t X, Y, Z;
+};
+
+/**
+* Device system information. Memory in MiB, cpu usage in %
+*/
+struct SysInfoResult
+{
+    int32_t valid;
+    float ddrUsed, ddrTotal;
+    float leonCssHeapUsed, leonCssHeapTotal;
+    float leonMssHeapUsed, leonMssHeapTotal;
+    float cmxUsed, cmxTotal;
+    float chipTempAvg;
+    float cpuUsage;
+};
+
+/**
+* IMU rotation vector (quaternion), latest or at frame timestamp
+*/
+struct IMUResult
+{
+    int32_t valid;
+    float i, j, k, real;
+    float accuracy;
+};
+
+/**
+* Results of one *ResultsBinary call
+*/
+struct FrameResults
+{
+    // DAI_RESULTS_VERSION and sizeof(FrameResults), to check layout on Unity side
+    int32_t version;
+    int32_t size;
+    // ResultsError
+    int32_t error;
+    // incremented on every call for same device
+    int32_t sequence;
+    int32_t previewWidth, previewHeight;
+
+    // detections (faces, objects). best: index of best detection, -1 if none
+    int32_t numDetections;
+    int32_t best;
+    DetectionResult detections[DAI_MAX_DETECTIONS];
+    HeadPoseResult headPoses[DAI_MAX_DETECTIONS];
+    EmotionResult emotions[DAI_MAX_DETECTIONS];
+
+    // body pose
+    int32_t numLandmarks;
+    LandmarkResult landmarks[DAI_MAX_LANDMARKS];
+
+    // point cloud: points generated, -1 if no point cloud buffer. depthError: 1 if depth doesn't fit Unity texture
+    int32_t numPoints;
+    int32_t depthError;
+
+    SysInfoResult sysinfo;
+    IMUResult imu;
+
+    // detections over DAI_MAX_DETECTIONS not reported on this call
+    int32_t droppedDetections;
+};
+
+/**
+* Reset results for a new call
+*
+* @param deviceNum Device selection on unity dropdown
+* @param results caller results or NULL to use next plugin owned results of device
+* @returns results to fill
+*/
+FrameResults* BeginResults(int deviceNum, FrameResults* results);
+
+/**
+* Finish binary results of device started with BeginResults. Publishes them if DAIPublishResults is active
+*
+* @returns results
+*/
+FrameResults* EndResults(int deviceNum, FrameResults* results);
+
+/**
+* Publish frame of device if DAIPublishResults is active. Skipped if ring is full or frame doesn't fit a slot
+*
+* @param type OpenCV type (CV_8UC3, ...)
+* @param step row size in bytes
+*/
+void PublishFrame(int deviceNum, int width, int height, int type, size_t step, const void* data);
+
+/**
+* Add detection to results. Counted in droppedDetections if DAI_MAX_DETECTIONS is reached (logged once)
+*
+* @returns new detection (zeroed) or NULL if full
+*/
+DetectionResult* AddDetection(FrameResults& results);
+
+// json interface, written from binary results. Invalid sysinfo/imu are written as null
+void WriteDetection(JsonWriter& json, const DetectionResult& detection);
+void WriteSysInfo(JsonWriter& json, const SysInfoResult& sysinfo);
+void WriteIMU(JsonWriter& json, const IMUResult& imu);
+
+/**
+* Json results writer of device
+*
+* DAI_JSON_BUFFERS buffers per device. The buffer of a returned string is held until DAIReleaseResult is called on it,
+* new results are written into a buffer not held by Unity, so a string being read is never overwritten.
+* If every buffer is held, results are discarded and EndJsonResults returns {"error":"RESULTS_NOT_RELEASED"}.
+*
+* @param deviceNum Device selection on unity dropdown
+* @returns cleared writer
+*/
+JsonWriter& BeginJsonResults(int deviceNum);
+
+/**
+* Finish json results of device started with BeginJsonResults
+*
+* @returns null terminated string. Owned by plugin, release with DAIReleaseResult
+*/
+const char* EndJsonResults(int deviceNum);
+
+/**
+* Json error string of results with error (NO_DEVICE, DEVICE_NOT_RUNNING)
+*
+* @returns null terminated string. Owned by plugin, release with DAIReleaseResult
+*/
+const char* ResultsErrorString(int deviceNum, const FrameResults& results);
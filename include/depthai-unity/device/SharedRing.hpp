@@ -0,0 +1,154 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+* Shared memory ring transport
+*
+* Named shared memory segment (POSIX shm, Windows file mapping) holding a single producer / single consumer ring of records.
+* Producer writes payload in place into the next free slot and commits it, consumer reads it in place and releases it:
+* no serialization, no copy and no syscall on the data path. Sleeping consumers are woken with a futex on Linux,
+* a named event on Windows. Other platforms poll.
+*
+* Layout (little endian), mirrored by unity_bridge/shared_ring.py. Increase DAI_SHARED_RING_VERSION on any change.
+*   header   DAI_SHARED_RING_HEADER bytes: SharedRingHeader
+*   slots    slotCount * (DAI_SHARED_RING_RECORD + slotSize) bytes: SharedRingRecord followed by payload
+*
+* Ring is lossless: producer gets no slot while ring is full. Consumer can skip to latest record.
+*/
+#define DAI_SHARED_RING_MAGIC 0x52494144 // "DAIR"
+#define DAI_SHARED_RING_VERSION 1
+#define DAI_SHARED_RING_HEADER 256
+#define DAI_SHARED_RING_RECORD 32
+
+// record types written by the plugin. Other producers use values >= SHARED_RING_USER
+enum SharedRingType
+{
+    SHARED_RING_RESULTS_BINARY = 1,   // FrameResults
+    SHARED_RING_RESULTS_JSON = 2,     // null terminated json results
+    SHARED_RING_FRAME = 3,            // SharedRingFrame followed by pixels
+    SHARED_RING_USER = 256,
+};
+
+struct SharedRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    // futex word, incremented on every commit
+    std::atomic<uint32_t> wake;
+    // consumers sleeping on wake. Producer skips the wakeup syscall if 0
+    std::atomic<uint32_t> waiters;
+    uint32_t pad0[10];
+    // records committed (producer cache line)
+    std::atomic<uint64_t> writeSeq;
+    uint64_t pad1[7];
+    // records released (consumer cache line)
+    std::atomic<uint64_t> readSeq;
+    uint64_t pad2[15];
+};
+
+struct SharedRingRecord
+{
+    uint64_t sequence;
+    uint32_t type;
+    uint32_t size;
+    // steady clock, microseconds
+    int64_t timestamp;
+    uint32_t reserved[2];
+};
+
+/**
+* Header of SHARED_RING_FRAME payload
+*/
+struct SharedRingFrame
+{
+    int32_t deviceNum;
+    int32_t width, height;
+    // OpenCV type (CV_8UC3, CV_16UC1, ...)
+    int32_t type;
+    int32_t step;
+    int32_t reserved[3];
+};
+
+class SharedRing
+{
+public:
+    /**
+    * Create (or replace) named ring. Producer side
+    *
+    * @param name segment name, without leading slash
+    * @param slotCount number of records in flight
+    * @param slotSize payload capacity of each record in bytes
+    * @returns ring or NULL if segment couldn't be created
+    */
+    static std::unique_ptr<SharedRing> create(const std::string& name, int slotCount, int slotSize);
+
+    /**
+    * Open existing named ring. Consumer side
+    *
+    * @returns ring or NULL if segment doesn't exist or layout doesn't match
+    */
+    static std::unique_ptr<SharedRing> open(const std::string& name);
+
+    ~SharedRing();
+
+    /**
+    * Next free slot, payload is written in place
+    *
+    * @param size payload size, at most slotSize
+    * @returns payload pointer or NULL if ring is full
+    */
+    void* acquireWrite(uint32_t size);
+
+    /**
+    * Publish slot returned by acquireWrite
+    */
+    void commitWrite(uint32_t type, uint32_t size);
+
+    /**
+    * Copy payload into next free slot
+    *
+    * @returns true if written, false if ring is full or payload too big
+    */
+    bool write(uint32_t type, const void* data, uint32_t size);
+
+    /**
+    * Oldest unread record, read in place
+    *
+    * @param timeoutMs wait for a record. 0: don't wait
+    * @param latest skip to latest record, older records are released
+    * @returns record (payload follows) or NULL on timeout
+    */
+    const SharedRingRecord* acquireRead(int timeoutMs, bool latest);
+
+    /**
+    * Release record returned by acquireRead. Its slot can be written again
+    */
+    void releaseRead();
+
+    uint32_t slotSize() const { return header->slotSize; }
+    const std::string& name() const { return segmentName; }
+
+private:
+    SharedRing() = default;
+    bool map(const std::string& name, size_t size, bool create);
+    SharedRingRecord* record(uint64_t sequence) const;
+    void wait(uint32_t wake, int timeoutMs);
+    void notify();
+
+    std::string segmentName;
+    bool owner = false;
+    size_t mappedSize = 0;
+    std::uint8_t* base = NULL;
+    SharedRingHeader* header = NULL;
+    // platform handles (file mapping and event on Windows, fd on POSIX)
+    void* mapping = NULL;
+    void* event = NULL;
+    int fd = -1;
+};
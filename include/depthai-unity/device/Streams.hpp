@@ -4,3 +4,15 @@
 #include <thread>
 #include "DeviceManager.hpp"
 
+/**
+* Output streams of streams pipeline (PipelineConfig streamMask, SetStreamsEnabled)
+*/
+enum StreamMask
+{
+    STREAM_PREVIEW = 1,
+    STREAM_DEPTH = 2,
+    STREAM_DISPARITY = 4,
+    STREAM_MONO_R = 8,
+    STREAM_MONO_L = 16,
+    STREAM_ALL = 31,
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "Results.hpp"
+
+/**
+* System information collector
+*
+* SystemInformation messages of the "sysinfo" stream (SystemLogger at PipelineConfig rate) are collected by a callback
+* on the device queue into a cached snapshot per device, so results calls never wait on the logger.
+* A short history is kept to correlate device load with host side frame drops (StreamStats).
+*/
+
+// snapshots kept per device (2 minutes at 1 hz)
+#define DAI_SYSINFO_HISTORY 120
+
+/**
+* One SystemInformation message. Mirrored on PredefinedBase.cs
+*/
+struct SysInfoSample
+{
+    // increases with every message since pipeline start, 0 if nothing received yet
+    int64_t version;
+    // host steady clock in microseconds, when message was received
+    int64_t timestamp;
+    // memory in MiB, leon css cpu usage in %
+    SysInfoResult info;
+    // leon mss cpu usage in %
+    float mssCpuUsage;
+    // chip temperature per sensor in celsius
+    float tempCss, tempMss, tempUpa, tempDss;
+};
+
+/**
+* Start collecting system information of device. Replaces previous collector on same deviceNum
+*
+* @param deviceNum Device selection on unity dropdown
+* @param queue "sysinfo" output queue, nothing is collected if nullptr
+*/
+void StartSysInfo(int deviceNum, std::shared_ptr<dai::DataOutputQueue> queue);
+
+/**
+* Stop collecting system information of device. Cached snapshot and history stay readable
+*
+* @param deviceNum Device selection on unity dropdown
+*/
+void StopSysInfo(int deviceNum);
+
+/**
+* Latest system information of device
+*
+* @param deviceNum Device selection on unity dropdown
+* @param sample latest snapshot. version is 0 if nothing was received yet
+* @returns false if nothing was received yet
+*/
+bool GetSysInfo(int deviceNum, SysInfoSample& sample);
+
+/**
+* System information history of device, oldest first
+*
+* @param deviceNum Device selection on unity dropdown
+* @param samples destination
+* @param maxSamples destination size. Newest samples are kept if there are more
+* @returns number of samples copied
+*/
+size_t GetSysInfoHistory(int deviceNum, SysInfoSample* samples, size_t maxSamples);
@@ -0,0 +1,43 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+/**
+* Pool of second stage input buffers
+*
+* Buffers are reused once device queues released them (only the pool holds a reference), so tensor data
+* keeps its capacity and preparing second stage inputs doesn't allocate after first frames.
+*/
+class TensorPool
+{
+public:
+    /**
+    * @returns buffer not referenced anywhere else. New buffer if all are still in flight
+    */
+    std::shared_ptr<dai::RawBuffer> acquire();
+
+private:
+    std::vector<std::shared_ptr<dai::RawBuffer>> buffers;
+};
+
+/**
+* Run second stage NN (XLinkIn -> NeuralNetwork -> XLinkOut) on several inputs
+*
+* All inputs are sent back-to-back so device pipelines inference and USB transfers, then replies are collected
+* and correlated by sequence number. Replies of previous calls (late or timed out) are discarded.
+*
+* @param in second stage input queue (p.eg "landm_in")
+* @param out second stage output queue (p.eg "landm_out")
+* @param tensors planar input tensors, one per ROI. sequenceNum is overwritten
+* @param timeout max wait for each reply
+* @returns results in same order as tensors. NULL entries for replies not received
+*/
+std::vector<std::shared_ptr<dai::NNData>> RunSecondStage(std::shared_ptr<dai::DataInputQueue> in, std::shared_ptr<dai::DataOutputQueue> out,
+                                                         const std::vector<std::shared_ptr<dai::RawBuffer>>& tensors,
+                                                         std::chrono::milliseconds timeout = std::chrono::milliseconds(500));
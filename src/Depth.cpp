@@ -10,17 +10,21 @@
 // ------------------------------------------------------------------------
 // Plugin itself
 
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <random>
 
 #include "utility.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 // Inludes common necessary includes for development using depthai library
 #include "depthai/depthai.hpp"
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/Depth.hpp"
+#include "depthai-unity/device/DeviceNum.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
@@ -28,119 +32,319 @@
 #include "nlohmann/json.hpp"
 
 
-float calc_angle(float offset)
+// Mono HFOV (73.5) used when device has no calibration
+static const float defaultHFOV = 1.282817f;
+
+// Spatial engine per device (same indexing as devices)
+static SpatialEngine spatialEngines[DAI_MAX_DEVICES];
+
+// Locations of last SpatialLocationCalculator reply matching ROIs sent, per device
+static std::vector<dai::SpatialLocations> spatialReplies[DAI_MAX_DEVICES];
+
+SpatialEngine& GetSpatialEngine(int deviceNum)
 {
-    float ret;
-    float hfov = 1.282817f; // 73.5 Mono HFOV
-    float depthWidth = 1280.0f; //640.0f //1280.0f;   // 1,3  2,3
+    return spatialEngines[deviceNum];
+}
 
-    ret = atan(tan(hfov / 2.0) * offset / (depthWidth / 2.0));
-    return ret;
+void InitSpatialEngine(int deviceNum, std::shared_ptr<dai::Device> device, bool alignedToRGB)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    try
+    {
+        spatialEngines[deviceNum].setCalibration(device->readCalibration(), alignedToRGB ? dai::CameraBoardSocket::RGB : dai::CameraBoardSocket::RIGHT);
+    }
+    catch (const std::exception&)
+    {
+        // no calibration on device, engine uses default HFOV
+    }
 }
 
-float calc_angle2(float offset,float width)
+void SpatialEngine::setCalibration(const dai::CalibrationHandler& calibration, dai::CameraBoardSocket socket)
 {
-    float ret;
-    float hfov = 1.282817f; // 73.5 Mono HFOV
-    float depthWidth = width; //1280.0f;   // 1,3  2,3
+    this->calibration = calibration;
+    this->socket = socket;
+    calibrated = true;
 
-    ret = atan(tan(hfov / 2.0) * offset / (depthWidth / 2.0));
-    return ret;
+    // force tangent tables update
+    tanWidth = tanHeight = 0;
 }
 
-/**
-* Compute spatial info
-*
-* @param depthFrame depth frame
-* @param rois vector of regions of interest to compute depth
-* @param mode compute average or min depth of roi. 0: average, 1: min
-* @param depth_thresh_low depth minimum threshold
-* @param depth_thresh_high depth maximum threshold
-* @return vector of spatial locations
-*/
+void SpatialEngine::updateTangents(int width, int height)
+{
+    if (width == tanWidth && height == tanHeight) return;
 
-std::vector<dai::SpatialLocations> getSpatialInfo1(cv::Mat depthFrame, std::vector<dai::SpatialLocationCalculatorConfigData> rois, int mode, float depth_thresh_low, float depth_thresh_high)
+    float fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
+    bool valid = false;
+
+    // intrinsics scaled to depth resolution
+    if (calibrated)
+    {
+        try
+        {
+            auto intrinsics = calibration.getCameraIntrinsics(socket, width, height);
+            fx = intrinsics[0][0];
+            fy = intrinsics[1][1];
+            cx = intrinsics[0][2];
+            cy = intrinsics[1][2];
+            valid = fx > 0.0f && fy > 0.0f;
+        }
+        catch (const std::exception&)
+        {
+            valid = false;
+        }
+    }
+
+    if (!valid)
+    {
+        fx = fy = (width / 2.0f) / tan(defaultHFOV / 2.0f);
+        cx = width / 2.0f;
+        cy = height / 2.0f;
+    }
+
+    tanX.resize(width);
+    tanY.resize(height);
+    for (int x = 0; x < width; x++) tanX[x] = (x - cx) / fx;
+    for (int y = 0; y < height; y++) tanY[y] = (y - cy) / fy;
+
+    tanWidth = width;
+    tanHeight = height;
+}
+
+void SpatialEngine::update(const cv::Mat& depthFrame, float depth_thresh_low, float depth_thresh_high)
 {
-    std::vector<dai::SpatialLocations> spatialData;
-    for (int i=0; i<(int)rois.size(); i++)
+    depth = depthFrame;
+    low = depth_thresh_low;
+    high = depth_thresh_high;
+    if (depth.empty() || depth.type() != CV_16UC1) return;
+
+    updateTangents(depth.cols, depth.rows);
+
+    // summed-area tables of valid depth and valid count. Row 0 and column 0 are zero
+    int w = depth.cols, h = depth.rows;
+    size_t stride = w + 1;
+    sums.resize(stride * (h + 1));
+    counts.resize(stride * (h + 1));
+    std::fill(sums.begin(), sums.begin() + stride, 0.0);
+    std::fill(counts.begin(), counts.begin() + stride, 0);
+
+    for (int y = 0; y < h; y++)
     {
-        dai::SpatialLocations loc;
-        loc.config.roi = rois[i].roi;
+        const unsigned short* row = depth.ptr<unsigned short>(y);
+        const double* sumAbove = &sums[y * stride];
+        const int* countAbove = &counts[y * stride];
+        double* sumRow = &sums[(y + 1) * stride];
+        int* countRow = &counts[(y + 1) * stride];
+
+        double rowSum = 0.0;
+        int rowCount = 0;
+        sumRow[0] = 0.0;
+        countRow[0] = 0;
+        for (int x = 0; x < w; x++)
+        {
+            unsigned short d = row[x];
+            if (depth_thresh_low < d && d < depth_thresh_high)
+            {
+                rowSum += d;
+                rowCount++;
+            }
+            sumRow[x + 1] = sumAbove[x + 1] + rowSum;
+            countRow[x + 1] = countAbove[x + 1] + rowCount;
+        }
+    }
+}
 
-        auto myroi = rois[i].roi;
-        myroi = myroi.denormalize(depthFrame.cols, depthFrame.rows);
-
-        auto xmin = (int)myroi.topLeft().x;
-        auto ymin = (int)myroi.topLeft().y;
-        auto xmax = (int)myroi.bottomRight().x;
-        auto ymax = (int)myroi.bottomRight().y;
-
-        float cnt = 0.0;
-        float sum = 0.0;
-        int xMinPos = -1, yMinPos = -1;
-        unsigned short minDepth = 50000;
-        unsigned short finalDepth;
-
-        if (xmin >= 1280) xmin = 1279;
-        if (xmax >= 1280) xmax = 1279;
-        if (ymin >= 720) ymin = 719;
-        if (ymax >= 720) ymax = 719;
-        
-        if (ymin < 0) ymin = 0;
-        if (xmin < 0) xmin = 0;
-        if (xmax < 0) xmax = 0;
-        if (ymax < 0) ymax = 0;
-        
-        for (int x = xmin; x<xmax; x++)
+void SpatialEngine::gather(int xmin, int ymin, int xmax, int ymax)
+{
+    values.clear();
+    if (xmax <= xmin || ymax <= ymin) return;
+    values.resize((size_t)(xmax - xmin) * (ymax - ymin));
+
+    unsigned short lo = (unsigned short) std::min(std::max(low + 1.0f, 0.0f), 65535.0f);
+    unsigned short hi = (unsigned short) std::min(std::max(high - 1.0f, 0.0f), 65535.0f);
+    unsigned short* dst = values.data();
+    size_t n = 0;
+
+    for (int y = ymin; y < ymax; y++)
+    {
+        const unsigned short* row = depth.ptr<unsigned short>(y);
+        int x = xmin;
+
+#if CV_SIMD128
+        // blocks of 8 pixels fully inside thresholds are stored at once, others are filtered per pixel
+        if (cv::useOptimized())
         {
-            for (int y=ymin; y<ymax; y++)
+            cv::v_uint16x8 vlo = cv::v_setall_u16(lo), vhi = cv::v_setall_u16(hi);
+            for (; x <= xmax - 8; x += 8)
             {
-                unsigned short depthPixel;
-                
-                depthPixel = depthFrame.at<unsigned short>(cv::Point(x,y));
-                if (depth_thresh_low < depthPixel && depthPixel < depth_thresh_high)
+                cv::v_uint16x8 d = cv::v_load(row + x);
+                cv::v_uint16x8 inside = (d >= vlo) & (d <= vhi);
+                if (cv::v_check_all(inside))
                 {
-                    cnt++;
-                    sum += depthPixel;
-                    if (depthPixel < minDepth)
+                    cv::v_store(dst + n, d);
+                    n += 8;
+                }
+                else if (cv::v_check_any(inside))
+                {
+                    for (int k = x; k < x + 8; k++)
                     {
-                        xMinPos = x;
-                        yMinPos = y;
-                        minDepth = depthPixel;
+                        unsigned short v = row[k];
+                        if (v >= lo && v <= hi) dst[n++] = v;
                     }
                 }
             }
         }
+#endif
+
+        for (; x < xmax; x++)
+        {
+            unsigned short v = row[x];
+            if (v >= lo && v <= hi) dst[n++] = v;
+        }
+    }
+
+    values.resize(n);
+}
+
+std::vector<dai::SpatialLocations> SpatialEngine::compute(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, int mode)
+{
+    if (mode == 1) return compute(rois, dai::SpatialLocationCalculatorAlgorithm::MIN, -1.0f);
+    return compute(rois, dai::SpatialLocationCalculatorAlgorithm::AVERAGE, -1.0f);
+}
+
+std::vector<dai::SpatialLocations> SpatialEngine::compute(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, dai::SpatialLocationCalculatorAlgorithm algorithm)
+{
+    return compute(rois, algorithm, -1.0f);
+}
+
+std::vector<dai::SpatialLocations> SpatialEngine::computePercentile(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, float percentile)
+{
+    return compute(rois, dai::SpatialLocationCalculatorAlgorithm::MEDIAN, std::min(std::max(percentile, 0.0f), 100.0f));
+}
+
+std::vector<dai::SpatialLocations> SpatialEngine::compute(const std::vector<dai::SpatialLocationCalculatorConfigData>& rois, dai::SpatialLocationCalculatorAlgorithm algorithm, float percentile)
+{
+    using Algorithm = dai::SpatialLocationCalculatorAlgorithm;
+
+    std::vector<dai::SpatialLocations> spatialData;
+    spatialData.reserve(rois.size());
+
+    int w = depth.cols, h = depth.rows;
+    size_t stride = w + 1;
+
+    // median is 50th percentile
+    if (percentile < 0.0f && algorithm == Algorithm::MEDIAN) percentile = 50.0f;
+
+    for (int i=0; i<(int)rois.size(); i++)
+    {
+        dai::SpatialLocations loc;
+        loc.config.roi = rois[i].roi;
+
+        if (depth.empty() || depth.type() != CV_16UC1)
+        {
+            spatialData.push_back(loc);
+            continue;
+        }
+
+        auto myroi = rois[i].roi;
+        myroi = myroi.denormalize(w, h);
+
+        // clamp to frame, [xmin,xmax) x [ymin,ymax)
+        int xmin = std::min(std::max((int)myroi.topLeft().x, 0), w - 1);
+        int ymin = std::min(std::max((int)myroi.topLeft().y, 0), h - 1);
+        int xmax = std::min(std::max((int)myroi.bottomRight().x, 0), w - 1);
+        int ymax = std::min(std::max((int)myroi.bottomRight().y, 0), h - 1);
+
+        float finalDepth = 0.0f;
 
-        if (mode == 0)
+        if (percentile >= 0.0f)
         {
-            if (cnt > 0) finalDepth = sum / cnt;
-            else 
+            // nth_element on valid values
+            gather(xmin, ymin, xmax, ymax);
+            if (!values.empty())
             {
-                finalDepth = 0;
+                size_t nth = (size_t)(percentile / 100.0f * (values.size() - 1) + 0.5f);
+                std::nth_element(values.begin(), values.begin() + nth, values.end());
+                finalDepth = values[nth];
             }
         }
-
-        if (mode == 1) finalDepth = minDepth;
+        else if (algorithm == Algorithm::AVERAGE)
+        {
+            // O(1) mean from summed-area tables
+            int cnt = 0;
+            double sum = 0.0;
+            if (xmax > xmin && ymax > ymin)
+            {
+                cnt = counts[ymax * stride + xmax] - counts[ymin * stride + xmax] - counts[ymax * stride + xmin] + counts[ymin * stride + xmin];
+                sum = sums[ymax * stride + xmax] - sums[ymin * stride + xmax] - sums[ymax * stride + xmin] + sums[ymin * stride + xmin];
+            }
+            if (cnt > 0) finalDepth = (unsigned short)(sum / cnt);
+        }
+        else if (algorithm == Algorithm::MIN)
+        {
+            gather(xmin, ymin, xmax, ymax);
+            unsigned short minDepth = 50000;
+            for (unsigned short d : values) if (d < minDepth) minDepth = d;
+            finalDepth = minDepth;
+        }
+        else if (algorithm == Algorithm::MAX)
+        {
+            gather(xmin, ymin, xmax, ymax);
+            unsigned short maxDepth = 0;
+            for (unsigned short d : values) if (d > maxDepth) maxDepth = d;
+            finalDepth = maxDepth;
+        }
+        else if (algorithm == Algorithm::MODE)
+        {
+            // 16 bit histogram, only touched bins are reset
+            gather(xmin, ymin, xmax, ymax);
+            if (histogram.empty()) histogram.assign(65536, 0);
+            unsigned int best = 0;
+            unsigned short modeDepth = 0;
+            for (unsigned short d : values)
+            {
+                unsigned int c = ++histogram[d];
+                if (c > best || (c == best && d < modeDepth))
+                {
+                    best = c;
+                    modeDepth = d;
+                }
+            }
+            for (unsigned short d : values) histogram[d] = 0;
+            finalDepth = modeDepth;
+        }
 
         auto xmid = (xmax - xmin) / 2 + xmin;
         auto ymid = (ymax - ymin) / 2 + ymin;
-        auto dmidx = 1280/2;
-        auto dmidy = 720/2;
-        auto bb_x_pos = xmid - dmidx;
-        auto bb_y_pos = ymid - dmidy;
-        auto angle_x = calc_angle(bb_x_pos);
-        auto angle_y = calc_angle(bb_y_pos);
 
         loc.spatialCoordinates.z = finalDepth;
-        loc.spatialCoordinates.x = finalDepth * tan(angle_x);
-        loc.spatialCoordinates.y = -finalDepth * tan(angle_y);
+        loc.spatialCoordinates.x = finalDepth * tanX[xmid];
+        loc.spatialCoordinates.y = -finalDepth * tanY[ymid];
 
-         spatialData.push_back(loc);
+        spatialData.push_back(loc);
     }
     return spatialData;
 }
 
+/**
+* Compute spatial info
+*
+* @param depthFrame depth frame
+* @param rois vector of regions of interest to compute depth
+* @param mode compute average or min depth of roi. 0: average, 1: min
+* @param depth_thresh_low depth minimum threshold
+* @param depth_thresh_high depth maximum threshold
+* @return vector of spatial locations
+*/
+
+std::vector<dai::SpatialLocations> getSpatialInfo1(cv::Mat depthFrame, std::vector<dai::SpatialLocationCalculatorConfigData> rois, int mode, float depth_thresh_low, float depth_thresh_high)
+{
+    // no device calibration: default HFOV at actual depth resolution
+    static thread_local SpatialEngine engine;
+    engine.update(depthFrame, depth_thresh_low, depth_thresh_high);
+    return engine.compute(rois, mode);
+}
+
 /**
 * Compute 3D position of ROI around image point (mx,my) using depth image
 * Similar to spatialLocation node
@@ -151,23 +355,35 @@ std::vector<dai::SpatialLocations> getSpatialInfo1(cv::Mat depthFrame, std::vect
 * @param depthFrameOrig depth frame
 * @return vector of spatial locations
 *
-* @todo Replace and use proper spatial location node. Remove hardcoded values. 
+* @todo Replace and use proper spatial location node.
 */
 std::vector<dai::SpatialLocations> computeDepth(float mx, float my, int frameRows, cv::Mat depthFrameOrig)
+{
+    static thread_local SpatialEngine engine;
+    engine.update(depthFrameOrig, 100, 50000);
+    return computeDepth(engine, mx, my, frameRows, dai::SpatialLocationCalculatorAlgorithm::AVERAGE);
+}
+
+std::vector<dai::SpatialLocations> computeDepth(SpatialEngine& engine, float mx, float my, int frameRows, dai::SpatialLocationCalculatorAlgorithm algorithm)
 {
     std::vector<dai::SpatialLocationCalculatorConfigData> rois;
 
-    float ratio = 720.0f / frameRows;
-    cv::Point point3 = cv::Point(mx * ratio + (1280/2 - 720/2), my * ratio);
+    float depthWidth = (float)engine.width();
+    float depthHeight = (float)engine.height();
+    if (depthWidth <= 0.0f || depthHeight <= 0.0f) return {};
+
+    // square preview is center crop of depth frame
+    float ratio = depthHeight / frameRows;
+    cv::Point point3 = cv::Point(mx * ratio + (depthWidth/2 - depthHeight/2), my * ratio);
 
     float roi_size = 0.02;
-    float tlx = (point3.x/1280.0f)-roi_size;
-    float tly = (point3.y/720.0f)-roi_size;
+    float tlx = (point3.x/depthWidth)-roi_size;
+    float tly = (point3.y/depthHeight)-roi_size;
     if (tlx <= 0.0f) tlx = 0.01f;
     if (tly <= 0.0f) tly = 0.01f;
 
-    float brx = (point3.x/1280.0f)+roi_size;
-    float bry = (point3.y/720.0f)+roi_size;
+    float brx = (point3.x/depthWidth)+roi_size;
+    float bry = (point3.y/depthHeight)+roi_size;
 
     if (brx >= 1.0f) brx = 0.99f;
     if (bry >= 1.0f) bry = 0.99f;
@@ -180,7 +396,7 @@ std::vector<dai::SpatialLocations> computeDepth(float mx, float my, int frameRow
 
     rois.push_back(config);
 
-    return getSpatialInfo1(depthFrameOrig,rois,0,100,50000);
+    return engine.compute(rois, algorithm);
 }
 
 /**
@@ -191,7 +407,7 @@ std::vector<dai::SpatialLocations> computeDepth(float mx, float my, int frameRow
 * @param frame rgb frame
 * @param mx x-axis position
 * @param my y-axis position
-* @param mode 0: crop, 1: letterbox
+* @param mode 0: crop, 1: letterbox, 2: resize (same field of view)
 * @return mapped rect from rgb to depth
 *
 */
@@ -218,6 +434,12 @@ dai::Rect prepareComputeDepth(cv::Mat depthFrame, cv::Mat frame, float mx, float
         point3 = cv::Point(((float)mx / frame.cols)* (float)depthFrame.cols, yadjusted * (float)depthFrame.rows);
     }
 
+    // frame resized from full field of view, same as depth
+    if (mode == 2)
+    {
+        point3 = cv::Point(((float)mx / frame.cols) * (float)depthFrame.cols, ((float)my / frame.rows) * (float)depthFrame.rows);
+    }
+
     float roi_size = 0.02;
     float tlx = (point3.x/(float)depthFrame.cols)-roi_size;
     float tly = (point3.y/(float)depthFrame.rows)-roi_size;
@@ -235,3 +457,44 @@ dai::Rect prepareComputeDepth(cv::Mat depthFrame, cv::Mat frame, float mx, float
 
     return dai::Rect(topLeft, bottomRight);
 }
+
+// reply locations were computed for rois (normalized rects survive serialization, small tolerance only)
+static bool sameROIs(const std::vector<dai::SpatialLocations>& locations, const std::vector<dai::SpatialLocationCalculatorConfigData>& rois)
+{
+    if (locations.size() != rois.size()) return false;
+    for (size_t i = 0; i < rois.size(); i++)
+    {
+        const dai::Rect& a = locations[i].config.roi;
+        const dai::Rect& b = rois[i].roi;
+        if (std::abs(a.x - b.x) > 1e-4f || std::abs(a.y - b.y) > 1e-4f || std::abs(a.width - b.width) > 1e-4f || std::abs(a.height - b.height) > 1e-4f) return false;
+    }
+    return true;
+}
+
+bool getSpatialReply(int deviceNum, const dai::SpatialLocationCalculatorConfig& cfg, std::vector<dai::SpatialLocations>& spatialData)
+{
+    spatialData.clear();
+    if (!ValidDeviceNum(deviceNum)) return false;
+
+    std::vector<dai::SpatialLocationCalculatorConfigData> rois = cfg.getConfigData();
+    std::vector<dai::SpatialLocations>& matched = spatialReplies[deviceNum];
+
+    // latest reply kept by acquisition thread, computed for these ROIs if they didn't change since previous call
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    AcquiredMessage* acquired = GetAcquired(acquisition, "spatialData");
+    std::shared_ptr<dai::SpatialLocationCalculatorData> reply = acquired ? acquired->get<dai::SpatialLocationCalculatorData>() : nullptr;
+    if (reply)
+    {
+        std::vector<dai::SpatialLocations> locations = reply->getSpatialLocations();
+        if (sameROIs(locations, rois))
+        {
+            matched = locations;
+            spatialData = matched;
+            return true;
+        }
+    }
+
+    // reply for new ROIs not there yet, last matched one if it can be paired by index
+    if (matched.size() == rois.size()) spatialData = matched;
+    return false;
+}
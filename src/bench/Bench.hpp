@@ -0,0 +1,64 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+* Timing helpers of depthai-unity-bench
+*
+* Every case runs a few warmup iterations, then is timed per iteration. Median and min are reported in microseconds,
+* with speedup against a baseline case (previous implementation) when given.
+*/
+#define DAI_BENCH_WARMUP 3
+
+struct BenchOptions
+{
+    int iterations = 50;
+    // recorded MJPEG bitstream for decode benchmark, synthetic frames if empty
+    std::string mjpeg;
+};
+
+struct BenchResult
+{
+    double medianUs = 0.0;
+    double minUs = 0.0;
+};
+
+inline BenchResult measure(int iterations, const std::function<void()>& fn)
+{
+    for (int i = 0; i < DAI_BENCH_WARMUP; i++) fn();
+
+    std::vector<double> times;
+    for (int i = 0; i < std::max(iterations, 1); i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    BenchResult r;
+    r.medianUs = times[times.size() / 2];
+    r.minUs = times.front();
+    return r;
+}
+
+inline void report(const std::string& name, const BenchResult& r, const BenchResult* baseline = nullptr)
+{
+    if (baseline != nullptr && r.medianUs > 0.0) printf("  %-44s median %10.1f us  min %10.1f us  x%.2f\n", name.c_str(), r.medianUs, r.minUs, baseline->medianUs / r.medianUs);
+    else printf("  %-44s median %10.1f us  min %10.1f us\n", name.c_str(), r.medianUs, r.minUs);
+}
+
+/**
+* Benchmarks, return 0 on success (outputs of optimized paths are checked against reference paths)
+*/
+int ConvertBench(const BenchOptions& options);
+int JsonBench(const BenchOptions& options);
+int RingBench(const BenchOptions& options);
+int PointCloudBench(const BenchOptions& options);
+int DecodeBench(const BenchOptions& options);
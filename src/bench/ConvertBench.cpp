@@ -0,0 +1,172 @@
+// ------------------------------------------------------------------------
+// toMat / toARGB conversion benchmark
+//
+// Every layout is timed with the previous implementation (copied below as reference), then with current code on the
+// scalar path (cv::setUseOptimized(false)) and the SIMD path (cv::setUseOptimized(true)). Scalar and SIMD outputs must match.
+
+#include <cstring>
+#include <random>
+
+#include "opencv2/opencv.hpp"
+#include "fp16/fp16.h"
+
+#include "../utility.hpp"
+#include "Bench.hpp"
+
+// previous toMat: planar U8 in three passes, interleaved RGB per pixel through at<Vec3b>
+static cv::Mat legacyToMat(const std::vector<uint8_t>& data, int w, int h, int numPlanes, int bpp)
+{
+    cv::Mat frame;
+
+    if (numPlanes == 3)
+    {
+        frame = cv::Mat(h, w, CV_8UC3);
+        for (int i = 0; i < w*h; i++) frame.data[i*3+0] = data.data()[i + w*h * 0];
+        for (int i = 0; i < w*h; i++) frame.data[i*3+1] = data.data()[i + w*h * 1];
+        for (int i = 0; i < w*h; i++) frame.data[i*3+2] = data.data()[i + w*h * 2];
+    }
+    else if (bpp == 3)
+    {
+        frame = cv::Mat(h, w, CV_8UC3);
+        for (int i = 0; i < w*h*bpp; i += 3)
+        {
+            uint8_t b = data.data()[i + 2];
+            uint8_t g = data.data()[i + 1];
+            uint8_t r = data.data()[i + 0];
+            frame.at<cv::Vec3b>((i/bpp) / w, (i/bpp) % w) = cv::Vec3b(b, g, r);
+        }
+    }
+    else if (bpp == 6)
+    {
+        frame = cv::Mat(h, w, CV_8UC3);
+        for (int y = 0; y < h; y++)
+        {
+            for (int x = 0; x < w; x++)
+            {
+                const uint16_t* fp16 = (const uint16_t*) (data.data() + (y*w+x)*bpp);
+                uint8_t r = (uint8_t) (fp16_ieee_to_fp32_value(fp16[0]) * 255.0f);
+                uint8_t g = (uint8_t) (fp16_ieee_to_fp32_value(fp16[1]) * 255.0f);
+                uint8_t b = (uint8_t) (fp16_ieee_to_fp32_value(fp16[2]) * 255.0f);
+                frame.at<cv::Vec3b>(y, x) = cv::Vec3b(b, g, r);
+            }
+        }
+    }
+
+    return frame;
+}
+
+// planar FP16 had no previous path (handled as planar U8), reference is the per pixel half -> float loop of interleaved FP16
+static cv::Mat legacyPlanarFP16ToMat(const std::vector<uint8_t>& data, int w, int h)
+{
+    cv::Mat frame(h, w, CV_8UC3);
+    const uint16_t* fp16 = (const uint16_t*) data.data();
+    for (int i = 0; i < w*h; i++)
+    {
+        for (int c = 0; c < 3; c++) frame.data[i*3+c] = (uint8_t) (fp16_ieee_to_fp32_value(fp16[i + w*h*c]) * 255.0f);
+    }
+    return frame;
+}
+
+// previous toARGB: color conversion to new image, split into planes (unused), copy
+static void legacyToARGB(const cv::Mat& input, void* ptr)
+{
+    cv::Mat argb_img;
+    cv::cvtColor(input, argb_img, cv::COLOR_RGB2BGRA);
+    std::vector<cv::Mat> bgra;
+    cv::split(argb_img, bgra);
+    std::swap(bgra[0], bgra[3]);
+    std::swap(bgra[1], bgra[2]);
+
+    std::memcpy(ptr, argb_img.data, argb_img.total() * argb_img.elemSize());
+}
+
+static BenchResult measureOptimized(bool optimized, int iterations, const std::function<void()>& fn)
+{
+    cv::setUseOptimized(optimized);
+    BenchResult r = measure(iterations, fn);
+    cv::setUseOptimized(true);
+    return r;
+}
+
+static bool sameMat(const cv::Mat& a, const cv::Mat& b)
+{
+    return a.size() == b.size() && a.type() == b.type() && std::memcmp(a.data, b.data, a.total() * a.elemSize()) == 0;
+}
+
+// time one toMat layout: reference, scalar, SIMD. Returns false if scalar and SIMD outputs differ
+static bool benchToMat(const char* name, const std::vector<uint8_t>& data, int w, int h, int numPlanes, int bpp,
+                       const std::function<cv::Mat()>& legacy, bool sameAsLegacy, const BenchOptions& options)
+{
+    printf(" %s\n", name);
+
+    cv::Mat reference;
+    BenchResult base = measure(options.iterations, [&]() { reference = legacy(); });
+    report("previous", base);
+
+    cv::Mat scalar, simd;
+    BenchResult rs = measureOptimized(false, options.iterations, [&]() { toMat(data, w, h, numPlanes, bpp, scalar); });
+    report("toMat scalar", rs, &base);
+    BenchResult rv = measureOptimized(true, options.iterations, [&]() { toMat(data, w, h, numPlanes, bpp, simd); });
+    report("toMat SIMD", rv, &base);
+
+    bool ok = sameMat(scalar, simd) && (!sameAsLegacy || sameMat(reference, simd));
+    if (!ok) printf("  MISMATCH\n");
+    return ok;
+}
+
+// time one toARGB source. Returns false if scalar and SIMD outputs differ
+static bool benchToARGB(const char* name, const cv::Mat& input, bool hasLegacy, const BenchOptions& options)
+{
+    printf(" %s\n", name);
+
+    std::vector<uint8_t> reference(input.total() * 4), scalar(input.total() * 4), simd(input.total() * 4);
+    BenchResult base;
+    if (hasLegacy)
+    {
+        base = measure(options.iterations, [&]() { legacyToARGB(input, reference.data()); });
+        report("previous", base);
+    }
+
+    BenchResult rs = measureOptimized(false, options.iterations, [&]() { toARGB(input, scalar.data()); });
+    report("toARGB scalar", rs, hasLegacy ? &base : nullptr);
+    BenchResult rv = measureOptimized(true, options.iterations, [&]() { toARGB(input, simd.data()); });
+    report("toARGB SIMD", rv, hasLegacy ? &base : &rs);
+
+    bool ok = scalar == simd && (!hasLegacy || reference == simd);
+    if (!ok) printf("  MISMATCH\n");
+    return ok;
+}
+
+int ConvertBench(const BenchOptions& options)
+{
+    const cv::Size sizes[] = { cv::Size(300, 300), cv::Size(1920, 1080), cv::Size(3840, 2160) };
+    std::mt19937 rng(42);
+    bool ok = true;
+
+    for (const auto& size : sizes)
+    {
+        int w = size.width, h = size.height;
+        size_t total = (size_t)w * h;
+        printf("convert %dx%d\n", w, h);
+
+        std::vector<uint8_t> u8(total * 3);
+        for (auto& v : u8) v = (uint8_t) rng();
+
+        // fp16 normalized [0,1], same values as u8 frame
+        std::vector<uint8_t> fp16(total * 3 * 2);
+        uint16_t* half = (uint16_t*) fp16.data();
+        for (size_t i = 0; i < total * 3; i++) half[i] = fp16_ieee_from_fp32_value(u8[i] / 255.0f);
+
+        ok &= benchToMat("planar U8 (BGR888p)", u8, w, h, 3, 1, [&]() { return legacyToMat(u8, w, h, 3, 1); }, true, options);
+        ok &= benchToMat("interleaved U8 (RGB888i)", u8, w, h, 1, 3, [&]() { return legacyToMat(u8, w, h, 1, 3); }, true, options);
+        ok &= benchToMat("planar FP16", fp16, w, h, 3, 2, [&]() { return legacyPlanarFP16ToMat(fp16, w, h); }, false, options);
+        ok &= benchToMat("interleaved FP16 (RGBF16F16F16i)", fp16, w, h, 1, 6, [&]() { return legacyToMat(fp16, w, h, 1, 6); }, false, options);
+
+        cv::Mat bgr(h, w, CV_8UC3, u8.data());
+        ok &= benchToARGB("toARGB BGR", bgr, true, options);
+        cv::Mat depth(h, w, CV_16UC1, fp16.data());
+        ok &= benchToARGB("toARGB GRAY16", depth, false, options);
+    }
+
+    return ok ? 0 : 1;
+}
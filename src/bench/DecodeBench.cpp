@@ -0,0 +1,121 @@
+// ------------------------------------------------------------------------
+// MJPEG encoded transport benchmark
+//
+// Host decode as done by acquisition thread (cv::imdecode into a reused buffer) against decoding into a new image, with
+// bitstream size and link bandwidth at DAI_BENCH_DECODE_FPS against raw frames. Synthetic frames are JPEG encoded on host
+// with the default encoderQuality of streams pipelines. With --mjpeg, frames of a recorded bitstream (concatenated JPEGs,
+// e.g. "preview" output of an encoded pipeline saved to file) are decoded instead.
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "Bench.hpp"
+
+#define DAI_BENCH_DECODE_FPS 30
+#define DAI_BENCH_DECODE_QUALITY 80
+
+// smooth gradient and noise, compresses like a camera frame rather than a flat image
+static cv::Mat syntheticFrame(int w, int h, int type, std::mt19937& rng)
+{
+    cv::Mat frame(h, w, type);
+    int channels = type == CV_8UC3 ? 3 : 1;
+    for (int y = 0; y < h; y++)
+    {
+        std::uint8_t* row = frame.ptr<std::uint8_t>(y);
+        for (int x = 0; x < w * channels; x++) row[x] = (std::uint8_t)(((x / channels) * 255 / w + y * 255 / h) / 2 + rng() % 16);
+    }
+    return frame;
+}
+
+// split recorded MJPEG bitstream on JPEG start markers (FF D8 FF)
+static std::vector<std::vector<std::uint8_t>> splitMJPEG(const std::vector<std::uint8_t>& data)
+{
+    std::vector<std::vector<std::uint8_t>> frames;
+    size_t start = std::string::npos;
+    for (size_t i = 0; i + 2 < data.size(); i++)
+    {
+        if (data[i] != 0xFF || data[i + 1] != 0xD8 || data[i + 2] != 0xFF) continue;
+        if (start != std::string::npos) frames.emplace_back(data.begin() + start, data.begin() + i);
+        start = i;
+    }
+    if (start != std::string::npos) frames.emplace_back(data.begin() + start, data.end());
+    return frames;
+}
+
+// time decode of bitstreams (cycled), reused buffer and new image. Returns false if a frame doesn't decode
+static bool benchDecode(const char* name, const std::vector<std::vector<std::uint8_t>>& bitstreams, const BenchOptions& options)
+{
+    printf(" %s\n", name);
+
+    size_t next = 0;
+    cv::Mat buffer;
+    bool ok = true;
+    auto decodeReused = [&]() {
+        const std::vector<std::uint8_t>& data = bitstreams[next++ % bitstreams.size()];
+        if (cv::imdecode(cv::Mat(1, (int)data.size(), CV_8UC1, (void*)data.data()), cv::IMREAD_UNCHANGED, &buffer).empty()) ok = false;
+    };
+    auto decodeNew = [&]() {
+        const std::vector<std::uint8_t>& data = bitstreams[next++ % bitstreams.size()];
+        if (cv::imdecode(data, cv::IMREAD_UNCHANGED).empty()) ok = false;
+    };
+
+    BenchResult rn = measure(options.iterations, decodeNew);
+    report("imdecode new image", rn);
+    BenchResult rr = measure(options.iterations, decodeReused);
+    report("imdecode reused buffer", rr, &rn);
+
+    size_t encoded = 0;
+    for (const auto& data : bitstreams) encoded += data.size();
+    double frameBytes = encoded / (double)bitstreams.size();
+    double rawBytes = buffer.empty() ? 0.0 : (double)buffer.total() * buffer.elemSize();
+    printf("  %-44s %dx%d, %.1f KB/frame (raw %.1f KB, x%.1f)\n", "bitstream", buffer.cols, buffer.rows, frameBytes / 1024.0,
+           rawBytes / 1024.0, frameBytes > 0.0 ? rawBytes / frameBytes : 0.0);
+    char link[64];
+    snprintf(link, sizeof(link), "link @ %d fps", DAI_BENCH_DECODE_FPS);
+    printf("  %-44s %.1f Mbit/s (raw %.1f Mbit/s)\n", link, frameBytes * 8 * DAI_BENCH_DECODE_FPS / 1e6, rawBytes * 8 * DAI_BENCH_DECODE_FPS / 1e6);
+
+    if (!ok) printf("  DECODE FAILED\n");
+    return ok;
+}
+
+int DecodeBench(const BenchOptions& options)
+{
+    if (!options.mjpeg.empty())
+    {
+        std::ifstream file(options.mjpeg, std::ios::binary);
+        std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<std::vector<std::uint8_t>> frames = splitMJPEG(data);
+        printf("decode %s, %zu frames\n", options.mjpeg.c_str(), frames.size());
+        if (frames.empty()) return 1;
+        return benchDecode("recorded MJPEG", frames, options) ? 0 : 1;
+    }
+
+    struct DecodeCase
+    {
+        const char* name;
+        int width, height, type;
+    };
+    const DecodeCase cases[] = {
+        { "preview 640x360 BGR", 640, 360, CV_8UC3 },
+        { "preview 1920x1080 BGR", 1920, 1080, CV_8UC3 },
+        { "mono 1280x800 GRAY", 1280, 800, CV_8UC1 },
+    };
+
+    std::mt19937 rng(42);
+    bool ok = true;
+    printf("decode synthetic MJPEG, quality %d\n", DAI_BENCH_DECODE_QUALITY);
+    for (const auto& c : cases)
+    {
+        // a few different frames cycled, closer to a live stream than one repeated bitstream
+        std::vector<std::vector<std::uint8_t>> bitstreams(4);
+        for (auto& data : bitstreams) cv::imencode(".jpg", syntheticFrame(c.width, c.height, c.type, rng), data, { cv::IMWRITE_JPEG_QUALITY, DAI_BENCH_DECODE_QUALITY });
+        ok &= benchDecode(c.name, bitstreams, options);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+// ------------------------------------------------------------------------
+// Json results benchmark
+//
+// ObjectDetector results payload with 100 detections: previous nlohmann tree (dumped 4 times into a malloc'ed copy, as
+// results used to be returned), nlohmann with a single dump, and JsonWriter reused between calls as results buffers are.
+// JsonWriter output is parsed back with nlohmann and checked against the detections.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "depthai-unity/device/JsonWriter.hpp"
+#include "Bench.hpp"
+
+#define DAI_BENCH_JSON_DETECTIONS 100
+
+struct BenchDetection
+{
+    int label;
+    float score;
+    int xmin, xmax, ymin, ymax;
+    float X, Y, Z;
+};
+
+static const std::vector<std::string> labelMap = {
+    "background", "aeroplane", "bicycle", "bird", "boat", "bottle", "bus", "car", "cat", "chair", "cow",
+    "diningtable", "dog", "horse", "motorbike", "person", "pottedplant", "sheep", "sofa", "train", "tvmonitor"
+};
+
+static nlohmann::json nlohmannResults(const std::vector<BenchDetection>& detections)
+{
+    nlohmann::json objectDetectorJson = {};
+    nlohmann::json objectsArr = {};
+    for (const auto& detection : detections)
+    {
+        nlohmann::json object;
+        object["label"] = labelMap[detection.label];
+        object["score"] = detection.score;
+        object["xmin"] = detection.xmin;
+        object["xmax"] = detection.xmax;
+        object["ymin"] = detection.ymin;
+        object["ymax"] = detection.ymax;
+        object["X"] = detection.X;
+        object["Y"] = detection.Y;
+        object["Z"] = detection.Z;
+        objectsArr.push_back(object);
+    }
+    objectDetectorJson["objects"] = objectsArr;
+    return objectDetectorJson;
+}
+
+static void writerResults(JsonWriter& json, const std::vector<BenchDetection>& detections)
+{
+    json.clear();
+    json.beginObject();
+    json.key("objects").beginArray();
+    for (const auto& detection : detections)
+    {
+        json.beginObject();
+        json.field("label", labelMap[detection.label]);
+        json.field("score", detection.score);
+        json.field("xmin", detection.xmin);
+        json.field("xmax", detection.xmax);
+        json.field("ymin", detection.ymin);
+        json.field("ymax", detection.ymax);
+        json.field("X", detection.X);
+        json.field("Y", detection.Y);
+        json.field("Z", detection.Z);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+}
+
+// parsed writer output holds every detection, floats read back to the same float
+static bool checkWriter(const char* text, const std::vector<BenchDetection>& detections)
+{
+    nlohmann::json parsed = nlohmann::json::parse(text, nullptr, false);
+    if (parsed.is_discarded() || !parsed["objects"].is_array() || parsed["objects"].size() != detections.size()) return false;
+
+    for (size_t i = 0; i < detections.size(); i++)
+    {
+        const auto& o = parsed["objects"][i];
+        const auto& d = detections[i];
+        if (o["label"].get<std::string>() != labelMap[d.label]) return false;
+        if (o["xmin"].get<int>() != d.xmin || o["xmax"].get<int>() != d.xmax || o["ymin"].get<int>() != d.ymin || o["ymax"].get<int>() != d.ymax) return false;
+        if (o["score"].get<float>() != d.score || o["X"].get<float>() != d.X || o["Y"].get<float>() != d.Y || o["Z"].get<float>() != d.Z) return false;
+    }
+    return true;
+}
+
+int JsonBench(const BenchOptions& options)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> mm(-3000.0f, 3000.0f);
+
+    std::vector<BenchDetection> detections(DAI_BENCH_JSON_DETECTIONS);
+    for (auto& d : detections)
+    {
+        d.label = (int)(rng() % labelMap.size());
+        d.score = unit(rng) * 100;
+        d.xmin = (int)(unit(rng) * 300);
+        d.xmax = d.xmin + (int)(unit(rng) * 100);
+        d.ymin = (int)(unit(rng) * 300);
+        d.ymax = d.ymin + (int)(unit(rng) * 100);
+        d.X = mm(rng);
+        d.Y = mm(rng);
+        d.Z = std::fabs(mm(rng));
+    }
+
+    printf("json %d detections\n", DAI_BENCH_JSON_DETECTIONS);
+
+    // previous results: tree, 4 dumps and a malloc'ed copy per call
+    BenchResult base = measure(options.iterations, [&]() {
+        nlohmann::json objectDetectorJson = nlohmannResults(detections);
+        char* ret = (char*)::malloc(strlen(objectDetectorJson.dump().c_str())+1);
+        ::memcpy(ret, objectDetectorJson.dump().c_str(), strlen(objectDetectorJson.dump().c_str()));
+        ret[strlen(objectDetectorJson.dump().c_str())] = 0;
+        ::free(ret);
+    });
+    report("previous (nlohmann, 4 dumps + copy)", base);
+
+    std::string dumped;
+    BenchResult single = measure(options.iterations, [&]() { dumped = nlohmannResults(detections).dump(); });
+    report("nlohmann single dump", single, &base);
+
+    JsonWriter json;
+    BenchResult writer = measure(options.iterations, [&]() { writerResults(json, detections); });
+    report("JsonWriter", writer, &base);
+    printf("  %-44s %zu bytes (nlohmann %zu bytes)\n", "payload", json.size(), dumped.size());
+
+    bool ok = checkWriter(json.c_str(), detections);
+    if (!ok) printf("  MISMATCH\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+// ------------------------------------------------------------------------
+// Host point cloud generator benchmark
+//
+// Synthetic 1280x800 depth (floor, wall and boxes from 0.4 m to 6 m, ~5% invalid pixels) and rectified intensity,
+// unprojected without calibration (default mono HFOV). Every config runs scalar and SIMD paths, outputs must match.
+// Voxel grid cases run on 1280x720 depth: time and point count against unfiltered generation. Output of every frame
+// must match first frame (hash table and arena are reused between frames).
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "depthai-unity/device/PointCloud.hpp"
+#include "Bench.hpp"
+
+// depth in mm of a simple room seen by the camera
+static cv::Mat syntheticDepth(int w, int h, std::mt19937& rng)
+{
+    cv::Mat depth(h, w, CV_16UC1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int y = 0; y < h; y++)
+    {
+        uint16_t* row = depth.ptr<uint16_t>(y);
+        for (int x = 0; x < w; x++)
+        {
+            // wall at 6 m, floor getting closer towards the bottom, two boxes
+            float z = 6000.0f;
+            if (y > h / 2) z = std::min(z, 1200.0f * h / (float)(y - h / 2 + 1));
+            if (x > w / 8 && x < w / 3 && y > h / 4 && y < h * 3 / 4) z = 1500.0f + x;
+            if (x > w / 2 && x < w * 7 / 8 && y > h / 3 && y < h * 5 / 6) z = 900.0f - y * 0.5f;
+            z = std::max(400.0f, z + unit(rng) * 8.0f);
+
+            row[x] = unit(rng) < 0.05f ? 0 : (uint16_t) z;
+        }
+    }
+    return depth;
+}
+
+static bool samePoints(const std::vector<std::uint8_t>& a, const std::vector<std::uint8_t>& b, int n, int pointSize)
+{
+    return std::memcmp(a.data(), b.data(), (size_t)n * pointSize) == 0;
+}
+
+// time one config, scalar and SIMD. Returns false if outputs differ
+static bool benchGenerate(const char* name, const cv::Mat& depth, const cv::Mat& intensity, const PointCloudConfig& config, const BenchOptions& options)
+{
+    printf(" %s\n", name);
+
+    int maxPoints = depth.cols * depth.rows;
+    int pointSize = (config.useIntensity ? 4 : 3) * (config.format == 1 ? 2 : 4);
+    std::vector<std::uint8_t> scalar((size_t)maxPoints * pointSize), simd((size_t)maxPoints * pointSize);
+    PointCloudGenerator generator;
+    int ns = 0, nv = 0;
+
+    cv::setUseOptimized(false);
+    BenchResult rs = measure(options.iterations, [&]() { ns = generator.generate(depth, intensity, config, scalar.data(), maxPoints); });
+    cv::setUseOptimized(true);
+    report("scalar", rs);
+    BenchResult rv = measure(options.iterations, [&]() { nv = generator.generate(depth, intensity, config, simd.data(), maxPoints); });
+    report("SIMD", rv, &rs);
+    printf("  %-44s %d points, %.1f MB\n", "output", nv, (double)nv * pointSize / (1024.0 * 1024.0));
+
+    bool ok = ns == nv && samePoints(scalar, simd, nv, pointSize);
+    if (!ok) printf("  MISMATCH\n");
+    return ok;
+}
+
+// time voxel grid filter of one voxel size. Returns false if frames differ or filter keeps more points than it gets
+static bool benchVoxel(const cv::Mat& depth, float voxelSize, int unfiltered, const BenchResult& base, const BenchOptions& options)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "voxel %.0f mm", voxelSize * 1000.0f);
+    printf(" %s\n", name);
+
+    PointCloudConfig config;
+    config.stride = 1;
+    config.minDepth = 0.0f;
+    config.maxDepth = 0.0f;
+    config.format = 0;
+    config.useIntensity = false;
+    config.voxelSize = voxelSize;
+
+    int maxPoints = depth.cols * depth.rows;
+    std::vector<std::uint8_t> first((size_t)maxPoints * 12), points((size_t)maxPoints * 12);
+    PointCloudGenerator generator;
+    int n0 = generator.generate(depth, cv::Mat(), config, first.data(), maxPoints);
+
+    int n = 0;
+    BenchResult r = measure(options.iterations, [&]() { n = generator.generate(depth, cv::Mat(), config, points.data(), maxPoints); });
+    report("generate + voxel grid", r, &base);
+    printf("  %-44s %d -> %d points (x%.1f fewer)\n", "output", unfiltered, n, n > 0 ? unfiltered / (double)n : 0.0);
+
+    bool ok = n == n0 && n > 0 && n <= unfiltered && samePoints(first, points, n, 12);
+    if (!ok) printf("  MISMATCH\n");
+    return ok;
+}
+
+int PointCloudBench(const BenchOptions& options)
+{
+    std::mt19937 rng(42);
+    bool ok = true;
+
+    const int w = 1280, h = 800;
+    cv::Mat depth = syntheticDepth(w, h, rng);
+    cv::Mat intensity(h, w, CV_8UC1);
+    for (int i = 0; i < w * h; i++) intensity.data[i] = (std::uint8_t) rng();
+
+    printf("pointcloud %dx%d\n", w, h);
+
+    PointCloudConfig config;
+    config.stride = 1;
+    config.minDepth = 0.0f;
+    config.maxDepth = 0.0f;
+    config.format = 0;
+    config.useIntensity = false;
+    config.voxelSize = 0.0f;
+    ok &= benchGenerate("xyz float", depth, intensity, config, options);
+
+    config.useIntensity = true;
+    ok &= benchGenerate("xyz + intensity float", depth, intensity, config, options);
+
+    config.useIntensity = false;
+    config.format = 1;
+    ok &= benchGenerate("xyz half", depth, intensity, config, options);
+
+    config.format = 0;
+    config.minDepth = 0.5f;
+    config.maxDepth = 4.0f;
+    ok &= benchGenerate("xyz float, 0.5-4 m", depth, intensity, config, options);
+
+    config.minDepth = config.maxDepth = 0.0f;
+    config.stride = 2;
+    ok &= benchGenerate("xyz float, stride 2", depth, intensity, config, options);
+
+    // voxel grid at 1280x720, against unfiltered generation
+    cv::Mat depth720 = syntheticDepth(1280, 720, rng);
+    printf("pointcloud voxel grid %dx%d\n", depth720.cols, depth720.rows);
+
+    config.stride = 1;
+    int maxPoints = depth720.cols * depth720.rows;
+    std::vector<std::uint8_t> points((size_t)maxPoints * 12);
+    PointCloudGenerator generator;
+    int unfiltered = 0;
+    BenchResult base = measure(options.iterations, [&]() { unfiltered = generator.generate(depth720, cv::Mat(), config, points.data(), maxPoints); });
+    report("generate", base);
+
+    const float voxelSizes[] = { 0.01f, 0.02f, 0.05f, 0.1f };
+    for (float voxelSize : voxelSizes) ok &= benchVoxel(depth720, voxelSize, unfiltered, base, options);
+
+    return ok ? 0 : 1;
+}
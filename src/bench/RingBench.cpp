@@ -0,0 +1,273 @@
+// ------------------------------------------------------------------------
+// Shared memory ring against TCP loopback benchmark
+//
+// Producer and consumer are separate processes (fork), as plugin and out of process consumers are. Each payload size runs
+// two passes: latency (messages spaced DAI_BENCH_RING_GAP_US apart, consumer sleeps between them) and throughput
+// (messages back to back). Latency is from producer timestamp, taken before the payload is copied into ring slot or socket,
+// to consumer receive. Steady clock is shared by both processes. TCP frames have fixed size, socket has TCP_NODELAY. POSIX only.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "depthai-unity/device/SharedRing.hpp"
+#include "Bench.hpp"
+
+#ifdef _WIN32
+
+int RingBench(const BenchOptions&)
+{
+    printf("ring: skipped (POSIX only)\n");
+    return 0;
+}
+
+#else
+
+#define DAI_BENCH_RING_SLOTS 8
+#define DAI_BENCH_RING_GAP_US 200
+#define DAI_BENCH_RING_TIMEOUT_MS 5000
+
+struct RingCase
+{
+    const char* name;
+    uint32_t size;
+    int latencyMessages;
+    int throughputMessages;
+};
+
+static const RingCase ringCases[] = {
+    { "4 KB results", 4096, 1000, 20000 },
+    { "640x360 BGR frame", 640 * 360 * 3, 500, 1000 },
+    { "1920x1080 BGR frame", 1920 * 1080 * 3, 200, 300 },
+};
+
+static int64_t nowMicros()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// payload starts with message index (checked against expected order) and producer timestamp
+struct RingMessage
+{
+    int32_t index;
+    int32_t reserved;
+    int64_t timestamp;
+};
+
+// consumer side stats
+struct ConsumerStats
+{
+    std::vector<double> latencies;
+    int64_t throughputStart = 0;
+    int64_t throughputEnd = 0;
+    int received = 0;
+    bool ordered = true;
+
+    void add(const RingCase& c, const std::uint8_t* payload)
+    {
+        int64_t now = nowMicros();
+        RingMessage message;
+        std::memcpy(&message, payload, sizeof(message));
+        if (message.index != received) ordered = false;
+
+        if (received < c.latencyMessages) latencies.push_back((double)(now - message.timestamp));
+        else if (received == c.latencyMessages) throughputStart = message.timestamp;
+        throughputEnd = now;
+        received++;
+    }
+
+    // printed by consumer process. Returns process exit code
+    int print(const char* transport, const RingCase& c)
+    {
+        int expected = c.latencyMessages + c.throughputMessages;
+        if (received != expected || !ordered || latencies.empty())
+        {
+            printf("  %-6s %d/%d messages%s\n", transport, received, expected, ordered ? "" : ", out of order");
+            return 1;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        double median = latencies[latencies.size() / 2];
+        double p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+        double seconds = std::max(throughputEnd - throughputStart, (int64_t)1) / 1e6;
+        printf("  %-6s latency median %8.1f us  p99 %8.1f us   throughput %9.0f msg/s %8.1f MB/s\n", transport, median, p99,
+               c.throughputMessages / seconds, (double)c.throughputMessages * c.size / seconds / (1024.0 * 1024.0));
+        return 0;
+    }
+};
+
+// producer side: both passes, send returns false on failure
+static bool produce(const RingCase& c, const std::function<bool(std::vector<std::uint8_t>&)>& send)
+{
+    std::vector<std::uint8_t> payload(c.size, 0x5a);
+    for (int32_t i = 0; i < c.latencyMessages + c.throughputMessages; i++)
+    {
+        RingMessage message = { i, 0, nowMicros() };
+        std::memcpy(payload.data(), &message, sizeof(message));
+        if (!send(payload)) return false;
+        if (i < c.latencyMessages) std::this_thread::sleep_for(std::chrono::microseconds(DAI_BENCH_RING_GAP_US));
+    }
+    return true;
+}
+
+// run consumer in child process, producer in this one. Returns true if both succeeded
+static bool runPair(const std::function<int()>& consumer, const std::function<bool()>& producer)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0)
+    {
+        int code = consumer();
+        fflush(stdout);
+        _exit(code);
+    }
+
+    bool ok = producer();
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static bool benchShm(const RingCase& c)
+{
+    std::string name = "dai_bench_" + std::to_string(getpid());
+    std::unique_ptr<SharedRing> ring = SharedRing::create(name, DAI_BENCH_RING_SLOTS, (int)c.size);
+    if (!ring)
+    {
+        printf("  shm    segment %s couldn't be created\n", name.c_str());
+        return false;
+    }
+
+    return runPair([&]() {
+        // consumer maps segment by name, as out of process consumers do
+        std::unique_ptr<SharedRing> reader = SharedRing::open(name);
+        if (!reader) return 1;
+
+        ConsumerStats stats;
+        while (stats.received < c.latencyMessages + c.throughputMessages)
+        {
+            const SharedRingRecord* record = reader->acquireRead(DAI_BENCH_RING_TIMEOUT_MS, false);
+            if (record == NULL) break;
+            stats.add(c, (const std::uint8_t*)(record + 1));
+            reader->releaseRead();
+        }
+        return stats.print("shm", c);
+    }, [&]() {
+        return produce(c, [&](std::vector<std::uint8_t>& payload) {
+            // lossless ring: wait for consumer to release a slot
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DAI_BENCH_RING_TIMEOUT_MS);
+            while (!ring->write(SHARED_RING_USER, payload.data(), (uint32_t)payload.size()))
+            {
+                if (std::chrono::steady_clock::now() > deadline) return false;
+                std::this_thread::yield();
+            }
+            return true;
+        });
+    });
+}
+
+static bool sendAll(int fd, const void* data, size_t size)
+{
+    const char* p = (const char*) data;
+    while (size > 0)
+    {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static bool recvAll(int fd, void* data, size_t size)
+{
+    char* p = (char*) data;
+    while (size > 0)
+    {
+        ssize_t n = recv(fd, p, size, 0);
+        if (n <= 0) return false;
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static bool benchTcp(const RingCase& c)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (listener < 0 || bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, (sockaddr*)&addr, &len) != 0)
+    {
+        printf("  tcp    loopback listener couldn't be created\n");
+        if (listener >= 0) close(listener);
+        return false;
+    }
+
+    bool ok = runPair([&]() {
+        close(listener);
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) return 1;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        ConsumerStats stats;
+        std::vector<std::uint8_t> payload(c.size);
+        while (stats.received < c.latencyMessages + c.throughputMessages)
+        {
+            if (!recvAll(fd, payload.data(), payload.size())) break;
+            stats.add(c, payload.data());
+        }
+        close(fd);
+        return stats.print("tcp", c);
+    }, [&]() {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) return false;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        bool sent = produce(c, [&](std::vector<std::uint8_t>& payload) { return sendAll(fd, payload.data(), payload.size()); });
+        close(fd);
+        return sent;
+    });
+
+    close(listener);
+    return ok;
+}
+
+int RingBench(const BenchOptions&)
+{
+    bool ok = true;
+    for (const auto& c : ringCases)
+    {
+        printf("ring %s, %u bytes, %d slots\n", c.name, c.size, DAI_BENCH_RING_SLOTS);
+        ok &= benchShm(c);
+        ok &= benchTcp(c);
+    }
+    return ok ? 0 : 1;
+}
+
+#endif
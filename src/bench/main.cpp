@@ -0,0 +1,101 @@
+// ------------------------------------------------------------------------
+// depthai-unity-bench: host side benchmarks of plugin hot paths, no device needed
+//
+// depthai-unity-bench [convert] [json] [ring] [pointcloud] [decode] [--iterations 50] [--mjpeg FILE]
+//
+// convert: toMat (planar/interleaved, U8/FP16) and toARGB at 300x300, 1080p and 4K against previous implementations,
+//          scalar and SIMD paths (cv::setUseOptimized)
+// json: ObjectDetector results with 100 detections, JsonWriter against previous nlohmann results
+// ring: shared memory ring against TCP loopback between two processes, latency and throughput (POSIX only)
+// pointcloud: host point cloud generator on 1280x800 depth, float/half, intensity, depth range and stride, scalar and SIMD.
+//             Voxel grid downsampling of 1280x720 depth at 1, 2, 5 and 10 cm voxels
+// decode: MJPEG host decode (preview, mono) into reused buffer, bitstream size and link bandwidth against raw frames.
+//         --mjpeg decodes a recorded bitstream (concatenated JPEG frames) instead of synthetic frames
+//
+// Without benchmark names every benchmark runs. Exit code is non zero if an optimized path doesn't match its reference.
+//
+// Not covered, their cost is device and link latency that no host side input reproduces (dai queues need an XLink device):
+// - acquisition thread: results calls only swap latest-frame slots, what it saves is the blocking get<>() on Unity thread.
+//   Measure with a device through DAIStreamStats and Unity frame time
+// - second stage inference (HeadPose, FaceEmotion): face crops are pipelined to device NN, saving USB round trips per face.
+//   Host part per face (crop, letterbox, planarize) is one toPlanarTensor call
+// - frame sync (preview, detections, depth): matching is a sequence number lookup per message, what it changes is which
+//   frames are shown together and that no queue blocks. Check with a device through DAIStreamStats bundle counters
+// - IMU collector: a report costs one ring slot copy, 400 Hz is far from any host limit. Reports are lost on device
+//   batching and link, check with a device that IMU sample timestamps have no gaps
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "Bench.hpp"
+
+struct BenchEntry
+{
+    const char* name;
+    int (*run)(const BenchOptions&);
+};
+
+static const BenchEntry benchmarks[] = {
+    { "convert", ConvertBench },
+    { "json", JsonBench },
+    { "ring", RingBench },
+    { "pointcloud", PointCloudBench },
+    { "decode", DecodeBench },
+};
+
+static void usage()
+{
+    printf("depthai-unity-bench [");
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) printf("%s%s", i ? "|" : "", benchmarks[i].name);
+    printf("]... [--iterations N] [--mjpeg FILE]\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    std::vector<std::string> selected;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) options.iterations = std::max(1, atoi(argv[++i]));
+        else if (arg == "--mjpeg" && i + 1 < argc) options.mjpeg = argv[++i];
+        else if (arg == "--help" || arg == "-h")
+        {
+            usage();
+            return 0;
+        }
+        else selected.push_back(arg);
+    }
+
+    for (const auto& name : selected)
+    {
+        auto known = std::find_if(std::begin(benchmarks), std::end(benchmarks), [&name](const BenchEntry& b) { return name == b.name; });
+        if (known == std::end(benchmarks))
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    printf("OpenCV %s, %d threads\n", CV_VERSION, cv::getNumThreads());
+
+    int failed = 0;
+    for (const auto& bench : benchmarks)
+    {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), bench.name) == selected.end()) continue;
+        if (bench.run(options) != 0)
+        {
+            printf("%s: FAILED\n", bench.name);
+            failed++;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
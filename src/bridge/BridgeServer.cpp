@@ -0,0 +1,298 @@
+// ------------------------------------------------------------------------
+// Network bridge server
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "depthai-unity/bridge/BridgeServer.hpp"
+
+static_assert(sizeof(BridgeMessageHeader) == 32, "BridgeMessageHeader layout");
+
+static bool setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+BridgeServer::BridgeServer(int maxQueued) : maxQueued(maxQueued > 0 ? maxQueued : 1)
+{
+}
+
+BridgeServer::~BridgeServer()
+{
+    stop();
+}
+
+bool BridgeServer::start(const std::string& host, int port)
+{
+    if (running) return false;
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+
+    int on = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t) port);
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1 ||
+        bind(listenFd, (sockaddr*) &address, sizeof(address)) != 0 ||
+        listen(listenFd, 64) != 0 || !setNonBlocking(listenFd))
+    {
+        std::cerr << "bridge: can't listen on " << host << ":" << port << " (" << std::strerror(errno) << ")" << std::endl;
+        stop();
+        return false;
+    }
+
+    epollFd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        stop();
+        return false;
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    running = true;
+    worker = std::thread(&BridgeServer::run, this);
+    return true;
+}
+
+void BridgeServer::stop()
+{
+    if (running)
+    {
+        running = false;
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {}
+        if (worker.joinable()) worker.join();
+    }
+
+    for (auto& it : clients) close(it.first);
+    clients.clear();
+    numClients = 0;
+
+    if (listenFd >= 0) close(listenFd);
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+    listenFd = epollFd = wakeFd = -1;
+}
+
+BridgeMessage BridgeServer::makeMessage(BridgeMessageType type, uint32_t sequence, int width, int height, const void* data, size_t size)
+{
+    std::shared_ptr<std::vector<std::uint8_t>> message = std::make_shared<std::vector<std::uint8_t>>(sizeof(BridgeMessageHeader) + size);
+
+    BridgeMessageHeader* header = (BridgeMessageHeader*) message->data();
+    header->magic = DAI_BRIDGE_MAGIC;
+    header->version = DAI_BRIDGE_VERSION;
+    header->type = (uint16_t) type;
+    header->size = (uint32_t) size;
+    header->sequence = sequence;
+    header->timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    header->width = width;
+    header->height = height;
+    if (size > 0) std::memcpy(message->data() + sizeof(BridgeMessageHeader), data, size);
+
+    return message;
+}
+
+void BridgeServer::broadcast(const BridgeMessage& message)
+{
+    if (!running || numClients == 0) return;
+
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wasEmpty = pending.empty();
+        pending.push_back(message);
+    }
+
+    // one wakeup per batch, I/O thread takes all pending messages at once
+    if (wasEmpty)
+    {
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {}
+    }
+}
+
+void BridgeServer::run()
+{
+    std::vector<epoll_event> events(64);
+    std::vector<BridgeMessage> batch;
+
+    while (running)
+    {
+        int n = epoll_wait(epollFd, events.data(), (int) events.size(), -1);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            int fd = events[i].data.fd;
+
+            if (fd == listenFd)
+            {
+                acceptClients();
+            }
+            else if (fd == wakeFd)
+            {
+                uint64_t count;
+                if (read(wakeFd, &count, sizeof(count)) < 0) {}
+
+                batch.clear();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    batch.swap(pending);
+                }
+
+                std::vector<int> closed;
+                for (auto& it : clients)
+                {
+                    for (const BridgeMessage& message : batch) enqueue(it.second, message);
+                    if (!it.second.waitWritable && !flush(it.second)) closed.push_back(it.first);
+                }
+                for (int c : closed) closeClient(c);
+            }
+            else
+            {
+                auto it = clients.find(fd);
+                if (it == clients.end()) continue;
+
+                Client& client = it->second;
+                bool alive = true;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) alive = false;
+                if (alive && (events[i].events & (EPOLLIN | EPOLLRDHUP))) alive = receive(client);
+                if (alive && (events[i].events & EPOLLOUT)) alive = flush(client);
+                if (!alive) closeClient(fd);
+            }
+        }
+    }
+}
+
+void BridgeServer::acceptClients()
+{
+    while (true)
+    {
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) return;
+
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        setNonBlocking(fd);
+
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        Client& client = clients[fd];
+        client.fd = fd;
+        numClients = (int) clients.size();
+    }
+}
+
+bool BridgeServer::receive(Client& client)
+{
+    // clients only send requests of the python bridge ("DATA"), ignored: server pushes every frame
+    char buffer[256];
+    while (true)
+    {
+        ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        if (n < 0 && errno == EINTR) continue;
+
+        // closed by peer or error
+        return false;
+    }
+}
+
+void BridgeServer::enqueue(Client& client, const BridgeMessage& message)
+{
+    client.queue.push_back(message);
+
+    // drop oldest, front message is kept while partially sent
+    while ((int) client.queue.size() > maxQueued)
+    {
+        size_t index = client.offset > 0 ? 1 : 0;
+        client.queue.erase(client.queue.begin() + (std::ptrdiff_t) index);
+        dropped++;
+    }
+}
+
+bool BridgeServer::flush(Client& client)
+{
+    while (!client.queue.empty())
+    {
+        const std::vector<std::uint8_t>& message = *client.queue.front();
+        ssize_t n = send(client.fd, message.data() + client.offset, message.size() - client.offset, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // socket buffer full, continue when writable
+                watchWritable(client, true);
+                return true;
+            }
+            return false;
+        }
+
+        client.offset += (size_t) n;
+        if (client.offset == message.size())
+        {
+            client.queue.pop_front();
+            client.offset = 0;
+        }
+    }
+
+    watchWritable(client, false);
+    return true;
+}
+
+void BridgeServer::watchWritable(Client& client, bool enable)
+{
+    if (client.waitWritable == enable) return;
+
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (enable) event.events |= EPOLLOUT;
+    event.data.fd = client.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+    client.waitWritable = enable;
+}
+
+void BridgeServer::closeClient(int fd)
+{
+    if (clients.erase(fd) == 0) return;
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+    close(fd);
+    numClients = (int) clients.size();
+}
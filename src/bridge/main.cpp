@@ -0,0 +1,313 @@
+// ------------------------------------------------------------------------
+// depthai-unity-bridge: streams one device (preview and results) to many remote Unity clients
+//
+// depthai-unity-bridge [--host 0.0.0.0] [--port 12347] [--device-id MXID] [--preview 640x360] [--fps 30]
+//                      [--jpeg 80] [--binary-results] [--sysinfo] [--imu] [--queue 4]
+//                      [--synthetic] [--loopback N] [--seconds 10]
+//
+// --jpeg 0 sends raw BGR frames. With device, JPEG frames are encoded on device (MJPEG) and forwarded without host re-encode.
+// --synthetic generates frames without device.
+// --loopback N connects N local clients and prints fps and latency per client (benchmark).
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#include "depthai-unity/bridge/BridgeServer.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/DeviceManager.hpp"
+
+// plugin exports (Streams.cpp, Results.cpp, DeviceManager.cpp)
+extern "C"
+{
+    bool InitStreams(PipelineConfig *config);
+    const char* StreamsResults(FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum);
+    FrameResults* StreamsResultsBinary(FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results);
+    void DAIReleaseResult(const char* result);
+    void DAICloseDevice(int deviceNum);
+}
+
+struct BridgeOptions
+{
+    std::string host = "0.0.0.0";
+    int port = 12347;
+    std::string deviceId = "NONE";
+    int width = 640, height = 360;
+    float fps = 30.0f;
+    int jpegQuality = 80;
+    bool binaryResults = false;
+    bool sysinfo = false;
+    bool imu = false;
+    int queue = 4;
+    bool synthetic = false;
+    int loopback = 0;
+    int seconds = 10;
+};
+
+static std::atomic<bool> running{true};
+
+static void onSignal(int)
+{
+    running = false;
+}
+
+static int64_t nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool parseOptions(int argc, char** argv, BridgeOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--host" && hasValue) options.host = argv[++i];
+        else if (arg == "--port" && hasValue) options.port = std::atoi(argv[++i]);
+        else if (arg == "--device-id" && hasValue) options.deviceId = argv[++i];
+        else if (arg == "--preview" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) return false;
+        }
+        else if (arg == "--fps" && hasValue) options.fps = (float) std::atof(argv[++i]);
+        else if (arg == "--jpeg" && hasValue) options.jpegQuality = std::atoi(argv[++i]);
+        else if (arg == "--binary-results") options.binaryResults = true;
+        else if (arg == "--sysinfo") options.sysinfo = true;
+        else if (arg == "--imu") options.imu = true;
+        else if (arg == "--queue" && hasValue) options.queue = std::atoi(argv[++i]);
+        else if (arg == "--synthetic") options.synthetic = true;
+        else if (arg == "--loopback" && hasValue) options.loopback = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && hasValue) options.seconds = std::atoi(argv[++i]);
+        else return false;
+    }
+    return options.width > 0 && options.height > 0 && options.fps > 0.0f;
+}
+
+/**
+* Loopback benchmark client. Counts frames and measures latency from message creation to full reception
+*/
+struct LoopbackClient
+{
+    std::thread thread;
+    int frames = 0;
+    std::vector<int64_t> latencies;
+};
+
+static void runLoopbackClient(LoopbackClient& client, int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t) port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (fd < 0 || connect(fd, (sockaddr*) &address, sizeof(address)) != 0)
+    {
+        std::cerr << "loopback: can't connect" << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+
+    // blocking reads, timeout lets thread see end of benchmark
+    timeval timeout = {0, 200000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::vector<std::uint8_t> payload;
+    auto readAll = [&](void* dst, size_t size)
+    {
+        size_t done = 0;
+        while (done < size)
+        {
+            ssize_t n = recv(fd, (std::uint8_t*) dst + done, size - done, 0);
+            if (n > 0) done += (size_t) n;
+            else if (n < 0 && (errno == EAGAIN || errno == EINTR) && running) continue;
+            else return false;
+        }
+        return true;
+    };
+
+    while (running)
+    {
+        BridgeMessageHeader header;
+        if (!readAll(&header, sizeof(header)) || header.magic != DAI_BRIDGE_MAGIC) break;
+        payload.resize(header.size);
+        if (!readAll(payload.data(), header.size)) break;
+
+        if (header.type == BRIDGE_FRAME_RAW || header.type == BRIDGE_FRAME_JPEG)
+        {
+            client.frames++;
+            client.latencies.push_back(nowMicros() - header.timestamp);
+        }
+    }
+    close(fd);
+}
+
+int main(int argc, char** argv)
+{
+    BridgeOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: depthai-unity-bridge [--host 0.0.0.0] [--port 12347] [--device-id MXID] [--preview 640x360] [--fps 30]" << std::endl;
+        std::cerr << "                            [--jpeg 80] [--binary-results] [--sysinfo] [--imu] [--queue 4]" << std::endl;
+        std::cerr << "                            [--synthetic] [--loopback N] [--seconds 10]" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    BridgeServer server(options.queue);
+    if (!server.start(options.host, options.port)) return 1;
+    std::cout << "bridge: listening on " << options.host << ":" << options.port << std::endl;
+
+    // device pipeline: color preview, optional sysinfo/imu
+    if (!options.synthetic)
+    {
+        PipelineConfig config;
+        std::memset(&config, 0, sizeof(config));
+        config.deviceNum = 0;
+        config.deviceId = options.deviceId.c_str();
+        config.colorCameraFPS = options.fps;
+        config.previewSizeWidth = options.width;
+        config.previewSizeHeight = options.height;
+        config.rate = options.sysinfo ? 1.0f : 0.0f;
+        config.freq = options.imu ? 400 : 0;
+        config.batchReportThreshold = 1;
+        config.maxBatchReports = 10;
+        config.videoEncoding = options.jpegQuality > 0 ? 1 : 0;
+        config.encoderQuality = options.jpegQuality;
+
+        if (!InitStreams(&config))
+        {
+            std::cerr << "bridge: no device available" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<LoopbackClient> loopback(options.loopback > 0 ? options.loopback : 0);
+    for (LoopbackClient& client : loopback) client.thread = std::thread(runLoopbackClient, std::ref(client), options.port);
+
+    FrameInfo frameInfo;
+    std::memset(&frameInfo, 0, sizeof(frameInfo));
+    FrameResults results;
+    cv::Mat synthetic(options.height, options.width, CV_8UC3);
+    // device encoded frame (MJPEG bitstream), forwarded as is
+    std::shared_ptr<dai::ImgFrame> bitstream;
+    std::vector<std::uint8_t> jpeg;
+    std::vector<int> jpegParams = {cv::IMWRITE_JPEG_QUALITY, options.jpegQuality};
+
+    uint32_t sequence = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto nextSynthetic = start;
+
+    while (running)
+    {
+        if (options.loopback > 0 && std::chrono::steady_clock::now() - start > std::chrono::seconds(options.seconds)) break;
+
+        cv::Mat frame;
+        // worker held while frame (view of its message) is encoded
+        std::shared_ptr<DeviceAcquisition> acquisition;
+        if (options.synthetic)
+        {
+            // moving bar at requested fps
+            std::this_thread::sleep_until(nextSynthetic);
+            nextSynthetic += std::chrono::microseconds((int64_t)(1e6f / options.fps));
+            synthetic.setTo(cv::Scalar(64, 64, 64));
+            int x = (int)(sequence * 4 % (uint32_t) options.width);
+            cv::rectangle(synthetic, cv::Rect(x, 0, std::min(16, options.width - x), options.height), cv::Scalar(0, 255, 0), -1);
+            frame = synthetic;
+        }
+        else
+        {
+            bool isNew = false;
+            acquisition = GetAcquisition(0);
+            AcquiredMessage* acquired = GetAcquired(acquisition, "preview", &isNew);
+            if (!acquired || !isNew || acquired->frame.empty())
+            {
+                // acquisition thread publishes latest frame, nothing to wait on
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            frame = acquired->frame;
+            bitstream = std::dynamic_pointer_cast<dai::ImgFrame>(acquired->msg);
+            if (bitstream && bitstream->getType() != dai::ImgFrame::Type::BITSTREAM) bitstream.reset();
+        }
+
+        // encode once, shared by every client
+        if (server.clientCount() > 0)
+        {
+            if (bitstream)
+            {
+                std::vector<std::uint8_t>& data = bitstream->getData();
+                server.broadcast(BridgeServer::makeMessage(BRIDGE_FRAME_JPEG, sequence, frame.cols, frame.rows, data.data(), data.size()));
+            }
+            else if (options.jpegQuality > 0)
+            {
+                cv::imencode(".jpg", frame, jpeg, jpegParams);
+                server.broadcast(BridgeServer::makeMessage(BRIDGE_FRAME_JPEG, sequence, frame.cols, frame.rows, jpeg.data(), jpeg.size()));
+            }
+            else
+            {
+                cv::Mat packed = frame.isContinuous() ? frame : frame.clone();
+                server.broadcast(BridgeServer::makeMessage(BRIDGE_FRAME_RAW, sequence, packed.cols, packed.rows, packed.data, packed.total() * packed.elemSize()));
+            }
+
+            if (!options.synthetic)
+            {
+                if (options.binaryResults)
+                {
+                    StreamsResultsBinary(&frameInfo, false, false, options.sysinfo, options.imu, 0, &results);
+                    server.broadcast(BridgeServer::makeMessage(BRIDGE_RESULTS_BINARY, sequence, 0, 0, &results, sizeof(results)));
+                }
+                else
+                {
+                    const char* json = StreamsResults(&frameInfo, false, false, options.sysinfo, options.imu, 0);
+                    server.broadcast(BridgeServer::makeMessage(BRIDGE_RESULTS_JSON, sequence, 0, 0, json, std::strlen(json)));
+                    DAIReleaseResult(json);
+                }
+            }
+        }
+        sequence++;
+    }
+
+    running = false;
+    for (LoopbackClient& client : loopback) client.thread.join();
+
+    if (!loopback.empty())
+    {
+        float elapsed = (float) options.seconds;
+        std::printf("loopback: %d clients, %dx%d %s, dropped %llu\n", options.loopback, options.width, options.height,
+            options.jpegQuality > 0 ? "jpeg" : "raw", (unsigned long long) server.droppedCount());
+        for (size_t i = 0; i < loopback.size(); i++)
+        {
+            std::vector<int64_t>& latencies = loopback[i].latencies;
+            if (latencies.empty()) continue;
+            std::sort(latencies.begin(), latencies.end());
+            int64_t sum = 0;
+            for (int64_t latency : latencies) sum += latency;
+            std::printf("  client %2d: %6.1f fps  latency mean %6lld us  p99 %6lld us\n", (int) i, loopback[i].frames / elapsed,
+                (long long)(sum / (int64_t) latencies.size()), (long long) latencies[latencies.size() * 99 / 100]);
+        }
+    }
+
+    server.stop();
+    if (!options.synthetic) DAICloseDevice(0);
+    return 0;
+}
@@ -0,0 +1,491 @@
+#pragma GCC diagnostic ignored "-Wreturn-type-c-linkage"
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+#include "../utility.hpp"
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+#include "depthai/device/Device.hpp"
+
+#include "depthai-unity/device/Acquisition.hpp"
+
+// Acquisition worker per device (same indexing as devices). Swapped atomically, StartAcquisition runs on boot thread with async boot
+static std::shared_ptr<DeviceAcquisition> acquisitions[DAI_MAX_DEVICES];
+
+// predefined queues with their own readers (sysinfo and IMU collectors) and fixed host queue policy
+static const std::unordered_map<std::string, StreamPolicy> predefinedStreams = {
+    {"sysinfo", StreamPolicy(4, false)},
+    {"imu", StreamPolicy(50, false)}
+};
+
+// Convert image frame on acquisition thread. Color frames to BGR (RGB order swapped), BGR interleaved and single channel frames are just wrapped (no copy)
+static void convertFrame(const std::shared_ptr<dai::ImgFrame>& imgFrame, AcquiredMessage& slot)
+{
+    switch (imgFrame->getType())
+    {
+        case dai::ImgFrame::Type::BGR888p:
+            toMat(imgFrame->getData(), imgFrame->getWidth(), imgFrame->getHeight(), 3, 1, slot.buffer);
+            slot.frame = slot.buffer;
+            break;
+        case dai::ImgFrame::Type::RGB888p:
+            // planes interleaved in camera order, then swapped in place (colorCameraColorOrder RGB)
+            toMat(imgFrame->getData(), imgFrame->getWidth(), imgFrame->getHeight(), 3, 1, slot.buffer);
+            if (!slot.buffer.empty()) cv::cvtColor(slot.buffer, slot.buffer, cv::COLOR_RGB2BGR);
+            slot.frame = slot.buffer;
+            break;
+        case dai::ImgFrame::Type::RGB888i:
+            cv::cvtColor(cv::Mat(imgFrame->getHeight(), imgFrame->getWidth(), CV_8UC3, imgFrame->getData().data()), slot.buffer, cv::COLOR_RGB2BGR);
+            slot.frame = slot.buffer;
+            break;
+        case dai::ImgFrame::Type::BGR888i:
+        case dai::ImgFrame::Type::RAW8:
+        case dai::ImgFrame::Type::GRAY8:
+        case dai::ImgFrame::Type::RAW16:
+            slot.frame = imgFrame->getFrame();
+            break;
+        case dai::ImgFrame::Type::BITSTREAM:
+        {
+            // MJPEG encoded transport. Decoded into slot buffer, reused while frame size doesn't change
+            std::vector<std::uint8_t>& data = imgFrame->getData();
+            if (data.empty() || cv::imdecode(cv::Mat(1, (int)data.size(), CV_8UC1, data.data()), cv::IMREAD_UNCHANGED, &slot.buffer).empty())
+            {
+                slot.frame = cv::Mat();
+                break;
+            }
+            slot.frame = slot.buffer;
+            break;
+        }
+        default:
+            slot.frame = imgFrame->getCvFrame();
+            break;
+    }
+}
+
+// sequence number and device timestamp (microseconds) of messages that carry them
+template <typename T>
+static bool stampOf(const std::shared_ptr<dai::ADatatype>& msg, int64_t& sequenceNum, int64_t& timestamp)
+{
+    auto typed = std::dynamic_pointer_cast<T>(msg);
+    if (!typed) return false;
+    sequenceNum = typed->getSequenceNum();
+    timestamp = std::chrono::duration_cast<std::chrono::microseconds>(typed->getTimestamp().time_since_epoch()).count();
+    return true;
+}
+
+static bool stamp(const std::shared_ptr<dai::ADatatype>& msg, int64_t& sequenceNum, int64_t& timestamp)
+{
+    return stampOf<dai::ImgFrame>(msg, sequenceNum, timestamp) || stampOf<dai::ImgDetections>(msg, sequenceNum, timestamp)
+        || stampOf<dai::SpatialImgDetections>(msg, sequenceNum, timestamp) || stampOf<dai::NNData>(msg, sequenceNum, timestamp)
+        || stampOf<dai::SpatialLocationCalculatorData>(msg, sequenceNum, timestamp);
+}
+
+DeviceAcquisition::DeviceAcquisition(std::shared_ptr<dai::Device> device, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+    const BundlePolicy& bundle)
+    : device(device)
+{
+    // resolve all queue handles once, maxSize/blocking stay fixed while pipeline runs
+    for (const auto& name : device->getOutputQueueNames())
+    {
+        auto predefined = predefinedStreams.find(name);
+        if (predefined != predefinedStreams.end())
+        {
+            outputs[name] = device->getOutputQueue(name, predefined->second.maxSize, predefined->second.blocking);
+            continue;
+        }
+
+        // request/response streams keep device default policy (blocking)
+        if (std::find(syncStreams.begin(), syncStreams.end(), name) != syncStreams.end())
+        {
+            outputs[name] = device->getOutputQueue(name);
+            continue;
+        }
+
+        // bundled streams keep every message until drained, not only latest one
+        bool bundled = std::find(bundle.streams.begin(), bundle.streams.end(), name) != bundle.streams.end();
+        int maxSize = bundled ? std::max(policy.maxSize, bundle.bufferSize) : policy.maxSize;
+
+        std::unique_ptr<Stream> stream(new Stream());
+        stream->queue = device->getOutputQueue(name, maxSize, policy.blocking);
+        stream->bundled = bundled;
+        streams[name] = std::move(stream);
+        names.push_back(name);
+    }
+
+    for (const auto& name : device->getInputQueueNames())
+    {
+        inputs[name] = device->getInputQueue(name);
+    }
+
+    // bundle order as requested, first stream is the reference of each bundle
+    for (const auto& name : bundle.streams)
+    {
+        auto it = streams.find(name);
+        if (it == streams.end()) continue;
+        bundleStreams.push_back(it->second.get());
+        bundleNames.push_back(name);
+    }
+    bundleTolerance = bundle.toleranceMs < 0.0f ? -1 : (int64_t)(bundle.toleranceMs * 1000.0f);
+    bundleBufferSize = (size_t) bundle.bufferSize;
+}
+
+DeviceAcquisition::~DeviceAcquisition()
+{
+    stop();
+}
+
+void DeviceAcquisition::start()
+{
+    if (names.empty() || running) return;
+
+    running = true;
+    worker = std::thread(&DeviceAcquisition::run, this);
+}
+
+void DeviceAcquisition::stop()
+{
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void DeviceAcquisition::run()
+{
+    while (running)
+    {
+        try
+        {
+            // wait until any acquired queue receives a message (timeout to check for stop)
+            auto events = device->getQueueEvents(names, std::numeric_limits<std::size_t>::max(), std::chrono::milliseconds(100));
+            for (const auto& name : events)
+            {
+                auto it = streams.find(name);
+                if (it != streams.end()) drain(*it->second);
+            }
+
+            // roll stats window every second on every stream, paused streams (gated, stalled) drop to 0 fps
+            auto now = std::chrono::steady_clock::now();
+            for (auto& stream : streams) rollStats(*stream.second, now);
+        }
+        catch (const std::exception&)
+        {
+            // device closed or disconnected
+            running = false;
+        }
+    }
+}
+
+void DeviceAcquisition::drain(Stream& stream)
+{
+    auto msgs = stream.queue->tryGetAll();
+    if (msgs.empty()) return;
+
+    // every message crossed the link, even if only latest is converted
+    for (const auto& msg : msgs)
+    {
+        auto buffer = std::dynamic_pointer_cast<dai::Buffer>(msg);
+        if (buffer) stream.bytes += buffer->getData().size();
+    }
+    stream.messages += msgs.size();
+    if (stream.probeSent.load() != 0) checkProbe(stream, msgs);
+
+    if (stream.bundled)
+    {
+        // every message is a candidate, frames are only converted once matched
+        for (const auto& msg : msgs) addPending(stream, msg);
+        matchBundle();
+    }
+    else
+    {
+        AcquiredMessage& slot = stream.slots.back();
+        slot.msg = msgs.back();
+
+        auto imgFrame = std::dynamic_pointer_cast<dai::ImgFrame>(slot.msg);
+        if (imgFrame) convert(stream, imgFrame, slot);
+        else slot.frame = cv::Mat();
+
+        stream.slots.publish();
+    }
+}
+
+void DeviceAcquisition::rollStats(Stream& stream, std::chrono::steady_clock::time_point now)
+{
+    float elapsed = std::chrono::duration<float>(now - stream.windowStart).count();
+    if (elapsed < 1.0f) return;
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stream.last.fps = stream.messages / elapsed;
+    stream.last.bytesPerSecond = stream.bytes / elapsed;
+    stream.last.convertMicros = stream.converted > 0 ? (float)stream.convertTime.count() / stream.converted : 0.0f;
+    stream.last.encoded = stream.encoded;
+
+    stream.messages = stream.bytes = stream.converted = 0;
+    stream.convertTime = std::chrono::microseconds(0);
+    stream.windowStart = now;
+}
+
+void DeviceAcquisition::checkProbe(Stream& stream, const std::vector<std::shared_ptr<dai::ADatatype>>& msgs)
+{
+    int64_t sent = stream.probeSent.load();
+    if (sent != stream.probeCounted)
+    {
+        stream.probeCounted = sent;
+        stream.probeFrames = 0;
+    }
+
+    for (const auto& msg : msgs)
+    {
+        int64_t sequenceNum, timestamp;
+        if (!stamp(msg, sequenceNum, timestamp)) continue;
+        stream.probeFrames++;
+
+        // frames captured before control was sent were already in flight
+        if (timestamp < sent) continue;
+
+        int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stream.last.controlLatencyMs = (now - sent) / 1000.0f;
+        stream.last.controlFrames = stream.probeFrames;
+        // newer probe replaced this one meanwhile
+        stream.probeSent.compare_exchange_strong(sent, 0);
+        return;
+    }
+}
+
+void DeviceAcquisition::probe(const std::string& stream, int64_t sent)
+{
+    auto it = streams.find(stream);
+    if (it == streams.end()) return;
+
+    it->second->probeSent.store(sent);
+}
+
+void DeviceAcquisition::convert(Stream& stream, const std::shared_ptr<dai::ImgFrame>& imgFrame, AcquiredMessage& slot)
+{
+    auto start = std::chrono::steady_clock::now();
+    convertFrame(imgFrame, slot);
+    stream.convertTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    stream.converted++;
+    stream.encoded = imgFrame->getType() == dai::ImgFrame::Type::BITSTREAM;
+}
+
+void DeviceAcquisition::addPending(Stream& stream, const std::shared_ptr<dai::ADatatype>& msg)
+{
+    Pending entry;
+    entry.msg = msg;
+    if (!stamp(msg, entry.sequenceNum, entry.timestamp))
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        bundleCounters.unmatchable++;
+        return;
+    }
+
+    stream.pending.push_back(entry);
+    if (stream.pending.size() > bundleBufferSize)
+    {
+        stream.pending.pop_front();
+        std::lock_guard<std::mutex> lock(statsMutex);
+        bundleCounters.dropped++;
+    }
+}
+
+void DeviceAcquisition::matchBundle()
+{
+    if (bundleStreams.empty()) return;
+
+    const std::deque<Pending>& references = bundleStreams[0]->pending;
+    std::vector<size_t> matched(bundleStreams.size(), 0);
+
+    // newest reference message with a match on every other stream. Closest timestamp wins
+    for (size_t r = references.size(); r-- > 0;)
+    {
+        const Pending& reference = references[r];
+        matched[0] = r;
+
+        bool complete = true;
+        for (size_t s = 1; s < bundleStreams.size() && complete; s++)
+        {
+            const std::deque<Pending>& pending = bundleStreams[s]->pending;
+            int64_t best = std::numeric_limits<int64_t>::max();
+            complete = false;
+            for (size_t i = 0; i < pending.size(); i++)
+            {
+                int64_t diff = std::abs(pending[i].timestamp - reference.timestamp);
+                bool candidate = bundleTolerance < 0 ? pending[i].sequenceNum == reference.sequenceNum : diff <= bundleTolerance;
+                if (!candidate || diff >= best) continue;
+                best = diff;
+                matched[s] = i;
+                complete = true;
+            }
+        }
+        if (!complete) continue;
+
+        AcquiredBundle& slot = bundles.back();
+        if (slot.names.size() != bundleNames.size()) slot.names = bundleNames;
+        slot.messages.resize(bundleStreams.size());
+        slot.sequenceNum = reference.sequenceNum;
+        slot.timestamp = reference.timestamp;
+
+        uint64_t stale = 0;
+        for (size_t s = 0; s < bundleStreams.size(); s++)
+        {
+            Stream& stream = *bundleStreams[s];
+            AcquiredMessage& message = slot.messages[s];
+            message.msg = stream.pending[matched[s]].msg;
+
+            auto imgFrame = std::dynamic_pointer_cast<dai::ImgFrame>(message.msg);
+            if (imgFrame) convert(stream, imgFrame, message);
+            else message.frame = cv::Mat();
+
+            // matched message and older ones are consumed
+            stale += matched[s];
+            stream.pending.erase(stream.pending.begin(), stream.pending.begin() + matched[s] + 1);
+        }
+        bundles.publish();
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        bundleCounters.bundles++;
+        bundleCounters.dropped += stale;
+        return;
+    }
+}
+
+AcquiredMessage* DeviceAcquisition::latest(const std::string& stream, bool* isNew)
+{
+    auto it = streams.find(stream);
+    if (it == streams.end()) return NULL;
+
+    Stream& s = *it->second;
+    bool updated = s.slots.update();
+    if (updated) s.received = true;
+    if (isNew != NULL) *isNew = updated;
+
+    if (!s.received) return NULL;
+    return &s.slots.front();
+}
+
+AcquiredBundle* DeviceAcquisition::bundle(bool* isNew)
+{
+    bool updated = bundles.update();
+    if (updated) bundleReceived = true;
+    if (isNew != NULL) *isNew = updated;
+
+    if (!bundleReceived) return NULL;
+    return &bundles.front();
+}
+
+BundleStats DeviceAcquisition::bundleStats()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return bundleCounters;
+}
+
+std::vector<std::pair<std::string, StreamStats>> DeviceAcquisition::stats()
+{
+    std::vector<std::pair<std::string, StreamStats>> all;
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (const auto& name : names)
+    {
+        StreamStats stats = streams[name]->last;
+        // stopped worker doesn't roll windows anymore
+        if (!running) stats.fps = stats.bytesPerSecond = 0.0f;
+        all.emplace_back(name, stats);
+    }
+    return all;
+}
+
+std::shared_ptr<dai::DataOutputQueue> DeviceAcquisition::output(const std::string& stream) const
+{
+    auto it = outputs.find(stream);
+    if (it == outputs.end()) return nullptr;
+    return it->second;
+}
+
+std::shared_ptr<dai::DataInputQueue> DeviceAcquisition::input(const std::string& stream) const
+{
+    auto it = inputs.find(stream);
+    if (it == inputs.end()) return nullptr;
+    return it->second;
+}
+
+std::shared_ptr<DeviceAcquisition> GetAcquisition(int deviceNum)
+{
+    if (!ValidDeviceNum(deviceNum)) return nullptr;
+    return std::atomic_load(&acquisitions[deviceNum]);
+}
+
+void StartAcquisition(int deviceNum, std::shared_ptr<dai::Device> device, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+    const BundlePolicy& bundle)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+    StopAcquisition(deviceNum);
+
+    std::shared_ptr<DeviceAcquisition> worker = std::make_shared<DeviceAcquisition>(device, policy, syncStreams, bundle);
+    worker->start();
+    std::atomic_store(&acquisitions[deviceNum], worker);
+}
+
+void StopAcquisition(int deviceNum)
+{
+    // keep instance alive until replaced, results calls holding it keep reading its last slots
+    std::shared_ptr<DeviceAcquisition> worker = GetAcquisition(deviceNum);
+    if (worker) worker->stop();
+}
+
+AcquiredMessage* GetAcquired(const std::shared_ptr<DeviceAcquisition>& acquisition, const std::string& stream, bool* isNew)
+{
+    if (isNew != NULL) *isNew = false;
+    if (!acquisition) return NULL;
+
+    return acquisition->latest(stream, isNew);
+}
+
+AcquiredBundle* GetBundle(const std::shared_ptr<DeviceAcquisition>& acquisition, bool* isNew)
+{
+    if (isNew != NULL) *isNew = false;
+    if (!acquisition) return NULL;
+
+    return acquisition->bundle(isNew);
+}
+
+BundleStats GetBundleStats(int deviceNum)
+{
+    std::shared_ptr<DeviceAcquisition> worker = GetAcquisition(deviceNum);
+    if (!worker) return BundleStats();
+    return worker->bundleStats();
+}
+
+std::shared_ptr<dai::DataOutputQueue> GetOutputQueue(int deviceNum, const std::string& stream)
+{
+    std::shared_ptr<DeviceAcquisition> worker = GetAcquisition(deviceNum);
+    if (!worker) return nullptr;
+    return worker->output(stream);
+}
+
+std::shared_ptr<dai::DataInputQueue> GetInputQueue(int deviceNum, const std::string& stream)
+{
+    std::shared_ptr<DeviceAcquisition> worker = GetAcquisition(deviceNum);
+    if (!worker) return nullptr;
+    return worker->input(stream);
+}
+
+void ProbeControl(int deviceNum, const std::string& stream, int64_t sent)
+{
+    std::shared_ptr<DeviceAcquisition> worker = GetAcquisition(deviceNum);
+    if (!worker) return;
+    worker->probe(stream, sent);
+}
+
+std::vector<std::pair<std::string, StreamStats>> GetStreamStats(int deviceNum)
+{
+    std::shared_ptr<DeviceAcquisition> worker = GetAcquisition(deviceNum);
+    if (!worker) return std::vector<std::pair<std::string, StreamStats>>();
+    return worker->stats();
+}
@@ -0,0 +1,232 @@
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "opencv2/core/hal/intrin.hpp"
+
+#include "depthai-unity/device/Colorizer.hpp"
+
+// histogram sampling step (pixels and rows) of equalized map and frame max
+static const int SCAN_STEP = 4;
+// temporal smoothing of equalized levels, avoids flicker between frames
+static const float LEVEL_SMOOTHING = 0.5f;
+
+// rgb -> Color32 memory order (r,g,b,a)
+static inline std::uint32_t packColor(std::uint8_t r, std::uint8_t g, std::uint8_t b)
+{
+    std::uint8_t c[4] = {r, g, b, 255};
+    std::uint32_t v;
+    std::memcpy(&v, c, 4);
+    return v;
+}
+
+static inline std::uint8_t unit(float v)
+{
+    return cv::saturate_cast<std::uint8_t>(std::min(1.0f, std::max(0.0f, v)) * 255.0f);
+}
+
+// 256 colors of map
+static std::vector<std::uint32_t> buildPalette(ColorMap map)
+{
+    std::vector<std::uint32_t> palette(256);
+    for (int i = 0; i < 256; i++)
+    {
+        float t = i / 255.0f;
+        switch (map)
+        {
+            case ColorMap::JET:
+                palette[i] = packColor(unit(1.5f - std::fabs(4.0f*t - 3.0f)), unit(1.5f - std::fabs(4.0f*t - 2.0f)), unit(1.5f - std::fabs(4.0f*t - 1.0f)));
+                break;
+            case ColorMap::TURBO:
+            {
+                // polynomial approximation of turbo color map
+                float r = 0.13572138f + t*(4.61539260f + t*(-42.66032258f + t*(132.13108234f + t*(-152.94239396f + t*59.28637943f))));
+                float g = 0.09140261f + t*(2.19418839f + t*(4.84296658f + t*(-14.18503333f + t*(4.27729857f + t*2.82956604f))));
+                float b = 0.10667330f + t*(12.64194608f + t*(-60.58204836f + t*(110.36276771f + t*(-89.90310912f + t*27.34824973f))));
+                palette[i] = packColor(unit(r), unit(g), unit(b));
+                break;
+            }
+            default:
+                palette[i] = packColor((std::uint8_t)i, (std::uint8_t)i, (std::uint8_t)i);
+                break;
+        }
+    }
+    return palette;
+}
+
+static const std::uint32_t* palette(ColorMap map)
+{
+    static const std::vector<std::uint32_t> gray = buildPalette(ColorMap::GRAY);
+    static const std::vector<std::uint32_t> jet = buildPalette(ColorMap::JET);
+    static const std::vector<std::uint32_t> turbo = buildPalette(ColorMap::TURBO);
+
+    switch (map)
+    {
+        case ColorMap::JET: return jet.data();
+        case ColorMap::TURBO: return turbo.data();
+        default: return gray.data();
+    }
+}
+
+// one row through lookup table
+template <typename T>
+static void rowLUT(const T* src, int w, const std::uint32_t* lut, std::uint32_t* dst)
+{
+    int x = 0;
+
+#if CV_SIMD128
+    if (cv::useOptimized())
+    {
+        const int* tab = (const int*) lut;
+        for (; x <= w - 8; x += 8)
+        {
+            cv::v_uint32x4 i0, i1;
+            if (sizeof(T) == 2)
+            {
+                cv::v_expand(cv::v_load((const unsigned short*)src + x), i0, i1);
+            }
+            else
+            {
+                i0 = cv::v_load_expand_q((const unsigned char*)src + x);
+                i1 = cv::v_load_expand_q((const unsigned char*)src + x + 4);
+            }
+            cv::v_store((unsigned*)dst + x, cv::v_reinterpret_as_u32(cv::v_lut(tab, cv::v_reinterpret_as_s32(i0))));
+            cv::v_store((unsigned*)dst + x + 4, cv::v_reinterpret_as_u32(cv::v_lut(tab, cv::v_reinterpret_as_s32(i1))));
+        }
+    }
+#endif
+
+    for (; x < w; x++) dst[x] = lut[src[x]];
+}
+
+template <typename T>
+static void applyLUT(const cv::Mat& frame, const std::uint32_t* lut, void* ptr)
+{
+    std::uint32_t* dst = (std::uint32_t*) ptr;
+    const int w = frame.cols;
+
+    auto rows = [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++) rowLUT(frame.ptr<T>(y), w, lut, dst + (size_t)y*w);
+    };
+
+    // small frames are not worth the thread handoff
+    if ((long)w * frame.rows < 640 * 360) rows(cv::Range(0, frame.rows));
+    else cv::parallel_for_(cv::Range(0, frame.rows), rows, cv::getNumThreads());
+}
+
+template <typename T>
+static int scanFrame(const cv::Mat& frame, int binShift, int* hist)
+{
+    int maxValue = 0;
+    for (int y = 0; y < frame.rows; y += SCAN_STEP)
+    {
+        const T* row = frame.ptr<T>(y);
+        for (int x = 0; x < frame.cols; x += SCAN_STEP)
+        {
+            int v = row[x];
+            maxValue = std::max(maxValue, v);
+            if (hist != NULL && v > 0) hist[v >> binShift]++;
+        }
+    }
+    return maxValue;
+}
+
+void Colorizer::scan(const cv::Mat& frame, bool histogram)
+{
+    if (histogram) std::fill(hist.begin(), hist.end(), 0);
+    int* h = histogram ? hist.data() : NULL;
+
+    if (frame.type() == CV_16UC1) frameMax = scanFrame<uint16_t>(frame, binShift, h);
+    else frameMax = scanFrame<std::uint8_t>(frame, binShift, h);
+}
+
+void Colorizer::updateLinear(ColorMap map, int range)
+{
+    if (map == lutMap && range == lutRange) return;
+
+    const std::uint32_t* colors = palette(map);
+    int size = (int) lut.size();
+    float scale = 255.0f / range;
+
+    lut[0] = packColor(0, 0, 0);
+    for (int v = 1; v < size; v++) lut[v] = colors[std::min(255, (int)(v * scale + 0.5f))];
+
+    lutMap = map;
+    lutRange = range;
+}
+
+void Colorizer::updateEqualized()
+{
+    int bins = (int) hist.size();
+    int total = 0;
+    for (int b = 0; b < bins; b++) total += hist[b];
+    if (total == 0) return;
+
+    // switching from another map: every entry is rewritten
+    bool full = lutMap != ColorMap::EQUALIZED;
+    const std::uint32_t* colors = palette(ColorMap::GRAY);
+    int binSize = 1 << binShift;
+    int size = (int) lut.size();
+
+    int cdf = 0;
+    for (int b = 0; b < bins; b++)
+    {
+        cdf += hist[b];
+        float target = 255.0f * cdf / total;
+        levels[b] = full ? target : levels[b] + (target - levels[b]) * LEVEL_SMOOTHING;
+
+        std::uint8_t level = cv::saturate_cast<std::uint8_t>(levels[b]);
+        if (!full && level == levelBytes[b]) continue;
+        levelBytes[b] = level;
+
+        int end = std::min(size, (b + 1) * binSize);
+        for (int v = b * binSize; v < end; v++) lut[v] = colors[level];
+    }
+
+    lut[0] = packColor(0, 0, 0);
+    lutMap = ColorMap::EQUALIZED;
+    lutRange = 0;
+}
+
+void Colorizer::colorize(const cv::Mat& frame, ColorMap map, float range, void* ptr)
+{
+    if (ptr == NULL || frame.empty() || (frame.type() != CV_16UC1 && frame.type() != CV_8UC1)) return;
+
+    // tables follow input type
+    if (frame.type() != lutType)
+    {
+        lutType = frame.type();
+        binShift = lutType == CV_16UC1 ? 4 : 0;
+        lut.assign(lutType == CV_16UC1 ? 65536 : 256, packColor(0, 0, 0));
+        hist.assign(lut.size() >> binShift, 0);
+        levels.assign(hist.size(), 0.0f);
+        levelBytes.assign(hist.size(), 0);
+        lutMap = ColorMap::DEFAULT;
+    }
+
+    if (map == ColorMap::EQUALIZED)
+    {
+        scan(frame, true);
+        updateEqualized();
+    }
+    else
+    {
+        int maxValue = (int) range;
+        if (maxValue <= 0)
+        {
+            // frame max rounded up, so table is not rebuilt for every small change
+            scan(frame, false);
+            int granularity = 1 << binShift;
+            maxValue = (frameMax + granularity*16 - 1) / (granularity*16) * (granularity*16);
+        }
+        updateLinear(map, std::max(1, std::min(maxValue, (int)lut.size() - 1)));
+    }
+
+    if (lutType == CV_16UC1) applyLUT<uint16_t>(frame, lut.data(), ptr);
+    else applyLUT<std::uint8_t>(frame, lut.data(), ptr);
+}
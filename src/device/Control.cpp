@@ -0,0 +1,174 @@
+#pragma GCC diagnostic ignored "-Wreturn-type-c-linkage"
+
+#if _MSC_VER // this is defined when compiling with Visual Studio
+#define EXPORT_API __declspec(dllexport) // Visual Studio needs annotating exported functions with this
+#else
+#define EXPORT_API // XCode does not need annotating exported functions, so define is empty
+#endif
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "depthai-unity/device/Control.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+
+// runtime control state of one device. Set by builder, updated by setters (Unity thread)
+struct DeviceControl
+{
+    std::mutex mutex;
+    // current stereo config on device
+    bool hasStereo = false;
+    dai::RawStereoDepthConfig stereo;
+    // spatial depth thresholds in mm, negative: pipeline default
+    float spatialLower = -1.0f;
+    float spatialUpper = -1.0f;
+};
+
+// same indexing as devices
+static DeviceControl controls[DAI_MAX_DEVICES];
+
+// send control and measure latency on affected streams
+static bool sendControl(int deviceNum, const char* input, std::shared_ptr<dai::ADatatype> msg, const std::vector<std::string>& streams)
+{
+    std::shared_ptr<dai::DataInputQueue> queue = GetInputQueue(deviceNum, input);
+    if (!queue) return false;
+
+    int64_t sent = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    queue->send(msg);
+    for (const auto& stream : streams) ProbeControl(deviceNum, stream, sent);
+    return true;
+}
+
+void AddCameraControl(dai::Pipeline& pipeline, int deviceNum, std::shared_ptr<dai::node::ColorCamera> colorCam)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    DeviceControl& control = controls[deviceNum];
+    {
+        std::lock_guard<std::mutex> lock(control.mutex);
+        control.hasStereo = false;
+        control.spatialLower = control.spatialUpper = -1.0f;
+    }
+
+    auto xinControl = pipeline.create<dai::node::XLinkIn>();
+    xinControl->setStreamName("colorControl");
+    xinControl->out.link(colorCam->inputControl);
+}
+
+void AddStereoControl(dai::Pipeline& pipeline, int deviceNum, std::shared_ptr<dai::node::StereoDepth> stereo)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    DeviceControl& control = controls[deviceNum];
+    {
+        std::lock_guard<std::mutex> lock(control.mutex);
+        control.hasStereo = true;
+        control.stereo = stereo->initialConfig.get();
+    }
+
+    auto xinConfig = pipeline.create<dai::node::XLinkIn>();
+    xinConfig->setStreamName("stereoConfig");
+    xinConfig->out.link(stereo->inputConfig);
+}
+
+void GetSpatialThresholds(int deviceNum, float& lower, float& upper)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    DeviceControl& control = controls[deviceNum];
+    std::lock_guard<std::mutex> lock(control.mutex);
+    if (control.spatialLower >= 0.0f) lower = control.spatialLower;
+    if (control.spatialUpper >= 0.0f) upper = control.spatialUpper;
+}
+
+// Interface with Unity C#
+extern "C"
+{
+    /**
+    * Change stereo config of running pipeline. Requires confidenceThreshold in pipeline creation.
+    *
+    * @param confidenceThreshold disparity confidence threshold 0-255
+    * @param medianFilter 0: off, 1: 3x3, 2: 5x5, 3: 7x7
+    * @param leftRightCheck enable left-right check
+    * @param deviceNum Device selection on unity dropdown
+    * @returns true if config was sent to device
+    */
+    EXPORT_API bool DAISetStereoConfig(int confidenceThreshold, int medianFilter, bool leftRightCheck, int deviceNum)
+    {
+        if (!ValidDeviceNum(deviceNum)) return false;
+
+        DeviceControl& control = controls[deviceNum];
+        auto config = std::make_shared<dai::StereoDepthConfig>();
+        {
+            std::lock_guard<std::mutex> lock(control.mutex);
+            if (!control.hasStereo) return false;
+
+            config->set(control.stereo);
+            config->setConfidenceThreshold(confidenceThreshold);
+            config->setMedianFilter(dai::MedianFilter::MEDIAN_OFF);
+            if (medianFilter == 1) config->setMedianFilter(dai::MedianFilter::KERNEL_3x3);
+            if (medianFilter == 2) config->setMedianFilter(dai::MedianFilter::KERNEL_5x5);
+            if (medianFilter == 3) config->setMedianFilter(dai::MedianFilter::KERNEL_7x7);
+            config->setLeftRightCheck(leftRightCheck);
+            control.stereo = config->get();
+        }
+
+        return sendControl(deviceNum, "stereoConfig", config, {"depth", "disparity"});
+    }
+
+    /**
+    * Change color camera focus of running pipeline
+    *
+    * @param manualFocus lens position 1-255. 0: continuous auto focus
+    * @param deviceNum Device selection on unity dropdown
+    * @returns true if control was sent to device
+    */
+    EXPORT_API bool DAISetCameraFocus(int manualFocus, int deviceNum)
+    {
+        auto control = std::make_shared<dai::CameraControl>();
+        if (manualFocus > 0) control->setManualFocus((uint8_t) std::min(manualFocus, 255));
+        else control->setAutoFocusMode(dai::CameraControl::AutoFocusMode::CONTINUOUS_VIDEO);
+
+        return sendControl(deviceNum, "colorControl", control, {"preview"});
+    }
+
+    /**
+    * Change color camera exposure of running pipeline
+    *
+    * @param exposureTimeUs exposure time in microseconds. 0: auto exposure
+    * @param sensitivityIso sensitivity as ISO value (100-1600)
+    * @param deviceNum Device selection on unity dropdown
+    * @returns true if control was sent to device
+    */
+    EXPORT_API bool DAISetCameraExposure(int exposureTimeUs, int sensitivityIso, int deviceNum)
+    {
+        auto control = std::make_shared<dai::CameraControl>();
+        if (exposureTimeUs > 0) control->setManualExposure((uint32_t) exposureTimeUs, (uint32_t) sensitivityIso);
+        else control->setAutoExposureEnable();
+
+        return sendControl(deviceNum, "colorControl", control, {"preview"});
+    }
+
+    /**
+    * Change spatial depth thresholds. Used from next results call for ROIs sent to device and host spatial computation
+    *
+    * @param lowerThreshold min depth in mm. Negative: pipeline default
+    * @param upperThreshold max depth in mm. Negative: pipeline default
+    * @param deviceNum Device selection on unity dropdown
+    */
+    EXPORT_API void DAISetSpatialThresholds(float lowerThreshold, float upperThreshold, int deviceNum)
+    {
+        if (!ValidDeviceNum(deviceNum)) return;
+
+        DeviceControl& control = controls[deviceNum];
+        std::lock_guard<std::mutex> lock(control.mutex);
+        control.spatialLower = lowerThreshold;
+        control.spatialUpper = upperThreshold;
+    }
+}
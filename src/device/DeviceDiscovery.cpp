@@ -0,0 +1,200 @@
+#pragma GCC diagnostic ignored "-Wreturn-type-c-linkage"
+
+#if _MSC_VER // this is defined when compiling with Visual Studio
+#define EXPORT_API __declspec(dllexport) // Visual Studio needs annotating exported functions with this
+#else
+#define EXPORT_API // XCode does not need annotating exported functions, so define is empty
+#endif
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <exception>
+
+#include "depthai/xlink/XLinkConnection.hpp"
+
+#include "depthai-unity/device/DeviceDiscovery.hpp"
+
+DeviceDiscovery& DeviceDiscovery::instance()
+{
+    static DeviceDiscovery discovery;
+    return discovery;
+}
+
+DeviceDiscovery::~DeviceDiscovery()
+{
+    stop();
+}
+
+void DeviceDiscovery::start()
+{
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        running = true;
+        first = !hasScan;
+    }
+
+    // dropdown is not empty on first listing
+    if (first) scan();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running && !thread.joinable()) thread = std::thread(&DeviceDiscovery::run, this);
+}
+
+void DeviceDiscovery::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+void DeviceDiscovery::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        // next scan DAI_DISCOVERY_INTERVAL_MS after last one, scans requested by claims count too
+        auto next = scanned + std::chrono::milliseconds(DAI_DISCOVERY_INTERVAL_MS);
+        if (wake.wait_until(lock, next, [this] { return !running; })) break;
+        if (std::chrono::steady_clock::now() < scanned + std::chrono::milliseconds(DAI_DISCOVERY_INTERVAL_MS)) continue;
+
+        lock.unlock();
+        scan();
+        lock.lock();
+    }
+}
+
+std::vector<dai::DeviceInfo> DeviceDiscovery::scan()
+{
+    std::lock_guard<std::mutex> scanLock(scanMutex);
+
+    std::vector<dai::DeviceInfo> found;
+    try
+    {
+        found = dai::XLinkConnection::getAllConnectedDevices();
+    }
+    catch (const std::exception&)
+    {
+        // XLink not ready, devices are kept until lost
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    update(found, std::chrono::steady_clock::now());
+    return presentDevices();
+}
+
+void DeviceDiscovery::update(const std::vector<dai::DeviceInfo>& found, std::chrono::steady_clock::time_point now)
+{
+    bool changed = false;
+    std::vector<bool> wasPresent;
+    for (auto& d : table)
+    {
+        wasPresent.push_back(d.present);
+        d.present = false;
+    }
+
+    for (const auto& info : found)
+    {
+        std::string deviceId = info.getMxId();
+        auto it = std::find_if(table.begin(), table.end(), [&deviceId](const DiscoveredDevice& d) { return d.deviceId == deviceId; });
+        if (it == table.end())
+        {
+            DiscoveredDevice d;
+            d.deviceId = deviceId;
+            d.firstSeen = now;
+            table.push_back(d);
+            it = table.end() - 1;
+            changed = true;
+        }
+        else if (it->info.state != info.state) changed = true;
+
+        it->info = info;
+        it->present = true;
+        it->lastSeen = now;
+    }
+
+    // device lost
+    for (size_t i = 0; i < wasPresent.size(); i++)
+    {
+        if (wasPresent[i] && !table[i].present) changed = true;
+    }
+
+    // lost devices are removed after DAI_DISCOVERY_LOST_MS
+    auto lost = std::remove_if(table.begin(), table.end(), [now](const DiscoveredDevice& d)
+    {
+        return !d.present && now - d.lastSeen > std::chrono::milliseconds(DAI_DISCOVERY_LOST_MS);
+    });
+    if (lost != table.end())
+    {
+        table.erase(lost, table.end());
+        changed = true;
+    }
+
+    if (changed) tableSequence++;
+    scanned = now;
+    hasScan = true;
+}
+
+std::vector<dai::DeviceInfo> DeviceDiscovery::presentDevices() const
+{
+    std::vector<dai::DeviceInfo> devices;
+    for (const auto& d : table)
+    {
+        if (d.present) devices.push_back(d.info);
+    }
+    return devices;
+}
+
+std::vector<DiscoveredDevice> DeviceDiscovery::snapshot(uint64_t* sequence)
+{
+    start();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sequence != nullptr) *sequence = tableSequence;
+    return table;
+}
+
+uint64_t DeviceDiscovery::sequence()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tableSequence;
+}
+
+std::vector<dai::DeviceInfo> DeviceDiscovery::devices(int maxAgeMs)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (maxAgeMs > 0 && hasScan && std::chrono::steady_clock::now() - scanned <= std::chrono::milliseconds(maxAgeMs)) return presentDevices();
+    }
+    return scan();
+}
+
+// Interface with Unity C#
+extern "C"
+{
+    /**
+    * Sequence of device table (GetAllDevices), increases when a device is found, lost or changes state.
+    * Device list only needs to be read again when sequence changes
+    *
+    * @returns table sequence, starts discovery if needed
+    */
+    EXPORT_API long long DAIGetDiscoverySequence()
+    {
+        DeviceDiscovery::instance().start();
+        return (long long) DeviceDiscovery::instance().sequence();
+    }
+
+    /**
+    * Stop background discovery (e.g. once devices are running). Restarted by next GetAllDevices
+    */
+    EXPORT_API void DAIStopDiscovery()
+    {
+        DeviceDiscovery::instance().stop();
+    }
+}
@@ -22,39 +22,62 @@
 #include "depthai/xlink/XLinkConnection.hpp"
 
 #include "depthai-unity/device/DeviceManager.hpp"
+#include "depthai-unity/device/DeviceRegistry.hpp"
+#include "depthai-unity/device/DeviceDiscovery.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/IMU.hpp"
+#include "depthai-unity/device/SysInfo.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
 #include "nlohmann/json.hpp"
 
-// Multiple device support (up to 10)
-std::shared_ptr<dai::Device> devices[10];
-// Device state 
-bool deviceRunning[10];
-
-// Get device pointer
+// Get device pointer, nullptr until device runs pipeline
 std::shared_ptr<dai::Device> GetDevice(int deviceNum)
 {
-    return devices[deviceNum];
+    return DeviceRegistry::instance().device(deviceNum);
 }
 
 // getter for device state
 bool IsDeviceRunning(int deviceNum)
 {
-    return deviceRunning[deviceNum];
+    return DeviceRegistry::instance().running(deviceNum);
 }
 
-// get all connected devices and states
+// get all connected devices and states. Cached by discovery thread, doesn't scan XLink
 std::vector<dai::DeviceInfo> DAIGetAllDevices() {
     std::vector<dai::DeviceInfo> availableDevices;
-    auto connectedDevices = dai::XLinkConnection::getAllConnectedDevices();
-    for(const auto& d : connectedDevices) {
-        availableDevices.push_back(d);
+    for(const auto& d : DeviceDiscovery::instance().snapshot()) {
+        if (d.present) availableDevices.push_back(d.info);
     }
     return availableDevices;
 }
 
+static const char* deviceStateName(XLinkDeviceState_t state)
+{
+    switch (state)
+    {
+        case X_LINK_BOOTED: return "BOOTED";
+        case X_LINK_UNBOOTED: return "UNBOOTED";
+        case X_LINK_BOOTLOADER: return "BOOTLOADER";
+        default: return "UNKNOWN";
+    }
+}
+
+static const char* transportName(XLinkProtocol_t protocol)
+{
+    switch (protocol)
+    {
+        case X_LINK_USB_VSC:
+        case X_LINK_USB_CDC: return "USB";
+        case X_LINK_PCIE: return "PCIE";
+        case X_LINK_TCP_IP: return "TCP_IP";
+        case X_LINK_IPC: return "IPC";
+        default: return "UNKNOWN";
+    }
+}
+
 // Available = No booted
 bool CheckForAvailableDevice(const char* deviceId)
 {
@@ -85,107 +108,111 @@ bool CheckForAvailableDevice(const char* deviceId)
 
 // start pipeline 
 bool DAIStartPipeline(dai::Pipeline pipeline, int deviceNum, const char* deviceId)
-{   
-    bool res = false, found = false;
-    std::shared_ptr<dai::Device> device;
-    dai::DeviceInfo deviceInfo;
-    
-    // Find specific or first available device
-    if (CheckForAvailableDevice(deviceId))
+{
+    return DAIStartPipeline(pipeline, deviceNum, deviceId, StreamPolicy());
+}
+
+// claim device and boot it, then start acquisition of all output streams except syncStreams and collectors
+static bool startPipeline(dai::Pipeline pipeline, int deviceNum, const char* deviceId, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+    const BundlePolicy& bundle, DeviceRegistry::StartedCallback onStarted, bool async)
+{
+    // runs on boot thread if async, before device is reported as running
+    auto started = [deviceNum, policy, syncStreams, bundle, onStarted](std::shared_ptr<dai::Device> device)
     {
-        // Start pipeline
-        if (deviceId == NULL) device = std::shared_ptr<dai::Device>(new dai::Device(pipeline));
-        else 
+        try
         {
-            std::tie(found, deviceInfo) = dai::Device::getDeviceByMxId(deviceId);
-            if (!found) return false;
-            device = std::shared_ptr<dai::Device>(new dai::Device(pipeline,deviceInfo));
+            // background acquisition of output streams, every IMU report and system information collected
+            StartAcquisition(deviceNum, device, policy, syncStreams, bundle);
+            StartIMU(deviceNum, GetOutputQueue(deviceNum, "imu"));
+            StartSysInfo(deviceNum, GetOutputQueue(deviceNum, "sysinfo"));
+            if (onStarted) onStarted(device);
         }
-        
-        // assign device and status
-        devices[deviceNum] = device;
-        deviceRunning[deviceNum] = true;
-        res = true;
-    }
+        catch (...)
+        {
+            // boot fails and registry closes device, nothing may keep reading it
+            StopIMU(deviceNum);
+            StopSysInfo(deviceNum);
+            StopAcquisition(deviceNum);
+            throw;
+        }
+    };
 
-    return res;
+    return DeviceRegistry::instance().start(deviceNum, pipeline, deviceId, started, async);
 }
 
-// get device system info. Needs pipeline definition. Predefined queue "sysinfo"
-nlohmann::json GetDeviceInfo(std::shared_ptr<dai::Device> device)
+// start pipeline and acquisition of all output streams except syncStreams
+bool DAIStartPipeline(dai::Pipeline pipeline, int deviceNum, const char* deviceId, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+    const BundlePolicy& bundle)
 {
-    std::shared_ptr<dai::DataOutputQueue> qSysInfo;
-    
-    qSysInfo = device->getOutputQueue("sysinfo", 4, false);
-    auto sysInfo = qSysInfo->get<dai::SystemInformation>();
-
-    dai::SystemInformation info = *sysInfo;             
-
-    nlohmann::json infoJson = {};
-
-    infoJson["ddr_used"] = info.ddrMemoryUsage.used / (1024.0f * 1024.0f);
-    infoJson["ddr_total"] = info.ddrMemoryUsage.total / (1024.0f * 1024.0f);
-    infoJson["leoncss_heap_used"] = info.leonCssMemoryUsage.used / (1024.0f * 1024.0f);
-    infoJson["leoncss_heap_total"] = info.leonCssMemoryUsage.total / (1024.0f * 1024.0f);
-    infoJson["leonmss_heap_used"] = info.leonMssMemoryUsage.used / (1024.0f * 1024.0f);
-    infoJson["leonmss_heap_total"] = info.leonMssMemoryUsage.total / (1024.0f * 1024.0f);
-    infoJson["cmx_used"] = info.cmxMemoryUsage.used / (1024.0f * 1024.0f);
-    infoJson["cmx_total"] = info.cmxMemoryUsage.total / (1024.0f * 1024.0f);
-    const auto& t = info.chipTemperature;
-    infoJson["chip_temp_avg"] = t.average;
-    infoJson["cpu_usage"] = info.leonCssCpuUsage.average * 100;
-
-    return infoJson;
+    return startPipeline(pipeline, deviceNum, deviceId, policy, syncStreams, bundle, nullptr, false);
 }
 
-// get IMU info. Needs IMU and pipeline definition. Predefined queue "imu"
-nlohmann::json GetIMU(std::shared_ptr<dai::Device> device)
+// claim device and boot it on background thread
+bool DAIStartPipelineAsync(dai::Pipeline pipeline, int deviceNum, const char* deviceId, const StreamPolicy& policy, const std::vector<std::string>& syncStreams,
+    const BundlePolicy& bundle, DeviceRegistry::StartedCallback onStarted)
 {
-    nlohmann::json imuJson = {};
-
-    auto imuQueue = device->getOutputQueue("imu", 50, false);
-    auto imuData = imuQueue->get<dai::IMUData>();
-
-    auto imuPackets = imuData->packets;
-    for(auto& imuPacket : imuPackets) {
-        auto& rVvalues = imuPacket.rotationVector;
-        imuJson["I"] = rVvalues.i;
-        imuJson["J"] = rVvalues.j;
-        imuJson["K"] = rVvalues.k;
-        imuJson["Real"] = rVvalues.real;
-        imuJson["Accuracy"] = rVvalues.rotationVectorAccuracy;
-    }
+    return startPipeline(pipeline, deviceNum, deviceId, policy, syncStreams, bundle, onStarted, true);
+}
+
+// get device system info. Needs pipeline definition. Messages of predefined queue "sysinfo" are cached by sysinfo collector
+void GetDeviceInfo(int deviceNum, SysInfoResult& sysinfo)
+{
+    sysinfo.valid = 0;
 
-    return imuJson;
+    SysInfoSample sample;
+    if (GetSysInfo(deviceNum, sample)) sysinfo = sample.info;
+}
+
+// get IMU info. Needs IMU and pipeline definition. Reports of predefined queue "imu" are kept by IMU collector
+void GetIMU(int deviceNum, IMUResult& imu, int64_t timestamp)
+{
+    imu.valid = 0;
+
+    IMUSample rv;
+    if (!GetIMUAt(deviceNum, IMU_ROTATION_VECTOR, timestamp, rv)) return;
+
+    imu.i = rv.x;
+    imu.j = rv.y;
+    imu.k = rv.z;
+    imu.real = rv.w;
+    imu.accuracy = rv.accuracy;
+    imu.valid = 1;
 }
 
 // Interface with Unity C#
 extern "C"
 {
     /**
-    * Get list of all devices connected and status
+    * Get list of all devices connected and status. Snapshot of discovery table (started on first call), doesn't scan XLink
     *
-    * @returns Json with device info and status. To be shown on device manager (unity)
+    * @returns Json with device info and status. To be shown on device manager (unity). "null" if no device was found
+    * deviceState: AVAILABLE, BOOTED or LOST (missing from last scan). state: XLink state. lastSeenMs: time since device was seen
+    * Owned by plugin, valid until next call
     */
     EXPORT_API const char* GetAllDevices()
     {
-        std::vector<dai::DeviceInfo> allDevices = DAIGetAllDevices();
-        nlohmann::json devicesArr = {};
+        static JsonWriter json;
 
+        std::vector<DiscoveredDevice> allDevices = DeviceDiscovery::instance().snapshot();
+        if (allDevices.empty()) return "null";
+
+        auto now = std::chrono::steady_clock::now();
+        json.clear();
+        json.beginArray();
         for(const auto& d : allDevices) {
-            nlohmann::json deviceJson;
-            deviceJson["deviceId"] = d.getMxId().c_str();
-            //deviceJson["deviceName"] = d.desc.name;
-            deviceJson["deviceState"] = "AVAILABLE";
-            if (d.state == X_LINK_BOOTED) deviceJson["deviceState"] = "BOOTED";
-            devicesArr.push_back(deviceJson);
+            json.beginObject();
+            json.field("deviceId", d.deviceId);
+            json.field("deviceName", d.info.desc.name);
+            json.field("deviceState", !d.present ? "LOST" : (d.info.state == X_LINK_BOOTED ? "BOOTED" : "AVAILABLE"));
+            json.field("state", deviceStateName(d.info.state));
+            json.field("transport", transportName(d.info.desc.protocol));
+            json.field("lastSeenMs", (int) std::chrono::duration_cast<std::chrono::milliseconds>(now - d.lastSeen).count());
+            json.endObject();
         }
-       
-        // serialize json and return to Unity
-        char* ret = (char*)::malloc(strlen(devicesArr.dump().c_str())+1);
-        ::memcpy(ret, devicesArr.dump().c_str(),strlen(devicesArr.dump().c_str()));
-        ret[strlen(devicesArr.dump().c_str())] = 0;
-        return ret;
+        json.endArray();
+
+        // serialized json returned to Unity
+        return json.c_str();
     }
 
     /**
@@ -196,15 +223,86 @@ extern "C"
 
     EXPORT_API void DAICloseDevice(int deviceNum)
     {
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+        // waits for boot in progress
+        std::shared_ptr<dai::Device> device = DeviceRegistry::instance().release(deviceNum);
         if (device == NULL) return;
 
-        // check device is running before closing
-        if (deviceRunning[deviceNum])
+        StopIMU(deviceNum);
+        StopSysInfo(deviceNum);
+        StopAcquisition(deviceNum);
+        device->close();
+    }
+
+    /**
+    * Boot of every started device: state and time spent on enumeration, boot (firmware and pipeline upload) and start
+    *
+    * @returns Json array {"deviceNum","deviceId","state","enumerate_ms","boot_ms","start_ms","error"}. state: BOOTING, RUNNING, FAILED
+    * Owned by plugin, valid until next call
+    */
+    EXPORT_API const char* DAIGetBootInfo()
+    {
+        static JsonWriter json;
+
+        json.clear();
+        json.beginArray();
+        for (const auto& info : DeviceRegistry::instance().bootInfo())
         {
-            deviceRunning[deviceNum] = false;
-            device->close();
+            json.beginObject();
+            json.field("deviceNum", info.deviceNum);
+            json.field("deviceId", info.deviceId);
+            json.field("state", info.state == DEVICE_RUNNING ? "RUNNING" : (info.state == DEVICE_FAILED ? "FAILED" : "BOOTING"));
+            json.field("enumerate_ms", info.enumerateMs);
+            json.field("boot_ms", info.bootMs);
+            json.field("start_ms", info.startMs);
+            json.field("error", info.error);
+            json.endObject();
         }
+        json.endArray();
+
+        return json.c_str();
+    }
+
+    /**
+    * Stats of streams acquired for device: fps, link bandwidth and host conversion time (decode of encoded streams)
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @returns Json object per stream {"fps","kbps","convert_us","encoded"} and bundle counters {"bundles","dropped","unmatchable"}.
+    * Streams affected by a runtime control (Control.hpp) add {"control_ms","control_frames"} of last control.
+    * Owned by plugin, valid until next call
+    */
+    EXPORT_API const char* DAIStreamStats(int deviceNum)
+    {
+        static JsonWriter json[DAI_MAX_DEVICES];
+        if (!ValidDeviceNum(deviceNum)) return "{}";
+
+        json[deviceNum].clear();
+        json[deviceNum].beginObject();
+        for (const auto& stream : GetStreamStats(deviceNum))
+        {
+            json[deviceNum].key(stream.first.c_str());
+            json[deviceNum].beginObject();
+            json[deviceNum].field("fps", stream.second.fps);
+            json[deviceNum].field("kbps", stream.second.bytesPerSecond * 8.0f / 1000.0f);
+            json[deviceNum].field("convert_us", stream.second.convertMicros);
+            json[deviceNum].field("encoded", stream.second.encoded);
+            if (stream.second.controlLatencyMs >= 0.0f)
+            {
+                json[deviceNum].field("control_ms", stream.second.controlLatencyMs);
+                json[deviceNum].field("control_frames", stream.second.controlFrames);
+            }
+            json[deviceNum].endObject();
+        }
+
+        BundleStats bundle = GetBundleStats(deviceNum);
+        json[deviceNum].key("bundle");
+        json[deviceNum].beginObject();
+        json[deviceNum].field("bundles", (int) bundle.bundles);
+        json[deviceNum].field("dropped", (int) bundle.dropped);
+        json[deviceNum].field("unmatchable", (int) bundle.unmatchable);
+        json[deviceNum].endObject();
+        json[deviceNum].endObject();
+
+        return json[deviceNum].c_str();
     }
 
     /**
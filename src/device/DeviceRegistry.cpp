@@ -0,0 +1,197 @@
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <chrono>
+#include <exception>
+
+#include "depthai/device/Device.hpp"
+
+#include "depthai-unity/device/DeviceRegistry.hpp"
+
+static float millisSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+DeviceRegistry& DeviceRegistry::instance()
+{
+    static DeviceRegistry registry;
+    return registry;
+}
+
+DeviceRegistry::~DeviceRegistry()
+{
+    // boot threads must not outlive registry
+    for (auto& it : entries)
+    {
+        if (it.second->boot.joinable()) it.second->boot.join();
+    }
+}
+
+std::vector<dai::DeviceInfo> DeviceRegistry::scan(bool force)
+{
+    return DeviceDiscovery::instance().devices(force ? 0 : DAI_ENUMERATION_MAX_AGE_MS);
+}
+
+bool DeviceRegistry::claim(const std::vector<dai::DeviceInfo>& enumeration, const char* deviceId, dai::DeviceInfo& deviceInfo)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& d : enumeration)
+    {
+        if (d.state == X_LINK_BOOTED) continue;
+
+        std::string mxId = d.getMxId();
+        if (claimed.count(mxId) > 0) continue;
+        if (deviceId != NULL && mxId != deviceId) continue;
+
+        deviceInfo = d;
+        claimed.insert(mxId);
+        return true;
+    }
+    return false;
+}
+
+bool DeviceRegistry::start(int deviceNum, dai::Pipeline pipeline, const char* deviceId, StartedCallback onStarted, bool async)
+{
+    // per device tables of every module are indexed by deviceNum
+    if (!ValidDeviceNum(deviceNum)) return false;
+
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    entry->info.deviceNum = deviceNum;
+    bool force;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = entries.find(deviceNum);
+        if (it != entries.end())
+        {
+            if (it->second->info.state != DEVICE_FAILED) return false;
+            // failed boot thread is done once state is set
+            if (it->second->boot.joinable()) it->second->boot.join();
+            entries.erase(it);
+        }
+        closed.erase(deviceNum);
+
+        // reserve deviceNum (booting, not running) while scanning without lock
+        entries[deviceNum] = entry;
+        force = forceScan;
+        forceScan = false;
+    }
+
+    // discovery table, scanned again if requested device is not in it. XLink scan doesn't hold registry lock,
+    // device()/running() of running devices are called on every results call
+    auto scanStart = std::chrono::steady_clock::now();
+    dai::DeviceInfo deviceInfo;
+    bool found = claim(scan(force), deviceId, deviceInfo) || claim(scan(true), deviceId, deviceInfo);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // released while scanning
+        auto it = entries.find(deviceNum);
+        bool reserved = it != entries.end() && it->second == entry;
+        if (!found || !reserved)
+        {
+            if (found) claimed.erase(deviceInfo.getMxId());
+            if (reserved) entries.erase(it);
+            return false;
+        }
+
+        entry->info.deviceId = deviceInfo.getMxId();
+        entry->info.enumerateMs = millisSince(scanStart);
+
+        if (async)
+        {
+            entry->boot = std::thread(&DeviceRegistry::boot, this, entry, pipeline, deviceInfo, onStarted);
+            return true;
+        }
+    }
+
+    boot(entry, pipeline, deviceInfo, onStarted);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return entry->info.state == DEVICE_RUNNING;
+}
+
+void DeviceRegistry::boot(std::shared_ptr<Entry> entry, dai::Pipeline pipeline, dai::DeviceInfo deviceInfo, StartedCallback onStarted)
+{
+    std::shared_ptr<dai::Device> device;
+    std::string error;
+    float bootMs = 0.0f, startMs = 0.0f;
+
+    auto bootStart = std::chrono::steady_clock::now();
+    try
+    {
+        device = std::shared_ptr<dai::Device>(new dai::Device(pipeline, deviceInfo));
+        bootMs = millisSince(bootStart);
+
+        auto started = std::chrono::steady_clock::now();
+        if (onStarted) onStarted(device);
+        startMs = millisSince(started);
+    }
+    catch (const std::exception& e)
+    {
+        // started callback stops what it started on device, close it even if a stopped worker still holds it
+        error = e.what();
+        if (device) device->close();
+        device = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entry->device = device;
+    entry->info.bootMs = bootMs;
+    entry->info.startMs = startMs;
+    entry->info.error = error;
+    entry->info.state = device ? DEVICE_RUNNING : DEVICE_FAILED;
+    if (!device)
+    {
+        // device could be gone, don't trust discovery table
+        claimed.erase(entry->info.deviceId);
+        forceScan = true;
+    }
+}
+
+std::shared_ptr<dai::Device> DeviceRegistry::release(int deviceNum)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(deviceNum);
+        if (it == entries.end()) return nullptr;
+        entry = it->second;
+        entries.erase(it);
+    }
+
+    // boot in progress
+    if (entry->boot.joinable()) entry->boot.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    closed[deviceNum] = entry->info;
+    claimed.erase(entry->info.deviceId);
+    // device state changes once closed
+    forceScan = true;
+    return entry->device;
+}
+
+std::shared_ptr<dai::Device> DeviceRegistry::device(int deviceNum)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(deviceNum);
+    if (it == entries.end() || it->second->info.state != DEVICE_RUNNING) return nullptr;
+    return it->second->device;
+}
+
+bool DeviceRegistry::running(int deviceNum)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(deviceNum);
+    return it != entries.end() && it->second->info.state == DEVICE_RUNNING;
+}
+
+std::vector<DeviceBootInfo> DeviceRegistry::bootInfo()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<DeviceBootInfo> all;
+    for (const auto& it : entries) all.push_back(it.second->info);
+    for (const auto& it : closed) all.push_back(it.second);
+    return all;
+}
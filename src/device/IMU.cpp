@@ -0,0 +1,260 @@
+#pragma GCC diagnostic ignored "-Wreturn-type-c-linkage"
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+#if _MSC_VER // this is defined when compiling with Visual Studio
+#define EXPORT_API __declspec(dllexport) // Visual Studio needs annotating exported functions with this
+#else
+#define EXPORT_API // XCode does not need annotating exported functions, so define is empty
+#endif
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "depthai-unity/device/IMU.hpp"
+
+// samples copied to interpolate at a timestamp (~400 ms with 3 sensors at 400 hz)
+#define IMU_INTERPOLATION_WINDOW 512
+
+void IMURing::push(const IMUSample& sample)
+{
+    uint64_t index = writeIndex.load(std::memory_order_relaxed);
+    slots[index % CAPACITY] = sample;
+    writeIndex.store(index + 1, std::memory_order_release);
+}
+
+size_t IMURing::read(uint64_t& cursor, IMUSample* samples, size_t maxSamples) const
+{
+    uint64_t last = writeIndex.load(std::memory_order_acquire);
+    // cursor of previous ring
+    if (cursor > last) cursor = last;
+
+    uint64_t first = cursor;
+    if (last - first > maxSamples) first = last - maxSamples;
+    if (last - first > CAPACITY) first = last - CAPACITY;
+    for (uint64_t i = first; i < last; i++) samples[i - first] = slots[i % CAPACITY];
+
+    // samples overwritten while copying (including slot being written now) are discarded
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t written = writeIndex.load(std::memory_order_relaxed);
+    uint64_t valid = written + 1 > CAPACITY ? written + 1 - CAPACITY : 0;
+    size_t count = (size_t)(last - first);
+    size_t skip = valid > first ? (size_t) std::min<uint64_t>(valid - first, count) : 0;
+    if (skip > 0) std::memmove(samples, samples + skip, (count - skip) * sizeof(IMUSample));
+
+    cursor = last;
+    return count - skip;
+}
+
+// collector of one device. Callback runs on depthai queue thread
+struct IMUCollector
+{
+    std::shared_ptr<dai::DataOutputQueue> queue;
+    int callbackId = -1;
+};
+
+// last sequence per sensor, packets repeat the last report of sensors with lower rate
+struct IMUSequences
+{
+    bool seen[3] = {false, false, false};
+    int32_t sequence[3] = {0, 0, 0};
+};
+
+// same indexing as devices. Rings are swapped atomically, readers keep ring alive while reading
+static std::shared_ptr<IMURing> rings[DAI_MAX_DEVICES];
+static IMUCollector collectors[DAI_MAX_DEVICES];
+static uint64_t cursors[DAI_MAX_DEVICES];
+
+static bool isNewReport(const dai::IMUReport& report, int sensor, IMUSequences& sequences)
+{
+    // sensor not enabled
+    if (report.getTimestamp().time_since_epoch().count() == 0) return false;
+    if (sequences.seen[sensor] && report.sequence == sequences.sequence[sensor]) return false;
+
+    sequences.seen[sensor] = true;
+    sequences.sequence[sensor] = report.sequence;
+    return true;
+}
+
+static IMUSample makeSample(const dai::IMUReport& report, int sensor, float accuracy, float x, float y, float z, float w)
+{
+    IMUSample sample;
+    sample.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(report.getTimestamp().time_since_epoch()).count();
+    sample.sensor = sensor;
+    sample.accuracy = accuracy;
+    sample.x = x;
+    sample.y = y;
+    sample.z = z;
+    sample.w = w;
+    return sample;
+}
+
+static void collect(IMURing& ring, IMUSequences& sequences, const dai::IMUData& imuData)
+{
+    for (const auto& packet : imuData.packets)
+    {
+        const auto& acc = packet.acceleroMeter;
+        if (isNewReport(acc, IMU_ACCELEROMETER, sequences))
+            ring.push(makeSample(acc, IMU_ACCELEROMETER, (float) acc.accuracy, acc.x, acc.y, acc.z, 0.0f));
+
+        const auto& gyro = packet.gyroscope;
+        if (isNewReport(gyro, IMU_GYROSCOPE, sequences))
+            ring.push(makeSample(gyro, IMU_GYROSCOPE, (float) gyro.accuracy, gyro.x, gyro.y, gyro.z, 0.0f));
+
+        const auto& rv = packet.rotationVector;
+        if (isNewReport(rv, IMU_ROTATION_VECTOR, sequences))
+            ring.push(makeSample(rv, IMU_ROTATION_VECTOR, rv.rotationVectorAccuracy, rv.i, rv.j, rv.k, rv.real));
+    }
+}
+
+void StartIMU(int deviceNum, std::shared_ptr<dai::DataOutputQueue> queue)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+    StopIMU(deviceNum);
+    if (!queue) return;
+
+    auto ring = std::make_shared<IMURing>();
+    auto sequences = std::make_shared<IMUSequences>();
+    std::atomic_store(&rings[deviceNum], ring);
+    cursors[deviceNum] = 0;
+
+    collectors[deviceNum].queue = queue;
+    collectors[deviceNum].callbackId = queue->addCallback([ring, sequences](std::shared_ptr<dai::ADatatype> msg)
+    {
+        auto imuData = std::dynamic_pointer_cast<dai::IMUData>(msg);
+        if (imuData) collect(*ring, *sequences, *imuData);
+    });
+}
+
+void StopIMU(int deviceNum)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    IMUCollector& collector = collectors[deviceNum];
+    if (collector.queue && collector.callbackId >= 0) collector.queue->removeCallback(collector.callbackId);
+    collector.queue = nullptr;
+    collector.callbackId = -1;
+}
+
+size_t GetIMUSamples(int deviceNum, IMUSample* samples, size_t maxSamples)
+{
+    if (!ValidDeviceNum(deviceNum)) return 0;
+
+    std::shared_ptr<IMURing> ring = std::atomic_load(&rings[deviceNum]);
+    if (!ring || samples == NULL || maxSamples == 0) return 0;
+
+    return ring->read(cursors[deviceNum], samples, maxSamples);
+}
+
+// shortest path spherical interpolation of unit quaternions (x, y, z, w)
+static void slerp(const IMUSample& a, const IMUSample& b, float t, IMUSample& out)
+{
+    float dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    float sign = dot < 0.0f ? -1.0f : 1.0f;
+    dot *= sign;
+
+    float wa = 1.0f - t, wb = t;
+    if (dot < 0.9995f)
+    {
+        float theta = std::acos(dot);
+        float s = std::sin(theta);
+        wa = std::sin((1.0f - t) * theta) / s;
+        wb = std::sin(t * theta) / s;
+    }
+    wb *= sign;
+
+    out.x = wa * a.x + wb * b.x;
+    out.y = wa * a.y + wb * b.y;
+    out.z = wa * a.z + wb * b.z;
+    out.w = wa * a.w + wb * b.w;
+    float norm = std::sqrt(out.x * out.x + out.y * out.y + out.z * out.z + out.w * out.w);
+    if (norm > 0.0f)
+    {
+        out.x /= norm;
+        out.y /= norm;
+        out.z /= norm;
+        out.w /= norm;
+    }
+}
+
+bool GetIMUAt(int deviceNum, int sensor, int64_t timestamp, IMUSample& sample)
+{
+    if (!ValidDeviceNum(deviceNum)) return false;
+
+    std::shared_ptr<IMURing> ring = std::atomic_load(&rings[deviceNum]);
+    if (!ring) return false;
+
+    IMUSample window[IMU_INTERPOLATION_WINDOW];
+    uint64_t end = ring->end();
+    uint64_t cursor = end > IMU_INTERPOLATION_WINDOW ? end - IMU_INTERPOLATION_WINDOW : 0;
+    size_t count = ring->read(cursor, window, IMU_INTERPOLATION_WINDOW);
+
+    // reports of sensor around timestamp (samples are in arrival order)
+    const IMUSample* before = NULL;
+    const IMUSample* after = NULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        const IMUSample& s = window[i];
+        if (s.sensor != sensor) continue;
+        if (timestamp == 0 || s.timestamp <= timestamp) before = &s;
+        else if (after == NULL) after = &s;
+    }
+
+    if (before == NULL && after == NULL) return false;
+    // latest report, or oldest one if timestamp is older than window
+    if (after == NULL || before == NULL)
+    {
+        sample = before != NULL ? *before : *after;
+        return true;
+    }
+
+    float t = after->timestamp > before->timestamp ? (float)(timestamp - before->timestamp) / (float)(after->timestamp - before->timestamp) : 0.0f;
+    sample = *before;
+    sample.timestamp = timestamp;
+    sample.accuracy = std::max(before->accuracy, after->accuracy);
+    if (sensor == IMU_ROTATION_VECTOR) slerp(*before, *after, t, sample);
+    else
+    {
+        sample.x = before->x + (after->x - before->x) * t;
+        sample.y = before->y + (after->y - before->y) * t;
+        sample.z = before->z + (after->z - before->z) * t;
+    }
+    return true;
+}
+
+// Interface with Unity C#
+extern "C"
+{
+    /**
+    * IMU samples (accelerometer, gyroscope, rotation vector) collected since previous call
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @param samples array of maxSamples IMUSample
+    * @param maxSamples size of samples. Oldest samples are skipped if there are more
+    * @returns number of samples written
+    */
+    EXPORT_API int DAIGetIMUSamples(int deviceNum, IMUSample* samples, int maxSamples)
+    {
+        if (maxSamples <= 0) return 0;
+        return (int) GetIMUSamples(deviceNum, samples, (size_t) maxSamples);
+    }
+
+    /**
+    * IMU sensor value interpolated at timestamp (orientation at frame time)
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @param sensor 0: accelerometer, 1: gyroscope, 2: rotation vector
+    * @param timestamp host steady clock in microseconds (frame timestamp). 0: latest
+    * @param sample interpolated sample
+    * @returns false if no report of sensor is available
+    */
+    EXPORT_API bool DAIGetIMUAt(int deviceNum, int sensor, long long timestamp, IMUSample* sample)
+    {
+        if (sample == NULL) return false;
+        return GetIMUAt(deviceNum, sensor, (int64_t) timestamp, *sample);
+    }
+}
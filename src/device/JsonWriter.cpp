@@ -0,0 +1,225 @@
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "depthai-unity/device/JsonWriter.hpp"
+
+void JsonWriter::clear()
+{
+    buffer.clear();
+    first.clear();
+    afterKey = false;
+}
+
+void JsonWriter::separator()
+{
+    // value of key: separator already written with key
+    if (afterKey)
+    {
+        afterKey = false;
+        return;
+    }
+    if (first.empty()) return;
+    if (!first.back()) buffer += ',';
+    first.back() = false;
+}
+
+void JsonWriter::open(char c)
+{
+    separator();
+    buffer += c;
+    first.push_back(true);
+}
+
+void JsonWriter::close(char c)
+{
+    buffer += c;
+    if (!first.empty()) first.pop_back();
+}
+
+JsonWriter& JsonWriter::beginObject()
+{
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray()
+{
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+    close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* name)
+{
+    separator();
+    string(name);
+    buffer += ':';
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(int v)
+{
+    separator();
+
+    // digits backwards into local buffer, no locale and no allocation
+    char tmp[12];
+    int n = 0;
+    unsigned int u = v < 0 ? 0u - (unsigned int)v : (unsigned int)v;
+    do
+    {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u > 0);
+    if (v < 0) buffer += '-';
+    while (n > 0) buffer += tmp[--n];
+
+    return *this;
+}
+
+// fixed point digits of |v| with decimals, so that they read back to same float. False if v is out of fast range
+static bool shortestFixed(float v, long long& digits, int& decimals)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14};
+
+    double a = std::fabs((double) v);
+    if (a < 1e-4 || a >= 1e7) return false;
+
+    // decimal exponent of first significant digit
+    int e = (int) std::floor(std::log10(a));
+
+    // 6 to 9 significant digits, 9 always reads back to same float
+    for (int precision = 6; precision <= 9; precision++)
+    {
+        decimals = std::max(0, precision - 1 - e);
+        digits = std::llround(a * pow10[decimals]);
+        if ((float)(digits / pow10[decimals]) == (float) a) return true;
+    }
+    return true;
+}
+
+JsonWriter& JsonWriter::value(float v)
+{
+    if (!std::isfinite(v)) return null();
+    separator();
+
+    if (v == 0.0f)
+    {
+        buffer += '0';
+        return *this;
+    }
+
+    // shortest representation that reads back to same float (0.5 instead of 0.500000000)
+    long long digits;
+    int decimals;
+    if (!shortestFixed(v, digits, decimals))
+    {
+        char tmp[32];
+        for (int precision = 6; precision <= 9; precision++)
+        {
+            std::snprintf(tmp, sizeof(tmp), "%.*g", precision, v);
+            if (std::strtof(tmp, NULL) == v) break;
+        }
+        buffer += tmp;
+        return *this;
+    }
+
+    // drop trailing zeros of fraction
+    while (decimals > 0 && digits % 10 == 0)
+    {
+        digits /= 10;
+        decimals--;
+    }
+
+    char tmp[24];
+    int n = 0;
+    for (int i = 0; i < decimals; i++)
+    {
+        tmp[n++] = (char)('0' + digits % 10);
+        digits /= 10;
+    }
+    if (decimals > 0) tmp[n++] = '.';
+    do
+    {
+        tmp[n++] = (char)('0' + digits % 10);
+        digits /= 10;
+    } while (digits > 0);
+
+    if (v < 0.0f) buffer += '-';
+    while (n > 0) buffer += tmp[--n];
+
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v)
+{
+    separator();
+    buffer += v ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* v)
+{
+    if (v == NULL) return null();
+    separator();
+    string(v);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::string& v)
+{
+    return value(v.c_str());
+}
+
+JsonWriter& JsonWriter::null()
+{
+    separator();
+    buffer += "null";
+    return *this;
+}
+
+void JsonWriter::string(const char* s)
+{
+    static const char* hex = "0123456789abcdef";
+
+    buffer += '"';
+    for (; *s; s++)
+    {
+        unsigned char c = (unsigned char) *s;
+        switch (c)
+        {
+            case '"': buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                if (c < 0x20)
+                {
+                    buffer += "\\u00";
+                    buffer += hex[c >> 4];
+                    buffer += hex[c & 15];
+                }
+                else buffer += (char) c;
+        }
+    }
+    buffer += '"';
+}
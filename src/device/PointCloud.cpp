@@ -0,0 +1,306 @@
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <cmath>
+#include <cstring>
+
+#include "../utility.hpp"
+#include "fp16/fp16.h"
+#include "opencv2/core/hal/intrin.hpp"
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "depthai-unity/device/PointCloud.hpp"
+
+// Mono HFOV (73.5) used when device has no calibration, same as Depth.cpp
+static const float defaultHFOV = 1.282817f;
+
+// write one point. format 0: float, 1: half float
+static inline void writePoint(std::uint8_t* dst, float x, float y, float z, float intensity, int comps, int format)
+{
+    if (format == 0)
+    {
+        float* p = (float*) dst;
+        p[0] = x; p[1] = y; p[2] = z;
+        if (comps == 4) p[3] = intensity;
+    }
+    else
+    {
+        uint16_t* p = (uint16_t*) dst;
+        p[0] = fp16_ieee_from_fp32_value(x);
+        p[1] = fp16_ieee_from_fp32_value(y);
+        p[2] = fp16_ieee_from_fp32_value(z);
+        if (comps == 4) p[3] = fp16_ieee_from_fp32_value(intensity);
+    }
+}
+
+// number of points of one subsampled row inside depth range
+static int countRow(const uint16_t* row, int cols, int stride, uint16_t minZ, uint16_t maxZ)
+{
+    int n = 0;
+    for (int i = 0; i < cols; i++)
+    {
+        uint16_t d = row[i*stride];
+        n += (d >= minZ && d <= maxZ);
+    }
+    return n;
+}
+
+// unproject one subsampled row, writes up to limit points. Returns points written
+static int unprojectRow(const uint16_t* row, const std::uint8_t* irow, const float* rayX, float rayY, int cols, int stride,
+                        uint16_t minZ, uint16_t maxZ, int comps, int format, std::uint8_t* dst, int limit)
+{
+    const float scale = 0.001f;
+    const float iscale = 1.0f / 255.0f;
+    const int pointSize = comps * (format == 0 ? 4 : 2);
+    int i = 0, n = 0;
+
+#if CV_SIMD128
+    // full resolution float output: 4 points per iteration, blocks with culled points fall back to scalar
+    if (cv::useOptimized() && stride == 1 && format == 0)
+    {
+        cv::v_uint32x4 vmin = cv::v_setall_u32(minZ), vmax = cv::v_setall_u32(maxZ);
+        cv::v_float32x4 vscale = cv::v_setall_f32(scale), viscale = cv::v_setall_f32(iscale);
+        cv::v_float32x4 vry = cv::v_setall_f32(rayY), zero = cv::v_setzero_f32();
+        float* out = (float*) dst;
+
+        for (; i <= cols - 4 && n <= limit - 4; i += 4)
+        {
+            cv::v_uint32x4 d = cv::v_load_expand(row + i);
+            if (!cv::v_check_all((d >= vmin) & (d <= vmax)))
+            {
+                for (int k = i; k < i + 4; k++)
+                {
+                    uint16_t dk = row[k];
+                    if (dk < minZ || dk > maxZ) continue;
+                    float z = dk * scale;
+                    float it = irow ? irow[k] * iscale : 0.0f;
+                    writePoint((std::uint8_t*)(out + n*comps), rayX[k] * z, rayY * z, z, it, comps, format);
+                    n++;
+                }
+                continue;
+            }
+
+            cv::v_float32x4 z = cv::v_cvt_f32(cv::v_reinterpret_as_s32(d)) * vscale;
+            cv::v_float32x4 x = cv::v_load(rayX + i) * z;
+            cv::v_float32x4 y = vry * z;
+            if (comps == 4)
+            {
+                cv::v_float32x4 it = irow ? cv::v_cvt_f32(cv::v_reinterpret_as_s32(cv::v_load_expand_q(irow + i))) * viscale : zero;
+                cv::v_store_interleave(out + n*comps, x, y, z, it);
+            }
+            else cv::v_store_interleave(out + n*comps, x, y, z);
+            n += 4;
+        }
+    }
+#endif
+
+    for (; i < cols && n < limit; i++)
+    {
+        uint16_t d = row[i*stride];
+        if (d < minZ || d > maxZ) continue;
+        float z = d * scale;
+        float it = irow ? irow[i*stride] * iscale : 0.0f;
+        writePoint(dst + (size_t)n*pointSize, rayX[i] * z, rayY * z, z, it, comps, format);
+        n++;
+    }
+
+    return n;
+}
+
+void PointCloudGenerator::setCalibration(const dai::CalibrationHandler& calibration, dai::CameraBoardSocket socket)
+{
+    this->calibration = calibration;
+    this->socket = socket;
+    calibrated = true;
+
+    // force ray table update
+    width = height = stride = 0;
+}
+
+void PointCloudGenerator::updateRays(int width, int height, int stride)
+{
+    if (width == this->width && height == this->height && stride == this->stride) return;
+
+    float fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
+    bool valid = false;
+
+    // intrinsics scaled to depth resolution
+    if (calibrated)
+    {
+        try
+        {
+            auto intrinsics = calibration.getCameraIntrinsics(socket, width, height);
+            fx = intrinsics[0][0];
+            fy = intrinsics[1][1];
+            cx = intrinsics[0][2];
+            cy = intrinsics[1][2];
+            valid = fx > 0.0f && fy > 0.0f;
+        }
+        catch (const std::exception&)
+        {
+            valid = false;
+        }
+    }
+
+    if (!valid)
+    {
+        fx = fy = (width / 2.0f) / std::tan(defaultHFOV / 2.0f);
+        cx = width / 2.0f;
+        cy = height / 2.0f;
+    }
+
+    int cols = (width + stride - 1) / stride;
+    int rows = (height + stride - 1) / stride;
+
+    rayX.resize(cols);
+    rayY.resize(rows);
+    for (int i = 0; i < cols; i++) rayX[i] = (i*stride - cx) / fx;
+    // image y goes down, unity y goes up
+    for (int j = 0; j < rows; j++) rayY[j] = -(j*stride - cy) / fy;
+
+    rowOffsets.resize(rows + 1);
+
+    this->width = width;
+    this->height = height;
+    this->stride = stride;
+}
+
+int PointCloudGenerator::generate(const cv::Mat& depth, const cv::Mat& intensity, const PointCloudConfig& config, void* dst, int maxPoints)
+{
+    if (dst == NULL || maxPoints <= 0 || depth.empty() || depth.type() != CV_16UC1) return 0;
+
+    int step = config.stride > 0 ? config.stride : 1;
+    updateRays(depth.cols, depth.rows, step);
+
+    int format = config.format == 1 ? 1 : 0;
+    if (config.voxelSize <= 0.0f) return unproject(depth, intensity, config, format, dst, maxPoints);
+
+    // unfiltered float points into arena, then one point per voxel into dst
+    int comps = config.useIntensity ? 4 : 3;
+    int capacity = (int)(rayX.size() * rayY.size());
+    if (arena.size() < (size_t)capacity * comps) arena.resize((size_t)capacity * comps);
+
+    int numPoints = unproject(depth, intensity, config, 0, arena.data(), capacity);
+    return voxelFilter(arena.data(), numPoints, comps, config.voxelSize, format, dst, maxPoints);
+}
+
+int PointCloudGenerator::unproject(const cv::Mat& depth, const cv::Mat& intensity, const PointCloudConfig& config, int format, void* dst, int maxPoints)
+{
+    int step = stride;
+    int cols = (int) rayX.size();
+    int rows = (int) rayY.size();
+    int comps = config.useIntensity ? 4 : 3;
+    size_t pointSize = comps * (format == 0 ? 4 : 2);
+
+    // depth range in mm. 0 is invalid depth
+    uint16_t minZ = (uint16_t) std::max(1.0f, std::min(65535.0f, config.minDepth * 1000.0f));
+    uint16_t maxZ = config.maxDepth > 0.0f ? (uint16_t) std::min(65535.0f, config.maxDepth * 1000.0f) : 65535;
+
+    bool useIntensity = config.useIntensity && intensity.type() == CV_8UC1 && intensity.size() == depth.size();
+
+    // small clouds are not worth the thread handoff
+    bool parallel = (long)cols * rows >= 640 * 360;
+
+    // pass 1: points per row, then output offset of each row
+    auto count = [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; r++)
+            rowOffsets[r + 1] = countRow(depth.ptr<uint16_t>(r * step), cols, step, minZ, maxZ);
+    };
+    if (parallel) cv::parallel_for_(cv::Range(0, rows), count, cv::getNumThreads());
+    else count(cv::Range(0, rows));
+
+    rowOffsets[0] = 0;
+    for (int r = 0; r < rows; r++) rowOffsets[r + 1] = std::min(maxPoints, rowOffsets[r] + rowOffsets[r + 1]);
+
+    // pass 2: each row writes its own range of output
+    std::uint8_t* out = (std::uint8_t*) dst;
+    auto unproject = [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; r++)
+        {
+            int limit = rowOffsets[r + 1] - rowOffsets[r];
+            if (limit <= 0) continue;
+            const std::uint8_t* irow = useIntensity ? intensity.ptr<std::uint8_t>(r * step) : NULL;
+            unprojectRow(depth.ptr<uint16_t>(r * step), irow, rayX.data(), rayY[r], cols, step,
+                         minZ, maxZ, comps, format, out + (size_t)rowOffsets[r]*pointSize, limit);
+        }
+    };
+    if (parallel) cv::parallel_for_(cv::Range(0, rows), unproject, cv::getNumThreads());
+    else unproject(cv::Range(0, rows));
+
+    return rowOffsets[rows];
+}
+
+// pack voxel coordinates (21 bits each, signed) into hash key
+static inline uint64_t voxelKey(float x, float y, float z, float inv)
+{
+    const int64_t offset = 1 << 20;
+    const int64_t mask = (1 << 21) - 1;
+    uint64_t ix = (uint64_t)(((int64_t)std::floor(x * inv) + offset) & mask);
+    uint64_t iy = (uint64_t)(((int64_t)std::floor(y * inv) + offset) & mask);
+    uint64_t iz = (uint64_t)(((int64_t)std::floor(z * inv) + offset) & mask);
+    return (ix << 42) | (iy << 21) | iz;
+}
+
+int PointCloudGenerator::voxelFilter(const float* points, int numPoints, int comps, float voxelSize, int format, void* dst, int maxPoints)
+{
+    if (numPoints <= 0) return 0;
+
+    // table at most half full: power of two >= 2*numPoints
+    size_t capacity = 1024;
+    while (capacity < (size_t)numPoints * 2) capacity <<= 1;
+    if (voxels.size() < capacity)
+    {
+        voxels.assign(capacity, Voxel());
+        stamp = 0;
+    }
+    capacity = voxels.size();
+    size_t mask = capacity - 1;
+
+    // new frame: slots with old stamp are empty, no clear needed
+    if (++stamp == 0)
+    {
+        for (auto& v : voxels) v.stamp = 0;
+        stamp = 1;
+    }
+    occupied.clear();
+
+    float inv = 1.0f / voxelSize;
+    for (int i = 0; i < numPoints; i++)
+    {
+        const float* p = points + (size_t)i*comps;
+        uint64_t key = voxelKey(p[0], p[1], p[2], inv);
+
+        // fibonacci hashing + linear probing
+        size_t slot = (size_t)((key * 11400714819323198485ull) >> 32) & mask;
+        while (voxels[slot].stamp == stamp && voxels[slot].key != key) slot = (slot + 1) & mask;
+
+        Voxel& v = voxels[slot];
+        if (v.stamp != stamp)
+        {
+            v.stamp = stamp;
+            v.key = key;
+            v.count = 0;
+            v.sum[0] = v.sum[1] = v.sum[2] = v.sum[3] = 0.0f;
+            occupied.push_back((int)slot);
+        }
+        v.count++;
+        for (int c = 0; c < comps; c++) v.sum[c] += p[c];
+    }
+
+    // centroid of each voxel in first-seen order (row order of depth frame)
+    int n = std::min((int)occupied.size(), maxPoints);
+    std::uint8_t* out = (std::uint8_t*) dst;
+    size_t pointSize = comps * (format == 0 ? 4 : 2);
+    for (int i = 0; i < n; i++)
+    {
+        const Voxel& v = voxels[occupied[i]];
+        float inv_count = 1.0f / v.count;
+        writePoint(out + (size_t)i*pointSize, v.sum[0]*inv_count, v.sum[1]*inv_count, v.sum[2]*inv_count, v.sum[3]*inv_count, comps, format);
+    }
+
+    return n;
+}
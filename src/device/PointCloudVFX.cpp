@@ -43,12 +43,71 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/device/PointCloudVFX.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
+#include "depthai-unity/device/PointCloud.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
 #include "nlohmann/json.hpp"
 
+// Point cloud generation per device. Output buffer registered by Unity (PointCloudVFXSetPointCloud)
+struct PointCloudOutput
+{
+    PointCloudConfig config;
+    void* points = NULL;
+    int maxPoints = 0;
+    int numPoints = 0;
+};
+static PointCloudGenerator pointClouds[DAI_MAX_DEVICES];
+static PointCloudOutput pointCloudOutputs[DAI_MAX_DEVICES];
+
+// Depth frames exported to Unity in zero-copy mode. Refcounted handle keeps frame buffer alive until next export of same device
+static std::shared_ptr<dai::ImgFrame> exportedDepth[DAI_MAX_DEVICES];
+
+/**
+* Export depth frame (CV_16UC1 / R16) to Unity
+*
+* Copy mode (frameInfo->depthData allocated by Unity): frame dims must match depthWidth x depthHeight, single bulk copy.
+* Zero-copy mode (frameInfo->depthData NULL): depthData points to frame buffer and depthWidth/depthHeight are set from frame.
+* Pointer is valid until next results call, Unity sets depthData back to NULL before each call.
+*
+* @param frameInfo camera images pointers
+* @param imgFrame latest depth frame, NULL if there is no new frame since last export
+* @param deviceNum Device selection on unity dropdown
+* @returns False if frame dims don't match Unity buffer or frame is not 16 bit depth
+*/
+static bool exportDepth(FrameInfo *frameInfo, std::shared_ptr<dai::ImgFrame> imgFrame, int deviceNum)
+{
+    if (frameInfo->depthData == NULL)
+    {
+        if (imgFrame) exportedDepth[deviceNum] = imgFrame;
+        imgFrame = exportedDepth[deviceNum];
+        if (!imgFrame) return true;
+    }
+    else if (!imgFrame) return true;
+
+    unsigned int width = imgFrame->getWidth();
+    unsigned int height = imgFrame->getHeight();
+    size_t size = (size_t)width * height * sizeof(unsigned short);
+    const auto& data = imgFrame->getData();
+    if (data.size() < size) return false;
+
+    if (frameInfo->depthData == NULL)
+    {
+        frameInfo->depthData = (void*)data.data();
+        frameInfo->depthWidth = width;
+        frameInfo->depthHeight = height;
+        return true;
+    }
+
+    if (frameInfo->depthWidth != width || frameInfo->depthHeight != height) return false;
+
+    ::memcpy(frameInfo->depthData, data.data(), size);
+    return true;
+}
+
 /**
 * Pipeline creation based on streams template
 *
@@ -85,6 +144,9 @@ dai::Pipeline createPointCloudVFXPipeline(PipelineConfig *config)
     colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::BGR);
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
+
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
     
     // Depth
     if (config->confidenceThreshold > 0)
@@ -121,6 +183,9 @@ dai::Pipeline createPointCloudVFXPipeline(PipelineConfig *config)
         if (config->medianFilter == 2) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_5x5);
         if (config->medianFilter == 3) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_7x7);
 
+        // confidence, median and LR-check can be changed while running (DAISetStereoConfig)
+        AddStereoControl(pipeline, config->deviceNum, stereo);
+
         // Linking
         left->out.link(stereo->left);
         right->out.link(stereo->right);
@@ -157,8 +222,9 @@ dai::Pipeline createPointCloudVFXPipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -174,6 +240,78 @@ dai::Pipeline createPointCloudVFXPipeline(PipelineConfig *config)
 }
 
 // Interface with C#
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void pointCloudVFXResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL) 
+    {
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
+    }
+
+    // latest frames from acquisition thread. isNew is false if frame was already processed
+    // worker held until results are written, frames can be views of its messages
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    bool isNew = false;
+    AcquiredMessage* acquired;
+
+    // In this case following Keijiro approach we return directly pointers to depth (CV_16UC1 / R16) and rectifiedR (CV_8UC1 / R8)
+
+    // if preview image is requested. Optional in this case.
+    if (getPreview)
+    {
+        acquired = GetAcquired(acquisition, "preview", &isNew);
+        if (acquired && isNew) toARGB(acquired->frame,frameInfo->colorPreviewData);
+    }
+
+    // if depth images are requested. Depth and Mono right rectified 
+    if (useDepth)
+    {            
+        acquired = GetAcquired(acquisition, "depth", &isNew);
+        std::shared_ptr<dai::ImgFrame> imgDepthFrame;
+        if (acquired && isNew) imgDepthFrame = acquired->get<dai::ImgFrame>();
+
+        if (!exportDepth(frameInfo, imgDepthFrame, deviceNum)) results.depthError = 1;
+
+        // host side point cloud
+        PointCloudOutput& output = pointCloudOutputs[deviceNum];
+        if (output.points != NULL)
+        {
+            if (imgDepthFrame)
+            {
+                cv::Mat intensity;
+                if (output.config.useIntensity)
+                {
+                    AcquiredMessage* monoR = GetAcquired(acquisition, "monoR");
+                    if (monoR) intensity = monoR->frame;
+                }
+                output.numPoints = pointClouds[deviceNum].generate(acquired->frame, intensity, output.config, output.points, output.maxPoints);
+            }
+            results.numPoints = output.numPoints;
+        }
+    }
+
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    if (useIMU) GetIMU(deviceNum, results.imu);
+}
+
 extern "C"
 {
     /**
@@ -184,17 +322,60 @@ extern "C"
     */
     EXPORT_API bool InitPointCloudVFX(PipelineConfig *config)
     {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
+
         dai::Pipeline pipeline = createPointCloudVFXPipeline(config);
 
         // If deviceId is empty .. just pick first available device
-        bool res = false;
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
+
+        // intrinsics for point cloud generation. Depth is aligned to color camera if depthAlign
+        int deviceNum = config->deviceNum;
+        dai::CameraBoardSocket socket = config->depthAlign > 0 ? dai::CameraBoardSocket::RGB : dai::CameraBoardSocket::RIGHT;
+        auto onStarted = [deviceNum, socket](std::shared_ptr<dai::Device> device)
+        {
+            try
+            {
+                auto calibration = device->readCalibration();
+                pointClouds[deviceNum].setCalibration(calibration, socket);
+            }
+            catch (const std::exception&)
+            {
+                // no calibration on device, generator uses default HFOV
+            }
+            pointCloudOutputs[deviceNum].numPoints = 0;
+        };
+
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy,{},BundlePolicy(),onStarted);
+
+        bool res = DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy);
+        if (res) onStarted(GetDevice(deviceNum));
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);        
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
-        
         return res;
     }
 
+    /**
+    * Register buffer for host side point cloud generation. Point cloud is generated on results call when new depth frame arrives.
+    *
+    * @param config point cloud generation options
+    * @param points destination buffer (pinned on Unity), at least maxPoints * point size (3 or 4 components of 4 or 2 bytes). NULL to disable generation
+    * @param maxPoints buffer capacity in points
+    * @param deviceNum Device selection on unity dropdown
+    */
+    EXPORT_API void PointCloudVFXSetPointCloud(PointCloudConfig *config, void* points, int maxPoints, int deviceNum)
+    {
+        if (!ValidDeviceNum(deviceNum)) return;
+
+        PointCloudOutput& output = pointCloudOutputs[deviceNum];
+        if (config != NULL) output.config = *config;
+        output.points = points;
+        output.maxPoints = points != NULL ? maxPoints : 0;
+        output.numPoints = 0;
+    }
+
     /**
     * Pipeline results
     *
@@ -208,88 +389,36 @@ extern "C"
     */
     EXPORT_API const char* PointCloudVFXResults(FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
     {
-        using namespace std;
-        using namespace std::chrono;
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        pointCloudVFXResults(*results, frameInfo, getPreview, useDepth, retrieveInformation, useIMU, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
 
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL) 
-        {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
-        }
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
-        {
-            // preview image
-            cv::Mat frame;
-            std::shared_ptr<dai::ImgFrame> imgFrame;
-
-            // other images
-            cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
-
-            // no specific information need it
-            nlohmann::json pointCloudVFXJson = {};
-
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
-            std::shared_ptr<dai::DataOutputQueue> dispQueue;
-            std::shared_ptr<dai::DataOutputQueue> monoRQueue;
-            std::shared_ptr<dai::DataOutputQueue> monoLQueue;
-
-            // if preview image is requested. Optional in this case.
-            if (getPreview) preview = device->getOutputQueue("preview",1,false);
-            
-            // if depth images are requested. Depth and Mono right rectified 
-            if (useDepth) 
-            {
-                depthQueue = device->getOutputQueue("depth", 1, false);
-                monoRQueue = device->getOutputQueue("monoR", 1, false);
-            }
-        
-            vector<std::shared_ptr<dai::ImgFrame>> imgDepthFrames,imgDispFrames,imgMonoRFrames,imgMonoLFrames;
-            std::shared_ptr<dai::ImgFrame> imgDepthFrame,imgDispFrame,imgMonoRFrame,imgMonoLFrame;
+        // no specific information need it
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
 
-            cv::Mat monoR;
-            // In this case following Keijiro approach we return directly pointers to depth (CV_16UC1 / R16) and rectifiedR (CV_8UC1 / R8)
+        if (results->depthError) json.field("depth_error", "DEPTH_SIZE_MISMATCH");
+        if (results->numPoints >= 0) json.field("points", results->numPoints);
 
-            bool match = false;
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
 
-            if (getPreview)
-            {
-                imgFrame = preview->get<dai::ImgFrame>();
-                frame = imgFrame->getCvFrame();
-                toARGB(frame,frameInfo->colorPreviewData);
-            }
-
-            if (useDepth)
-            {            
-                imgDepthFrame = depthQueue->get<dai::ImgFrame>();
-                
-                auto fp16 = (const unsigned short*)imgDepthFrame->getData().data();         
-                for (int i = 0; i < 640*360/*640*400*/; i++) {
-                    ((unsigned short*)frameInfo->depthData)[i] = (unsigned short)fp16[i];
-                }
-            }
-
-            // SYSTEM INFORMATION
-            if (retrieveInformation) pointCloudVFXJson["sysinfo"] = GetDeviceInfo(device);        
-            if (useIMU) pointCloudVFXJson["imu"] = GetIMU(device);
-
-            char* ret = (char*)::malloc(strlen(pointCloudVFXJson.dump().c_str())+1);
-            ::memcpy(ret, pointCloudVFXJson.dump().c_str(),strlen(pointCloudVFXJson.dump().c_str()));
-            ret[strlen(pointCloudVFXJson.dump().c_str())] = 0;
-
-            return ret;
-        }
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+    /**
+    * Pipeline results, binary interface. Same parameters as PointCloudVFXResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (numPoints, depthError, sysinfo, imu)
+    */
+    EXPORT_API FrameResults* PointCloudVFXResultsBinary(FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        pointCloudVFXResults(*results, frameInfo, getPreview, useDepth, retrieveInformation, useIMU, deviceNum);
+        return EndResults(deviceNum, results);
     }
 
 
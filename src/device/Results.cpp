@@ -0,0 +1,291 @@
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+#if _MSC_VER // this is defined when compiling with Visual Studio
+#define EXPORT_API __declspec(dllexport) // Visual Studio needs annotating exported functions with this
+#else
+#define EXPORT_API // XCode does not need annotating exported functions, so define is empty
+#endif
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#include "depthai-unity/device/Results.hpp"
+#include "depthai-unity/device/SharedRing.hpp"
+
+#include "spdlog/spdlog.h"
+
+// plugin owned results (same indexing as devices). Invalid deviceNum gets scratch results, reported as NO_DEVICE by results calls
+static FrameResults resultsRing[DAI_MAX_DEVICES][DAI_RESULTS_RING];
+static int resultsSlot[DAI_MAX_DEVICES];
+static int32_t resultsSequence[DAI_MAX_DEVICES];
+static FrameResults invalidResults;
+
+FrameResults* BeginResults(int deviceNum, FrameResults* results)
+{
+    if (!ValidDeviceNum(deviceNum))
+    {
+        if (results == NULL) results = &invalidResults;
+        std::memset(results, 0, sizeof(FrameResults));
+        results->version = DAI_RESULTS_VERSION;
+        results->size = (int32_t) sizeof(FrameResults);
+        results->error = RESULTS_NO_DEVICE;
+        results->best = -1;
+        results->numPoints = -1;
+        return results;
+    }
+
+    if (results == NULL)
+    {
+        results = &resultsRing[deviceNum][resultsSlot[deviceNum]];
+        resultsSlot[deviceNum] = (resultsSlot[deviceNum] + 1) % DAI_RESULTS_RING;
+    }
+
+    // only header and counters, arrays are valid up to their counts
+    results->version = DAI_RESULTS_VERSION;
+    results->size = (int32_t) sizeof(FrameResults);
+    results->error = RESULTS_OK;
+    results->sequence = resultsSequence[deviceNum]++;
+    results->previewWidth = results->previewHeight = 0;
+    results->numDetections = 0;
+    results->best = -1;
+    results->numLandmarks = 0;
+    results->numPoints = -1;
+    results->depthError = 0;
+    results->sysinfo.valid = 0;
+    results->imu.valid = 0;
+    results->droppedDetections = 0;
+
+    return results;
+}
+
+// shared memory publisher of device results (same indexing as devices). Swapped atomically, results calls keep ring alive while writing
+static std::shared_ptr<SharedRing> publishers[DAI_MAX_DEVICES];
+
+FrameResults* EndResults(int deviceNum, FrameResults* results)
+{
+    if (!ValidDeviceNum(deviceNum)) return results;
+
+    std::shared_ptr<SharedRing> publisher = std::atomic_load(&publishers[deviceNum]);
+    if (publisher) publisher->write(SHARED_RING_RESULTS_BINARY, results, (uint32_t) sizeof(FrameResults));
+    return results;
+}
+
+void PublishFrame(int deviceNum, int width, int height, int type, size_t step, const void* data)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    std::shared_ptr<SharedRing> publisher = std::atomic_load(&publishers[deviceNum]);
+    if (!publisher || data == NULL) return;
+
+    // frame header and pixels written in place. Skipped if ring is full or frame doesn't fit a slot
+    uint32_t size = (uint32_t)(sizeof(SharedRingFrame) + step * (size_t) height);
+    SharedRingFrame* frame = (SharedRingFrame*) publisher->acquireWrite(size);
+    if (frame == NULL) return;
+
+    frame->deviceNum = deviceNum;
+    frame->width = width;
+    frame->height = height;
+    frame->type = type;
+    frame->step = (int32_t) step;
+    std::memset(frame->reserved, 0, sizeof(frame->reserved));
+    std::memcpy(frame + 1, data, step * (size_t) height);
+    publisher->commitWrite(SHARED_RING_FRAME, size);
+}
+
+DetectionResult* AddDetection(FrameResults& results)
+{
+    if (results.numDetections >= DAI_MAX_DETECTIONS)
+    {
+        // truncation is reported on every call (droppedDetections), logged only once
+        static std::atomic<bool> logged{false};
+        if (results.droppedDetections++ == 0 && !logged.exchange(true))
+        {
+            spdlog::warn("more than {} detections on a frame, extra detections are dropped (droppedDetections)", DAI_MAX_DETECTIONS);
+        }
+        return NULL;
+    }
+
+    int index = results.numDetections++;
+    std::memset(&results.detections[index], 0, sizeof(DetectionResult));
+    results.headPoses[index].valid = 0;
+    results.emotions[index].valid = 0;
+    return &results.detections[index];
+}
+
+void WriteDetection(JsonWriter& json, const DetectionResult& detection)
+{
+    json.beginObject();
+    json.field("label", detection.label);
+    json.field("score", detection.score);
+    json.field("xmin", detection.xmin);
+    json.field("ymin", detection.ymin);
+    json.field("xmax", detection.xmax);
+    json.field("ymax", detection.ymax);
+    json.field("xcenter", detection.xcenter);
+    json.field("ycenter", detection.ycenter);
+
+    if (detection.hasSpatial)
+    {
+        json.field("X", detection.X);
+        json.field("Y", detection.Y);
+        json.field("Z", detection.Z);
+    }
+    json.endObject();
+}
+
+void WriteSysInfo(JsonWriter& json, const SysInfoResult& sysinfo)
+{
+    if (!sysinfo.valid)
+    {
+        json.null();
+        return;
+    }
+
+    json.beginObject();
+    json.field("ddr_used", sysinfo.ddrUsed);
+    json.field("ddr_total", sysinfo.ddrTotal);
+    json.field("leoncss_heap_used", sysinfo.leonCssHeapUsed);
+    json.field("leoncss_heap_total", sysinfo.leonCssHeapTotal);
+    json.field("leonmss_heap_used", sysinfo.leonMssHeapUsed);
+    json.field("leonmss_heap_total", sysinfo.leonMssHeapTotal);
+    json.field("cmx_used", sysinfo.cmxUsed);
+    json.field("cmx_total", sysinfo.cmxTotal);
+    json.field("chip_temp_avg", sysinfo.chipTempAvg);
+    json.field("cpu_usage", sysinfo.cpuUsage);
+    json.endObject();
+}
+
+void WriteIMU(JsonWriter& json, const IMUResult& imu)
+{
+    if (!imu.valid)
+    {
+        json.null();
+        return;
+    }
+
+    json.beginObject();
+    json.field("I", imu.i);
+    json.field("J", imu.j);
+    json.field("K", imu.k);
+    json.field("Real", imu.real);
+    json.field("Accuracy", imu.accuracy);
+    json.endObject();
+}
+
+// json results buffers (same indexing as devices). held: string returned to Unity and not released yet
+// returned pointer is kept apart from writer, so release from any thread never touches the buffer being written
+struct JsonResults
+{
+    JsonWriter writer;
+    std::atomic<const char*> returned{NULL};
+    std::atomic<bool> held{false};
+};
+static JsonResults jsonResults[DAI_MAX_DEVICES][DAI_JSON_BUFFERS];
+// buffer being written, -1 if every buffer is held
+static int jsonCurrent[DAI_MAX_DEVICES];
+// error strings of invalid deviceNum, and results discarded while every buffer is held
+static JsonResults invalidJson;
+static JsonWriter discardedJson;
+static const char* notReleased = "{\"error\":\"RESULTS_NOT_RELEASED\"}";
+
+JsonWriter& BeginJsonResults(int deviceNum)
+{
+    if (!ValidDeviceNum(deviceNum))
+    {
+        invalidJson.writer.clear();
+        return invalidJson.writer;
+    }
+
+    // first released buffer after the one returned last, held buffers are never overwritten
+    int last = jsonCurrent[deviceNum] < 0 ? 0 : jsonCurrent[deviceNum];
+    jsonCurrent[deviceNum] = -1;
+    for (int i = 1; i <= DAI_JSON_BUFFERS; i++)
+    {
+        int slot = (last + i) % DAI_JSON_BUFFERS;
+        if (jsonResults[deviceNum][slot].held) continue;
+        jsonCurrent[deviceNum] = slot;
+        break;
+    }
+
+    JsonWriter& writer = jsonCurrent[deviceNum] >= 0 ? jsonResults[deviceNum][jsonCurrent[deviceNum]].writer : discardedJson;
+    writer.clear();
+    return writer;
+}
+
+const char* EndJsonResults(int deviceNum)
+{
+    if (!ValidDeviceNum(deviceNum)) return invalidJson.writer.c_str();
+    if (jsonCurrent[deviceNum] < 0) return notReleased;
+
+    JsonResults& results = jsonResults[deviceNum][jsonCurrent[deviceNum]];
+    results.returned = results.writer.c_str();
+    results.held = true;
+
+    std::shared_ptr<SharedRing> publisher = std::atomic_load(&publishers[deviceNum]);
+    if (publisher) publisher->write(SHARED_RING_RESULTS_JSON, results.writer.c_str(), (uint32_t) results.writer.size() + 1);
+
+    return results.returned;
+}
+
+const char* ResultsErrorString(int deviceNum, const FrameResults& results)
+{
+    JsonWriter& json = BeginJsonResults(deviceNum);
+    json.beginObject();
+    json.field("error", results.error == RESULTS_NO_DEVICE ? "NO_DEVICE" : "DEVICE_NOT_RUNNING");
+    json.endObject();
+    return EndJsonResults(deviceNum);
+}
+
+// Interface with Unity C#
+extern "C"
+{
+    /**
+    * Release json string returned by any *Results function once it is read. Held buffers are never reused, up to
+    * DAI_JSON_BUFFERS strings of a device can be held at once
+    *
+    * @param result string returned by plugin. Unknown pointers are ignored
+    */
+    EXPORT_API void DAIReleaseResult(const char* result)
+    {
+        if (result == NULL) return;
+
+        for (int deviceNum = 0; deviceNum < DAI_MAX_DEVICES; deviceNum++)
+        {
+            for (int slot = 0; slot < DAI_JSON_BUFFERS; slot++)
+            {
+                JsonResults& results = jsonResults[deviceNum][slot];
+                if (results.returned == result) results.held = false;
+            }
+        }
+    }
+
+    /**
+    * Publish results (binary and json) and color frames of device into shared memory ring, for out of process consumers
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @param name segment name (see SharedRing.hpp), NULL or empty stops publishing
+    * @param slotCount number of records in flight
+    * @param slotSize slot capacity in bytes. Frames bigger than slot are not published
+    * @returns true if ring was created
+    */
+    EXPORT_API bool DAIPublishResults(int deviceNum, const char* name, int slotCount, int slotSize)
+    {
+        if (!ValidDeviceNum(deviceNum)) return false;
+
+        std::shared_ptr<SharedRing> publisher;
+        if (name != NULL && name[0] != '\0')
+        {
+            // results always fit
+            if (slotSize < (int) sizeof(FrameResults)) slotSize = (int) sizeof(FrameResults);
+            publisher = SharedRing::create(name, slotCount, slotSize);
+            if (!publisher) return false;
+        }
+
+        std::atomic_store(&publishers[deviceNum], publisher);
+        return true;
+    }
+}
@@ -0,0 +1,339 @@
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+#if _MSC_VER // this is defined when compiling with Visual Studio
+#define EXPORT_API __declspec(dllexport) // Visual Studio needs annotating exported functions with this
+#else
+#define EXPORT_API // XCode does not need annotating exported functions, so define is empty
+#endif
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+#include "depthai-unity/device/SharedRing.hpp"
+
+static_assert(sizeof(SharedRingHeader) == DAI_SHARED_RING_HEADER, "SharedRingHeader layout");
+static_assert(sizeof(SharedRingRecord) == DAI_SHARED_RING_RECORD, "SharedRingRecord layout");
+static_assert(sizeof(SharedRingFrame) == 32, "SharedRingFrame layout");
+
+static int64_t nowMicros()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// records are 8 byte aligned
+static uint32_t recordStride(uint32_t slotSize)
+{
+    return DAI_SHARED_RING_RECORD + ((slotSize + 7u) & ~7u);
+}
+
+bool SharedRing::map(const std::string& name, size_t size, bool create)
+{
+    segmentName = name;
+
+#if _WIN32
+    HANDLE handle;
+    if (create)
+    {
+        handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, name.c_str());
+    }
+    else handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (handle == NULL) return false;
+    mapping = handle;
+
+    // size of existing mapping is read from header first
+    base = (std::uint8_t*) MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, create ? size : 0);
+    if (base == NULL) return false;
+
+    if (!create)
+    {
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(base, &info, sizeof(info));
+        size = info.RegionSize;
+    }
+
+    std::string eventName = name + "_wake";
+    event = create ? CreateEventA(NULL, FALSE, FALSE, eventName.c_str()) : OpenEventA(EVENT_ALL_ACCESS, FALSE, eventName.c_str());
+#else
+    std::string shmName = "/" + name;
+    if (create)
+    {
+        // replace stale segment of a previous run
+        shm_unlink(shmName.c_str());
+        fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) return false;
+        if (ftruncate(fd, (off_t)size) != 0) return false;
+    }
+    else
+    {
+        fd = shm_open(shmName.c_str(), O_RDWR, 0600);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < DAI_SHARED_RING_HEADER) return false;
+        size = (size_t) st.st_size;
+    }
+
+    void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) return false;
+    base = (std::uint8_t*) ptr;
+#endif
+
+    mappedSize = size;
+    header = (SharedRingHeader*) base;
+    owner = create;
+    return true;
+}
+
+std::unique_ptr<SharedRing> SharedRing::create(const std::string& name, int slotCount, int slotSize)
+{
+    if (name.empty() || slotCount <= 0 || slotSize <= 0) return NULL;
+
+    std::unique_ptr<SharedRing> ring(new SharedRing());
+    size_t size = DAI_SHARED_RING_HEADER + (size_t)slotCount * recordStride((uint32_t)slotSize);
+    if (!ring->map(name, size, true)) return NULL;
+
+    // counters are initialized before magic, so consumer never sees half initialized header
+    SharedRingHeader* header = new (ring->base) SharedRingHeader();
+    header->version = DAI_SHARED_RING_VERSION;
+    header->slotCount = (uint32_t) slotCount;
+    header->slotSize = (uint32_t) slotSize;
+    header->wake.store(0);
+    header->waiters.store(0);
+    header->writeSeq.store(0);
+    header->readSeq.store(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = DAI_SHARED_RING_MAGIC;
+
+    return ring;
+}
+
+std::unique_ptr<SharedRing> SharedRing::open(const std::string& name)
+{
+    if (name.empty()) return NULL;
+
+    std::unique_ptr<SharedRing> ring(new SharedRing());
+    if (!ring->map(name, 0, false)) return NULL;
+
+    const SharedRingHeader* header = ring->header;
+    if (header->magic != DAI_SHARED_RING_MAGIC || header->version != DAI_SHARED_RING_VERSION) return NULL;
+    if (ring->mappedSize < DAI_SHARED_RING_HEADER + (size_t)header->slotCount * recordStride(header->slotSize)) return NULL;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return ring;
+}
+
+SharedRing::~SharedRing()
+{
+#if _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle((HANDLE) mapping);
+    if (event) CloseHandle((HANDLE) event);
+#else
+    if (base) munmap(base, mappedSize);
+    if (fd >= 0) close(fd);
+    // consumers keep their mapping, name is removed so next producer creates a new segment
+    if (owner) shm_unlink(("/" + segmentName).c_str());
+#endif
+}
+
+SharedRingRecord* SharedRing::record(uint64_t sequence) const
+{
+    uint64_t slot = sequence % header->slotCount;
+    return (SharedRingRecord*)(base + DAI_SHARED_RING_HEADER + slot * recordStride(header->slotSize));
+}
+
+void* SharedRing::acquireWrite(uint32_t size)
+{
+    if (size > header->slotSize) return NULL;
+
+    // only producer writes writeSeq
+    uint64_t w = header->writeSeq.load(std::memory_order_relaxed);
+    uint64_t r = header->readSeq.load(std::memory_order_acquire);
+    if (w - r >= header->slotCount) return NULL;
+
+    return record(w) + 1;
+}
+
+void SharedRing::commitWrite(uint32_t type, uint32_t size)
+{
+    uint64_t w = header->writeSeq.load(std::memory_order_relaxed);
+
+    SharedRingRecord* rec = record(w);
+    rec->sequence = w;
+    rec->type = type;
+    rec->size = size;
+    rec->timestamp = nowMicros();
+
+    header->writeSeq.store(w + 1, std::memory_order_release);
+    header->wake.fetch_add(1, std::memory_order_release);
+    notify();
+}
+
+bool SharedRing::write(uint32_t type, const void* data, uint32_t size)
+{
+    void* dst = acquireWrite(size);
+    if (dst == NULL) return false;
+
+    std::memcpy(dst, data, size);
+    commitWrite(type, size);
+    return true;
+}
+
+const SharedRingRecord* SharedRing::acquireRead(int timeoutMs, bool latest)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while (true)
+    {
+        // wake value before checking, so a commit in between is not missed
+        uint32_t wake = header->wake.load(std::memory_order_acquire);
+
+        // only consumer writes readSeq
+        uint64_t r = header->readSeq.load(std::memory_order_relaxed);
+        uint64_t w = header->writeSeq.load(std::memory_order_acquire);
+        if (w != r)
+        {
+            if (latest && w - r > 1) header->readSeq.store(w - 1, std::memory_order_release);
+            return record(latest ? w - 1 : r);
+        }
+
+        int remaining = (int) std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (timeoutMs <= 0 || remaining <= 0) return NULL;
+        wait(wake, remaining);
+    }
+}
+
+void SharedRing::releaseRead()
+{
+    uint64_t r = header->readSeq.load(std::memory_order_relaxed);
+    if (r == header->writeSeq.load(std::memory_order_acquire)) return;
+    header->readSeq.store(r + 1, std::memory_order_release);
+}
+
+void SharedRing::wait(uint32_t wake, int timeoutMs)
+{
+    header->waiters.fetch_add(1, std::memory_order_seq_cst);
+
+#if defined(__linux__)
+    // shared futex (no FUTEX_PRIVATE_FLAG), works across processes mapping the segment
+    struct timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, (uint32_t*)&header->wake, FUTEX_WAIT, wake, &ts, NULL, 0);
+#elif _WIN32
+    if (event && header->wake.load(std::memory_order_acquire) == wake) WaitForSingleObject((HANDLE) event, (DWORD) timeoutMs);
+    else if (!event) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#else
+    // no cross process wakeup primitive, short polling
+    if (header->wake.load(std::memory_order_acquire) == wake) std::this_thread::sleep_for(std::chrono::microseconds(500));
+#endif
+
+    header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void SharedRing::notify()
+{
+    // no syscall while nobody sleeps
+    if (header->waiters.load(std::memory_order_seq_cst) == 0) return;
+
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t*)&header->wake, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#elif _WIN32
+    if (event) SetEvent((HANDLE) event);
+#endif
+}
+
+// Interface with Unity C# and out of process consumers (ctypes)
+extern "C"
+{
+    /**
+    * Create named ring (producer)
+    *
+    * @param name segment name, without leading slash
+    * @param slotCount number of records in flight
+    * @param slotSize payload capacity of each record in bytes
+    * @returns ring handle or NULL
+    */
+    EXPORT_API void* DAISharedRingCreate(const char* name, int slotCount, int slotSize)
+    {
+        if (name == NULL) return NULL;
+        return SharedRing::create(name, slotCount, slotSize).release();
+    }
+
+    /**
+    * Open named ring created by other process (consumer)
+    *
+    * @returns ring handle or NULL
+    */
+    EXPORT_API void* DAISharedRingOpen(const char* name)
+    {
+        if (name == NULL) return NULL;
+        return SharedRing::open(name).release();
+    }
+
+    EXPORT_API void DAISharedRingClose(void* ring)
+    {
+        delete (SharedRing*) ring;
+    }
+
+    /**
+    * Copy record into ring
+    *
+    * @returns true if written, false if ring is full
+    */
+    EXPORT_API bool DAISharedRingWrite(void* ring, int type, const void* data, int size)
+    {
+        if (ring == NULL || size < 0) return false;
+        return ((SharedRing*) ring)->write((uint32_t) type, data, (uint32_t) size);
+    }
+
+    /**
+    * Read next record in place. Must be released with DAISharedRingRelease
+    *
+    * @param timeoutMs wait for a record. 0: don't wait
+    * @param latest skip to latest record
+    * @param type record type
+    * @param size payload size
+    * @param timestamp producer steady clock in microseconds
+    * @returns payload pointer or NULL on timeout
+    */
+    EXPORT_API const void* DAISharedRingRead(void* ring, int timeoutMs, bool latest, int* type, int* size, long long* timestamp)
+    {
+        if (ring == NULL) return NULL;
+
+        const SharedRingRecord* rec = ((SharedRing*) ring)->acquireRead(timeoutMs, latest);
+        if (rec == NULL) return NULL;
+
+        if (type) *type = (int) rec->type;
+        if (size) *size = (int) rec->size;
+        if (timestamp) *timestamp = (long long) rec->timestamp;
+        return rec + 1;
+    }
+
+    EXPORT_API void DAISharedRingRelease(void* ring)
+    {
+        if (ring == NULL) return;
+        ((SharedRing*) ring)->releaseRead();
+    }
+}
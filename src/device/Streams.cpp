@@ -15,6 +15,7 @@
 // ------------------------------------------------------------------------
 // Plugin itself
 
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <random>
@@ -26,6 +27,9 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/device/Streams.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
+#include "depthai-unity/device/Colorizer.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
@@ -34,26 +38,134 @@
 
 float maxDisparity;
 
+// depth/disparity visualization per device
+static Colorizer depthColorizer[DAI_MAX_DEVICES], disparityColorizer[DAI_MAX_DEVICES];
+static ColorMap depthColorMap[DAI_MAX_DEVICES], disparityColorMap[DAI_MAX_DEVICES];
+static float depthColorRange[DAI_MAX_DEVICES];
+
 /**
 * Pipeline creation based on streams template
 *
 * @param config pipeline configuration 
 * @returns pipeline 
 */
+// gated outputs: name and mask bit
+static const std::vector<std::pair<std::string, int>> gatedStreams = {
+    {"preview", STREAM_PREVIEW}, {"depth", STREAM_DEPTH}, {"disparity", STREAM_DISPARITY}, {"monoR", STREAM_MONO_R}, {"monoL", STREAM_MONO_L}
+};
+
+/**
+* Script forwarding gated outputs enabled in mask. Mask is updated by 4 bytes buffers (little endian) on control input.
+* Disabled frames are dropped on device and never cross the link
+*
+* @param mask initial stream mask
+* @param linked names of gated outputs linked to script inputs. Other outputs have no script io
+*/
+static std::string gatingScript(int mask, const std::vector<std::string>& linked)
+{
+    std::string script =
+        "import time\n"
+        "mask = " + std::to_string(mask) + "\n"
+        "streams = [";
+    for (const auto& stream : gatedStreams)
+    {
+        if (std::find(linked.begin(), linked.end(), stream.first) == linked.end()) continue;
+        script += "('" + stream.first + "', " + std::to_string(stream.second) + "), ";
+    }
+    script +=
+        "]\n"
+        "while True:\n"
+        "    ctrl = node.io['control'].tryGet()\n"
+        "    if ctrl is not None:\n"
+        "        data = ctrl.getData()\n"
+        "        mask = data[0] | (data[1] << 8)\n"
+        "    idle = True\n"
+        "    for name, bit in streams:\n"
+        "        msg = node.io['in_' + name].tryGet()\n"
+        "        if msg is None: continue\n"
+        "        idle = False\n"
+        "        if mask & bit: node.io[name].send(msg)\n"
+        "    if idle: time.sleep(0.001)\n";
+    return script;
+}
+
 dai::Pipeline createStreamsPipeline(PipelineConfig *config)
 {
     dai::Pipeline pipeline;
-    std::shared_ptr<dai::node::XLinkOut> xlinkOut;
+    int mask = config->streamMask > 0 ? config->streamMask : STREAM_ALL;
+
+    // streams gating on device, control mask from host
+    // script is set once graph is built, from outputs actually linked to gate
+    std::shared_ptr<dai::node::Script> gate;
+    std::vector<std::string> gated;
+    if (config->streamGating)
+    {
+        gate = pipeline.create<dai::node::Script>();
+
+        auto xinControl = pipeline.create<dai::node::XLinkIn>();
+        xinControl->setStreamName("streamControl");
+        xinControl->out.link(gate->inputs["control"]);
+        gate->inputs["control"].setBlocking(false);
+        gate->inputs["control"].setQueueSize(1);
+    }
+
+    // link node output to XLinkOut, through gate if enabled. Streams not in mask are not created
+    // encode: 0 raw, 1 gray frames (mono) encoded directly, 2 color frames converted to NV12 before encoder
+    auto addOutput = [&](const std::string& name, int bit, dai::Node::Output& output, int encode)
+    {
+        if ((mask & bit) == 0 && !gate) return;
+
+        auto xlinkOut = pipeline.create<dai::node::XLinkOut>();
+        xlinkOut->setStreamName(name);
+
+        dai::Node::Output* source = &output;
+        if (gate)
+        {
+            // only latest frame waits on gate, camera/stereo never block on it
+            source->link(gate->inputs["in_" + name]);
+            gate->inputs["in_" + name].setBlocking(false);
+            gate->inputs["in_" + name].setQueueSize(1);
+            source = &gate->outputs[name];
+            gated.push_back(name);
+        }
+
+        // MJPEG on device, only bitstream crosses the link (decoded by acquisition thread)
+        if (config->videoEncoding == 1 && encode > 0)
+        {
+            if (encode == 2)
+            {
+                auto toNV12 = pipeline.create<dai::node::ImageManip>();
+                toNV12->initialConfig.setFrameType(dai::ImgFrame::Type::NV12);
+                toNV12->setMaxOutputFrameSize(config->previewSizeWidth * config->previewSizeHeight * 3 / 2);
+                toNV12->inputImage.setBlocking(false);
+                toNV12->inputImage.setQueueSize(1);
+                source->link(toNV12->inputImage);
+                source = &toNV12->out;
+            }
+
+            auto encoder = pipeline.create<dai::node::VideoEncoder>();
+            // mono encoders follow fps of their own camera
+            float fps = config->colorCameraFPS;
+            if (encode == 1) fps = name == "monoL" ? config->monoLCameraFPS : config->monoRCameraFPS;
+            if (fps <= 0.0f) fps = config->colorCameraFPS;
+            encoder->setDefaultProfilePreset(fps > 0.0f ? fps : 30.0f, dai::VideoEncoderProperties::Profile::MJPEG);
+            encoder->setQuality(config->encoderQuality > 0 ? config->encoderQuality : 80);
+            encoder->input.setBlocking(false);
+            encoder->input.setQueueSize(1);
+            source->link(encoder->input);
+            source = &encoder->bitstream;
+        }
+
+        source->link(xlinkOut->input);
+    };
     
     auto colorCam = pipeline.create<dai::node::ColorCamera>();
 
     // Color camera preview
     if (config->previewSizeWidth > 0 && config->previewSizeHeight > 0) 
     {
-        xlinkOut = pipeline.create<dai::node::XLinkOut>();
-        xlinkOut->setStreamName("preview");
         colorCam->setPreviewSize(config->previewSizeWidth, config->previewSizeHeight);
-        colorCam->preview.link(xlinkOut->input);
+        addOutput("preview", STREAM_PREVIEW, colorCam->preview, 2);
     }
 
     // Color camera properties            
@@ -65,9 +177,12 @@ dai::Pipeline createStreamsPipeline(PipelineConfig *config)
     colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::BGR);
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
+
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
     
-    // Depth
-    if (config->confidenceThreshold > 0)
+    // Depth. Stereo is not created if no stereo output is used (unless outputs can be resumed)
+    if (config->confidenceThreshold > 0 && ((mask & (STREAM_DEPTH | STREAM_DISPARITY | STREAM_MONO_R | STREAM_MONO_L)) != 0 || gate))
     {
         auto left = pipeline.create<dai::node::MonoCamera>();
         auto right = pipeline.create<dai::node::MonoCamera>();
@@ -101,28 +216,26 @@ dai::Pipeline createStreamsPipeline(PipelineConfig *config)
         if (config->medianFilter == 2) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_5x5);
         if (config->medianFilter == 3) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_7x7);
 
+        // confidence, median and LR-check can be changed while running (DAISetStereoConfig)
+        AddStereoControl(pipeline, config->deviceNum, stereo);
+
         // Linking
         left->out.link(stereo->left);
         right->out.link(stereo->right);
-        auto xoutDepth = pipeline.create<dai::node::XLinkOut>();            
-        xoutDepth->setStreamName("depth");
-        stereo->depth.link(xoutDepth->input);
-
-        auto xoutDisp = pipeline.create<dai::node::XLinkOut>();            
-        xoutDisp->setStreamName("disparity");
-        stereo->disparity.link(xoutDisp->input);
-
-        auto xoutMonoR = pipeline.create<dai::node::XLinkOut>();            
-        xoutMonoR->setStreamName("monoR");
-        stereo->rectifiedRight.link(xoutMonoR->input);
-
-        auto xoutMonoL = pipeline.create<dai::node::XLinkOut>();            
-        xoutMonoL->setStreamName("monoL");
-        stereo->rectifiedLeft.link(xoutMonoL->input);
+        addOutput("depth", STREAM_DEPTH, stereo->depth, 0);
+        addOutput("disparity", STREAM_DISPARITY, stereo->disparity, 0);
+        addOutput("monoR", STREAM_MONO_R, stereo->rectifiedRight, 1);
+        addOutput("monoL", STREAM_MONO_L, stereo->rectifiedLeft, 1);
 
         maxDisparity = stereo->initialConfig.getMaxDisparity();
+
+        depthColorMap[config->deviceNum] = config->depthColorMap > 0 ? (ColorMap)config->depthColorMap : ColorMap::EQUALIZED;
+        disparityColorMap[config->deviceNum] = config->disparityColorMap > 0 ? (ColorMap)config->disparityColorMap : ColorMap::JET;
+        depthColorRange[config->deviceNum] = config->depthColorRange * 1000.0f;
     }
 
+    if (gate) gate->setScript(gatingScript(mask, gated));
+
     // SYSTEM INFORMATION
     if (config->rate > 0.0f)
     {
@@ -147,8 +260,9 @@ dai::Pipeline createStreamsPipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -163,6 +277,79 @@ dai::Pipeline createStreamsPipeline(PipelineConfig *config)
     return pipeline;
 }
 
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void streamsResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL) 
+    {
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
+
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
+    }
+
+    // latest frames from acquisition thread. isNew is false if frame was already processed
+    // worker held until results are written, frames can be views of its messages
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    bool isNew = false;
+    AcquiredMessage* acquired;
+    // preview timestamp, IMU orientation is interpolated at it
+    int64_t frameTimestamp = 0;
+
+    // if preview image is requested. True in this case.
+    if (getPreview)
+    {
+        acquired = GetAcquired(acquisition, "preview", &isNew);
+        if (acquired && acquired->get<dai::ImgFrame>())
+            frameTimestamp = std::chrono::duration_cast<std::chrono::microseconds>(acquired->get<dai::ImgFrame>()->getTimestamp().time_since_epoch()).count();
+        if (acquired && isNew)
+        {
+            toARGB(acquired->frame,frameInfo->colorPreviewData);
+            PublishFrame(deviceNum, acquired->frame.cols, acquired->frame.rows, acquired->frame.type(), acquired->frame.step[0], acquired->frame.data);
+        }
+    }
+    
+    // In this case we allocate before Texture2D (ARGB32) and memcpy pointer data 
+    if (useDepth)
+    {   
+        // Depth         
+        acquired = GetAcquired(acquisition, "depth", &isNew);
+        if (acquired && isNew) depthColorizer[deviceNum].colorize(acquired->frame, depthColorMap[deviceNum], depthColorRange[deviceNum], frameInfo->depthData);
+
+        // Disparity
+        acquired = GetAcquired(acquisition, "disparity", &isNew);
+        if (acquired && isNew) disparityColorizer[deviceNum].colorize(acquired->frame, disparityColorMap[deviceNum], maxDisparity, frameInfo->disparityData);
+
+        // Mono R
+        acquired = GetAcquired(acquisition, "monoR", &isNew);
+        if (acquired && isNew) toARGB(acquired->frame,frameInfo->rectifiedRData);
+
+        // Mono L
+        acquired = GetAcquired(acquisition, "monoL", &isNew);
+        if (acquired && isNew) toARGB(acquired->frame,frameInfo->rectifiedLData);
+    }
+
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    // IMU
+    if (useIMU) GetIMU(deviceNum, results.imu, frameTimestamp);
+}
+
 extern "C"
 {
    /**
@@ -173,15 +360,38 @@ extern "C"
     */
     EXPORT_API bool InitStreams(PipelineConfig *config)
     {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
+
         dai::Pipeline pipeline = createStreamsPipeline(config);
 
         // If deviceId is empty .. just pick first available device
-        bool res = false;
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);        
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
-        
-        return res;
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy);
+        return DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy);
+    }
+
+    /**
+    * Pause/resume outputs of streams pipeline without restarting device. Requires streamGating in pipeline creation.
+    * Paused outputs are dropped on device and don't use link bandwidth nor host CPU
+    *
+    * @param streamMask enabled outputs (StreamMask)
+    * @param deviceNum Device selection on unity dropdown
+    * @returns true if mask was sent to device
+    */
+    EXPORT_API bool SetStreamsEnabled(int streamMask, int deviceNum)
+    {
+        std::shared_ptr<dai::DataInputQueue> control = GetInputQueue(deviceNum, "streamControl");
+        if (!control) return false;
+
+        auto buffer = std::make_shared<dai::Buffer>();
+        std::vector<std::uint8_t> data = {(std::uint8_t)(streamMask & 0xff), (std::uint8_t)((streamMask >> 8) & 0xff), 0, 0};
+        buffer->setData(data);
+        control->send(buffer);
+        return true;
     }
 
     /**
@@ -197,139 +407,34 @@ extern "C"
     */    
     EXPORT_API const char* StreamsResults(FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
     {
-        using namespace std;
-        using namespace std::chrono;
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        streamsResults(*results, frameInfo, getPreview, useDepth, retrieveInformation, useIMU, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
 
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL) 
-        {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
-        }
+        // no specific information need it
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
 
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
-        {
-            // preview image
-            cv::Mat frame;
-            std::shared_ptr<dai::ImgFrame> imgFrame;
-
-            // other images
-            cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
-            
-            // no specific information need it
-            nlohmann::json streamsJson = {};
-
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
-            std::shared_ptr<dai::DataOutputQueue> dispQueue;
-            std::shared_ptr<dai::DataOutputQueue> monoRQueue;
-            std::shared_ptr<dai::DataOutputQueue> monoLQueue;
-
-            // if preview image is requested. True in this case.
-            if (getPreview) preview = device->getOutputQueue("preview",1,false);
-            
-            // if depth images are requested. All images.
-            if (useDepth) 
-            {
-                depthQueue = device->getOutputQueue("depth", 1, false);
-                dispQueue = device->getOutputQueue("disparity", 1, false);
-                monoRQueue = device->getOutputQueue("monoR", 1, false);
-                monoLQueue = device->getOutputQueue("monoL", 1, false);
-            }
-            
-            if (getPreview)
-            {
-                auto imgFrames = preview->tryGetAll<dai::ImgFrame>();
-                auto countd = imgFrames.size();
-                if (countd > 0) {
-                    auto imgFrame = imgFrames[countd-1];
-                    if(imgFrame){
-                        //printf("Frame - w: %d, h: %d\n", imgFrame->getWidth(), imgFrame->getHeight());
-                        frame = toMat(imgFrame->getData(), imgFrame->getWidth(), imgFrame->getHeight(), 3, 1);
-
-                        toARGB(frame,frameInfo->colorPreviewData);
-                    }
-                }
-            }
-        
-            vector<std::shared_ptr<dai::ImgFrame>> imgDepthFrames,imgDispFrames,imgMonoRFrames,imgMonoLFrames;
-            std::shared_ptr<dai::ImgFrame> imgDepthFrame,imgDispFrame,imgMonoRFrame,imgMonoLFrame;
-            
-            // In this case we allocate before Texture2D (ARGB32) and memcpy pointer data 
-            if (useDepth)
-            {   
-                // Depth         
-                imgDepthFrames = depthQueue->tryGetAll<dai::ImgFrame>();
-                int count = imgDepthFrames.size();
-                if (count > 0)
-                {
-                    imgDepthFrame = imgDepthFrames[count-1];
-                    depthFrameOrig = imgDepthFrame->getFrame();
-                    cv::normalize(depthFrameOrig, depthFrame, 255, 0, cv::NORM_INF, CV_8UC1);
-                    cv::equalizeHist(depthFrame, depthFrame);
-                    cv::cvtColor(depthFrame, depthFrame, cv::COLOR_GRAY2BGR);
-
-                    toARGB(depthFrame,frameInfo->depthData);
-                }
-
-                // Disparity
-                imgDispFrames = dispQueue->tryGetAll<dai::ImgFrame>();
-                int countd = imgDispFrames.size();
-                if (countd > 0)
-                {
-                    imgDispFrame = imgDispFrames[countd-1];
-                    dispFrameOrig = imgDispFrame->getFrame();
-                    dispFrameOrig.convertTo(dispFrame, CV_8UC1, 255 / maxDisparity);
-                    cv::applyColorMap(dispFrame, dispFrame, cv::COLORMAP_JET);
-                    
-                    toARGB(dispFrame,frameInfo->disparityData);
-                }
-
-                // Mono R
-                imgMonoRFrames = monoRQueue->tryGetAll<dai::ImgFrame>();
-                int countr = imgMonoRFrames.size();
-                if (countr > 0)
-                {
-                    imgMonoRFrame = imgMonoRFrames[countr-1];
-                    monoRFrameOrig = imgMonoRFrame->getFrame();
-                    cv::cvtColor(monoRFrameOrig, monoRFrame, cv::COLOR_GRAY2BGR);                    
-                    toARGB(monoRFrame,frameInfo->rectifiedRData);
-                }
-
-                // Mono L
-                imgMonoLFrames = monoLQueue->tryGetAll<dai::ImgFrame>();
-                int countl = imgMonoLFrames.size();
-                if (countl > 0)
-                {
-                    imgMonoLFrame = imgMonoLFrames[countl-1];
-                    monoLFrameOrig = imgMonoLFrame->getFrame();
-                    cv::cvtColor(monoLFrameOrig, monoLFrame, cv::COLOR_GRAY2BGR);                    
-                    toARGB(monoLFrame,frameInfo->rectifiedLData);
-                }
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        // IMU
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
 
-            }
-
-            // SYSTEM INFORMATION
-            if (retrieveInformation) streamsJson["sysinfo"] = GetDeviceInfo(device);        
-            // IMU
-            if (useIMU) streamsJson["imu"] = GetIMU(device);
-
-            char* ret = (char*)::malloc(strlen(streamsJson.dump().c_str())+1);
-            ::memcpy(ret, streamsJson.dump().c_str(),strlen(streamsJson.dump().c_str()));
-            ret[strlen(streamsJson.dump().c_str())] = 0;
-
-            return ret;
-        }
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+    /**
+    * Pipeline results, binary interface. Same parameters as StreamsResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (sysinfo, imu)
+    */
+    EXPORT_API FrameResults* StreamsResultsBinary(FrameInfo *frameInfo, bool getPreview, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        streamsResults(*results, frameInfo, getPreview, useDepth, retrieveInformation, useIMU, deviceNum);
+        return EndResults(deviceNum, results);
     }
 
 
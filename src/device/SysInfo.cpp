@@ -0,0 +1,150 @@
+#pragma GCC diagnostic ignored "-Wreturn-type-c-linkage"
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+#if _MSC_VER // this is defined when compiling with Visual Studio
+#define EXPORT_API __declspec(dllexport) // Visual Studio needs annotating exported functions with this
+#else
+#define EXPORT_API // XCode does not need annotating exported functions, so define is empty
+#endif
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include "depthai-unity/device/SysInfo.hpp"
+
+// snapshots of one device. Written by callback on depthai queue thread (1 hz), read by results path
+struct SysInfoCache
+{
+    std::mutex mutex;
+    SysInfoSample latest = {};
+    std::deque<SysInfoSample> history;
+};
+
+// collector of one device
+struct SysInfoCollector
+{
+    std::shared_ptr<dai::DataOutputQueue> queue;
+    int callbackId = -1;
+};
+
+// same indexing as devices
+static SysInfoCache caches[DAI_MAX_DEVICES];
+static SysInfoCollector collectors[DAI_MAX_DEVICES];
+
+static void collect(SysInfoCache& cache, const dai::SystemInformation& info)
+{
+    SysInfoSample sample;
+    sample.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    sample.info.ddrUsed = info.ddrMemoryUsage.used / (1024.0f * 1024.0f);
+    sample.info.ddrTotal = info.ddrMemoryUsage.total / (1024.0f * 1024.0f);
+    sample.info.leonCssHeapUsed = info.leonCssMemoryUsage.used / (1024.0f * 1024.0f);
+    sample.info.leonCssHeapTotal = info.leonCssMemoryUsage.total / (1024.0f * 1024.0f);
+    sample.info.leonMssHeapUsed = info.leonMssMemoryUsage.used / (1024.0f * 1024.0f);
+    sample.info.leonMssHeapTotal = info.leonMssMemoryUsage.total / (1024.0f * 1024.0f);
+    sample.info.cmxUsed = info.cmxMemoryUsage.used / (1024.0f * 1024.0f);
+    sample.info.cmxTotal = info.cmxMemoryUsage.total / (1024.0f * 1024.0f);
+    sample.info.chipTempAvg = info.chipTemperature.average;
+    sample.info.cpuUsage = info.leonCssCpuUsage.average * 100;
+    sample.info.valid = 1;
+
+    sample.mssCpuUsage = info.leonMssCpuUsage.average * 100;
+    sample.tempCss = info.chipTemperature.css;
+    sample.tempMss = info.chipTemperature.mss;
+    sample.tempUpa = info.chipTemperature.upa;
+    sample.tempDss = info.chipTemperature.dss;
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    sample.version = cache.latest.version + 1;
+    cache.latest = sample;
+    cache.history.push_back(sample);
+    if (cache.history.size() > DAI_SYSINFO_HISTORY) cache.history.pop_front();
+}
+
+void StartSysInfo(int deviceNum, std::shared_ptr<dai::DataOutputQueue> queue)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+    StopSysInfo(deviceNum);
+
+    SysInfoCache& cache = caches[deviceNum];
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.latest = SysInfoSample();
+        cache.history.clear();
+    }
+    if (!queue) return;
+
+    collectors[deviceNum].queue = queue;
+    collectors[deviceNum].callbackId = queue->addCallback([&cache](std::shared_ptr<dai::ADatatype> msg)
+    {
+        auto info = std::dynamic_pointer_cast<dai::SystemInformation>(msg);
+        if (info) collect(cache, *info);
+    });
+}
+
+void StopSysInfo(int deviceNum)
+{
+    if (!ValidDeviceNum(deviceNum)) return;
+
+    SysInfoCollector& collector = collectors[deviceNum];
+    if (collector.queue && collector.callbackId >= 0) collector.queue->removeCallback(collector.callbackId);
+    collector.queue = nullptr;
+    collector.callbackId = -1;
+}
+
+bool GetSysInfo(int deviceNum, SysInfoSample& sample)
+{
+    if (!ValidDeviceNum(deviceNum)) return false;
+
+    SysInfoCache& cache = caches[deviceNum];
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    sample = cache.latest;
+    return sample.version > 0;
+}
+
+size_t GetSysInfoHistory(int deviceNum, SysInfoSample* samples, size_t maxSamples)
+{
+    if (samples == NULL || !ValidDeviceNum(deviceNum)) return 0;
+
+    SysInfoCache& cache = caches[deviceNum];
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    size_t count = std::min(maxSamples, cache.history.size());
+    std::copy(cache.history.end() - (std::ptrdiff_t) count, cache.history.end(), samples);
+    return count;
+}
+
+// Interface with Unity C#
+extern "C"
+{
+    /**
+    * Latest system information of device, collected in background. Requires rate in pipeline creation.
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @param sample latest snapshot. version increases with every new message
+    * @returns false if nothing was received yet
+    */
+    EXPORT_API bool DAIGetSysInfo(int deviceNum, SysInfoSample* sample)
+    {
+        if (sample == NULL) return false;
+        return GetSysInfo(deviceNum, *sample);
+    }
+
+    /**
+    * System information history of device, oldest first
+    *
+    * @param deviceNum Device selection on unity dropdown
+    * @param samples array of maxSamples SysInfoSample
+    * @param maxSamples size of samples. Newest samples are kept if there are more
+    * @returns number of samples written
+    */
+    EXPORT_API int DAIGetSysInfoHistory(int deviceNum, SysInfoSample* samples, int maxSamples)
+    {
+        if (maxSamples <= 0) return 0;
+        return (int) GetSysInfoHistory(deviceNum, samples, (size_t) maxSamples);
+    }
+}
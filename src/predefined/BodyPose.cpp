@@ -26,6 +26,8 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/predefined/BodyPose.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
@@ -122,6 +124,9 @@ dai::Pipeline createBodyPosePipeline(PipelineConfig *config)
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
 
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
+
     // neural network
     auto nn1 = pipeline.create<dai::node::NeuralNetwork>();
     nn1->setBlobPath(config->nnPath1);
@@ -179,6 +184,9 @@ dai::Pipeline createBodyPosePipeline(PipelineConfig *config)
         if (config->medianFilter == 2) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_5x5);
         if (config->medianFilter == 3) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_7x7);
 
+        // confidence, median and LR-check can be changed while running (DAISetStereoConfig)
+        AddStereoControl(pipeline, config->deviceNum, stereo);
+
         stereo->setDefaultProfilePreset(dai::node::StereoDepth::PresetMode::HIGH_DENSITY);
 
         // Linking
@@ -241,8 +249,9 @@ dai::Pipeline createBodyPosePipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -257,312 +266,363 @@ dai::Pipeline createBodyPosePipeline(PipelineConfig *config)
     return pipeline;    
 }
 
-extern "C"
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void bodyPoseResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, int width, int height, bool useDepth, bool drawBodyPoseInPreview, float bodyLandmarkScoreThreshold, bool retrieveInformation, bool useIMU, bool useSpatialLocator, int deviceNum)
 {
-   /**
-    * Pipeline creation based on streams template
-    *
-    * @param config pipeline configuration 
-    * @returns pipeline 
-    */
-    EXPORT_API bool InitBodyPose(PipelineConfig *config)
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL) 
     {
-        dai::Pipeline pipeline = createBodyPosePipeline(config);
-       
-       // If deviceId is empty .. just pick first available device
-        bool res = false;
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);        
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
-        
-        return res;
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
     }
 
-    /**
-    * Pipeline results
-    *
-    * @param frameInfo camera images pointers
-    * @param getPreview True if color preview image is requested, False otherwise. Requires previewSize in pipeline creation.
-    * @param width Unity preview width canvas
-    * @param height Unity preview height canvas
-    * @param useDepth True if depth information is requested, False otherwise. Requires confidenceThreshold in pipeline creation.
-    * @param retrieveInformation True if system information is requested, False otherwise. Requires rate in pipeline creation.
-    * @param useIMU True if IMU information is requested, False otherwise. Requires freq in pipeline creation.
-    * @param deviceNum Device selection on unity dropdown
-    * @returns Json with results or information about device availability. 
-    */    
+    cv::Mat frame;
+    cv::Mat depthFrame, depthFrameOrig;
     
-    EXPORT_API const char* BodyPoseResults(FrameInfo *frameInfo, bool getPreview, int width, int height, bool useDepth, bool drawBodyPoseInPreview, float bodyLandmarkScoreThreshold, bool retrieveInformation, bool useIMU, bool useSpatialLocator, int deviceNum)
+    std::shared_ptr<dai::ImgFrame> imgFrame;
+
+    auto startTime = steady_clock::now();
+    int counter = 0;
+    float fps = 0;
+
+    int LINES_BODY[16][2] = {{4,2},{2,0},{0,1},{1,3},
+        {10,8},{8,6},{6,5},{5,7},{7,9},
+        {6,12},{12,11},{11,5},
+        {12,14},{14,16},{11,13},{13,15}};
+
+    // latest frames from acquisition thread. isNew is false if frame was already processed
+    // worker held until results are written, frames can be views of its messages
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    bool previewNew = false;
+    AcquiredMessage* acquired;
+
+    if (getPreview)
     {
-        using namespace std;
-        using namespace std::chrono;
+        acquired = GetAcquired(acquisition, "preview", &previewNew);
+        if (acquired) frame = acquired->frame;
+    }
 
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL) 
+    struct Detection {
+        unsigned int label;
+        float score;
+        float x_min;
+        float y_min;
+        float x_max;
+        float y_max;
+    };
+
+    vector<Detection> dets;
+
+    // latest landmarks (could be from previous results call)
+    std::vector<float> detData;
+    acquired = GetAcquired(acquisition, "detections");
+    if (acquired) detData = acquired->get<dai::NNData>()->getLayerFp16("Identity");
+    
+    int landmarks_y[17]; 
+    int landmarks_x[17];
+    int landmarks_xpos[17];
+    int landmarks_ypos[17];
+    int landmarks_zpos[17];
+    float scores[17];
+
+    int count = 0;
+    std::shared_ptr<dai::DataInputQueue> spatialCalcConfigInQueue;
+
+    if (useDepth)
+    {            
+        if (useSpatialLocator) spatialCalcConfigInQueue = GetInputQueue(deviceNum, "spatialCalcConfig");
+
+        // latest depth, ROIs are mapped with its size
+        bool depthNew = false;
+        acquired = GetAcquired(acquisition, "depth", &depthNew);
+        count = acquired ? 1 : 0;
+        if (count > 0)
         {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
+            depthFrameOrig = acquired->frame;
+            // host side spatial lookups on this frame (summed-area tables only rebuilt for new frames)
+            float lowerThreshold = 100, upperThreshold = 50000;
+            GetSpatialThresholds(deviceNum, lowerThreshold, upperThreshold);
+            if (depthNew) GetSpatialEngine(deviceNum).update(depthFrameOrig, lowerThreshold, upperThreshold);
+            // only frame size is used to map ROIs, no visualization needed
+            depthFrame = depthFrameOrig;
         }
+    }
 
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
-        {
-            cv::Mat frame;
-            cv::Mat depthFrame, depthFrameOrig;
-            
-            std::shared_ptr<dai::ImgFrame> imgFrame;
+    // landmarks are in padded network input coordinates
+    results.previewWidth = pad;
+    results.previewHeight = pad;
 
-            auto startTime = steady_clock::now();
-            int counter = 0;
-            float fps = 0;
+    dai::SpatialLocationCalculatorConfig cfg;
 
-            int LINES_BODY[16][2] = {{4,2},{2,0},{0,1},{1,3},
-                {10,8},{8,6},{6,5},{5,7},{7,9},
-                {6,12},{12,11},{11,5},
-                {12,14},{14,16},{11,13},{13,15}};
+    // depth thresholds of ROIs sent to device, can be changed while running (DAISetSpatialThresholds)
+    float lowerThreshold = 100, upperThreshold = 10000;
+    GetSpatialThresholds(deviceNum, lowerThreshold, upperThreshold);
+    sconfig.depthThresholds.lowerThreshold = (uint32_t) lowerThreshold;
+    sconfig.depthThresholds.upperThreshold = (uint32_t) upperThreshold;
 
-            //{[{"index":0,"xpos","ypos","location.x":0,"location.y":0,"location.z":0},{"index":1,"location.x":0,"location.y":0,"location.z":0}]}
-            nlohmann::json bodyPoseJson;
+    if(detData.size() > 0){
+        int pos = 0;
 
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
+        int frameSize = pad;
+        
+        for (int i=0; i<(int)detData.size(); i+=3)
+        {
+            landmarks_y[pos] = (int) (detData[i] * frameSize);//frame.rows);
+            landmarks_x[pos] = (int) (detData[i+1] * frameSize);//frame.cols);
+            scores[pos] = detData[i+2];
 
-             if (getPreview) preview = device->getOutputQueue("preview",1,false);
-            
-            auto detections = device->getOutputQueue("detections",1,false);
-            
-            if (useDepth) depthQueue = device->getOutputQueue("depth", 1, false);
-            
-            if (getPreview)
+            if (useSpatialLocator)
             {
-                auto imgFrames = preview->tryGetAll<dai::ImgFrame>();
-                auto countd = imgFrames.size();
-                if (countd > 0) {
-                    auto imgFrame = imgFrames[countd-1];
-                    if(imgFrame){
-                        frame = imgFrame->getCvFrame();
-                    }
-                }
+                sconfig.roi = prepareComputeDepth(depthFrame,frame,landmarks_x[pos],landmarks_y[pos],1);
+                sconfig.calculationAlgorithm = calculationAlgorithm;
+                cfg.addROI(sconfig);
             }
+
+            pos++;
+        }
+
+        std::vector<int> pushed;
+
         
-            struct Detection {
-                unsigned int label;
-                float score;
-                float x_min;
-                float y_min;
-                float x_max;
-                float y_max;
-            };
-
-            vector<Detection> dets;
-
-            auto det = detections->get<dai::NNData>();
-            std::vector<float> detData = det->getLayerFp16("Identity");
-            
-            int landmarks_y[17]; 
-            int landmarks_x[17];
-            int landmarks_xpos[17];
-            int landmarks_ypos[17];
-            int landmarks_zpos[17];
-            float scores[17];
-
-            int count;
-            vector<std::shared_ptr<dai::ImgFrame>> imgDepthFrames;
-            std::shared_ptr<dai::ImgFrame> imgDepthFrame;
-            std::shared_ptr<dai::DataOutputQueue> spatialCalcQueue;
-            std::shared_ptr<dai::DataInputQueue> spatialCalcConfigInQueue;
-
-            if (useDepth)
-            {            
-                if (useSpatialLocator)
-                {
-                    spatialCalcQueue = device->getOutputQueue("spatialData", 1, false);
-                    spatialCalcConfigInQueue = device->getInputQueue("spatialCalcConfig");
-                }
+        if (useDepth && pos>0 && useSpatialLocator) 
+        {
+            spatialCalcConfigInQueue->send(cfg);
+        
+            // get spatial. Reply for these ROIs (or previous ones until it arrives), locations are in landmarks order
+            std::vector<dai::SpatialLocations> spatialData;
+            getSpatialReply(deviceNum, cfg, spatialData);
+        
+            int i = 0;
+            for(auto depthData : spatialData) {
+                if (i >= 17) break;
+                landmarks_xpos[i] = (int)depthData.spatialCoordinates.x;
+                landmarks_ypos[i] = (int)depthData.spatialCoordinates.y;
+                landmarks_zpos[i] = (int)depthData.spatialCoordinates.z;
+                i++;
+            }
+        }
 
-                imgDepthFrames = depthQueue->tryGetAll<dai::ImgFrame>();
-                count = imgDepthFrames.size();
-                if (count > 0)
+        for (int i=0; i<16; i++)
+        {
+            if (scores[LINES_BODY[i][0]] > bodyLandmarkScoreThreshold && scores[LINES_BODY[i][1]] > bodyLandmarkScoreThreshold)
+            {
+                if (drawBodyPoseInPreview && previewNew)
                 {
-                    imgDepthFrame = imgDepthFrames[count-1];
-                    depthFrameOrig = imgDepthFrame->getFrame();
-                    cv::normalize(depthFrameOrig, depthFrame, 255, 0, cv::NORM_INF, CV_8UC1);
-                    cv::equalizeHist(depthFrame, depthFrame);
-                    cv::cvtColor(depthFrame, depthFrame, cv::COLOR_GRAY2BGR);
+                    cv::Point point1 = cv::Point(landmarks_x[LINES_BODY[i][0]],landmarks_y[LINES_BODY[i][0]]);
+                    cv::Point point2 = cv::Point(landmarks_x[LINES_BODY[i][1]],landmarks_y[LINES_BODY[i][1]]);
+                    cv::line(frame, point1, point2 ,cv::Scalar(255, 180, 90));
+                    cv::circle(frame, point1, 4, ColorForLandmark(LINES_BODY[i][0]), -11);
+                    cv::circle(frame, point2, 4, ColorForLandmark(LINES_BODY[i][1]), -11);
                 }
-            }
-
-            nlohmann::json bodyPose = {};
-            dai::SpatialLocationCalculatorConfig cfg;
-
-            if(detData.size() > 0){
-                int pos = 0;
 
-                int frameSize = pad;
-                
-                for (int i=0; i<(int)detData.size(); i+=3)
+                if (std::find(pushed.begin(), pushed.end(), LINES_BODY[i][0]) == pushed.end() && results.numLandmarks < DAI_MAX_LANDMARKS) 
                 {
-                    landmarks_y[pos] = (int) (detData[i] * frameSize);//frame.rows);
-                    landmarks_x[pos] = (int) (detData[i+1] * frameSize);//frame.cols);
-                    scores[pos] = detData[i+2];
+                    LandmarkResult& landmark = results.landmarks[results.numLandmarks++];
+                    pushed.push_back(LINES_BODY[i][0]);
 
-                    if (useSpatialLocator)
-                    {
-                        sconfig.roi = prepareComputeDepth(depthFrame,frame,landmarks_x[pos],landmarks_y[pos],1);
-                        sconfig.calculationAlgorithm = calculationAlgorithm;
-                        cfg.addROI(sconfig);
-                    }
+                    landmark.index = LINES_BODY[i][0];
+                    landmark.xpos = landmarks_x[LINES_BODY[i][0]];
+                    landmark.ypos = landmarks_y[LINES_BODY[i][0]];
+                    landmark.hasSpatial = 0;
+                    landmark.X = landmark.Y = landmark.Z = 0;
 
-                    pos++;
-                }
+                    if (useDepth && count>0)
+                    {
+                        if (!useSpatialLocator)
+                        {
+                            auto spatialData = computeDepth(GetSpatialEngine(deviceNum),landmarks_x[LINES_BODY[i][0]],landmarks_y[LINES_BODY[i][0]],frame.rows);
 
-                std::vector<int> pushed;
+                            for(auto depthData : spatialData) 
+                            {
+                                landmarks_xpos[LINES_BODY[i][0]] = (int)depthData.spatialCoordinates.x;
+                                landmarks_ypos[LINES_BODY[i][0]] = (int)depthData.spatialCoordinates.y;
+                                landmarks_zpos[LINES_BODY[i][0]] = (int)depthData.spatialCoordinates.z;
+                                landmark.hasSpatial = 1;
+                            }
+                        }
+                        else landmark.hasSpatial = 1;
 
-                
-                if (useDepth && pos>0 && useSpatialLocator) 
-                {
-                    spatialCalcConfigInQueue->send(cfg);
-                
-                    // get spatial
-                    auto spatialData = spatialCalcQueue->get<dai::SpatialLocationCalculatorData>()->getSpatialLocations();
-                
-                    int i = 0;
-                    for(auto depthData : spatialData) {
-                        landmarks_xpos[i] = (int)depthData.spatialCoordinates.x;
-                        landmarks_ypos[i] = (int)depthData.spatialCoordinates.y;
-                        landmarks_zpos[i] = (int)depthData.spatialCoordinates.z;
-                        i++;
+                        if (landmark.hasSpatial)
+                        {
+                            landmark.X = landmarks_xpos[LINES_BODY[i][0]];
+                            landmark.Y = landmarks_ypos[LINES_BODY[i][0]];
+                            landmark.Z = landmarks_zpos[LINES_BODY[i][0]];
+                        }
                     }
                 }
 
-                for (int i=0; i<16; i++)
+                if (std::find(pushed.begin(), pushed.end(), LINES_BODY[i][1]) == pushed.end() && results.numLandmarks < DAI_MAX_LANDMARKS) 
                 {
-                    if (scores[LINES_BODY[i][0]] > bodyLandmarkScoreThreshold && scores[LINES_BODY[i][1]] > bodyLandmarkScoreThreshold)
+                    LandmarkResult& landmark = results.landmarks[results.numLandmarks++];
+                    pushed.push_back(LINES_BODY[i][1]);
+
+                    landmark.index = LINES_BODY[i][1];
+                    landmark.xpos = landmarks_x[LINES_BODY[i][1]];
+                    landmark.ypos = landmarks_y[LINES_BODY[i][1]];
+                    landmark.hasSpatial = 0;
+                    landmark.X = landmark.Y = landmark.Z = 0;
+
+                    if (useDepth && count>0)
                     {
-                        if (drawBodyPoseInPreview)
+                        if (!useSpatialLocator)
                         {
-                            cv::Point point1 = cv::Point(landmarks_x[LINES_BODY[i][0]],landmarks_y[LINES_BODY[i][0]]);
-                            cv::Point point2 = cv::Point(landmarks_x[LINES_BODY[i][1]],landmarks_y[LINES_BODY[i][1]]);
-                            cv::line(frame, point1, point2 ,cv::Scalar(255, 180, 90));
-                            cv::circle(frame, point1, 4, ColorForLandmark(LINES_BODY[i][0]), -11);
-                            cv::circle(frame, point2, 4, ColorForLandmark(LINES_BODY[i][1]), -11);
-                        }
+                            auto spatialData = computeDepth(GetSpatialEngine(deviceNum),landmarks_x[LINES_BODY[i][1]],landmarks_y[LINES_BODY[i][1]],frame.rows);
 
-                        if (std::find(pushed.begin(), pushed.end(), LINES_BODY[i][0]) == pushed.end()) 
-                        {
-                            nlohmann::json landmarkJson = {};
-                            pushed.push_back(LINES_BODY[i][0]);
-                            
-                            landmarkJson["index"] = LINES_BODY[i][0];
-                            landmarkJson["xpos"] = landmarks_x[LINES_BODY[i][0]];
-                            landmarkJson["ypos"] = landmarks_y[LINES_BODY[i][0]];
-
-                            if (useDepth && count>0)
+                            for(auto depthData : spatialData) 
                             {
-                                if (useSpatialLocator)
-                                {
-                                    landmarkJson["location.x"] = landmarks_xpos[LINES_BODY[i][0]];
-                                    landmarkJson["location.y"] = landmarks_ypos[LINES_BODY[i][0]];
-                                    landmarkJson["location.z"] = landmarks_zpos[LINES_BODY[i][0]];
-                                }
-                                else
-                                {
-                                    auto spatialData = computeDepth(landmarks_x[LINES_BODY[i][0]],landmarks_y[LINES_BODY[i][0]],frame.rows,depthFrameOrig);
-                                    /*auto depthData = spatialData[LINES_BODY[i][0]]; 
-                                    auto roi = depthData.config.roi;
-                                    roi = roi.denormalize(depthFrame.cols, depthFrame.rows);*/
-                                    
-                                    for(auto depthData : spatialData) 
-                                    {
-                                        auto roi = depthData.config.roi;
-                                        roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
-
-                                        landmarks_xpos[LINES_BODY[i][0]] = (int)depthData.spatialCoordinates.x;
-                                        landmarks_ypos[LINES_BODY[i][0]] = (int)depthData.spatialCoordinates.y;
-                                        landmarks_zpos[LINES_BODY[i][0]] = (int)depthData.spatialCoordinates.z;
-
-                                        landmarkJson["location.x"] = landmarks_xpos[LINES_BODY[i][0]];
-                                        landmarkJson["location.y"] = landmarks_ypos[LINES_BODY[i][0]];
-                                        landmarkJson["location.z"] = landmarks_zpos[LINES_BODY[i][0]];
-                                    }
-                                }
+                                landmarks_xpos[LINES_BODY[i][1]] = (int)depthData.spatialCoordinates.x;
+                                landmarks_ypos[LINES_BODY[i][1]] = (int)depthData.spatialCoordinates.y;
+                                landmarks_zpos[LINES_BODY[i][1]] = (int)depthData.spatialCoordinates.z;
+                                landmark.hasSpatial = 1;
                             }
-                            bodyPose.push_back(landmarkJson);
                         }
+                        else landmark.hasSpatial = 1;
 
-                        if (std::find(pushed.begin(), pushed.end(), LINES_BODY[i][1]) == pushed.end()) 
+                        if (landmark.hasSpatial)
                         {
-                            nlohmann::json landmarkJson = {};
-                            pushed.push_back(LINES_BODY[i][1]);
-                            landmarkJson["index"] = LINES_BODY[i][1];
-                            landmarkJson["xpos"] = landmarks_x[LINES_BODY[i][1]];
-                            landmarkJson["ypos"] = landmarks_y[LINES_BODY[i][1]];
-
-                            if (useDepth && count>0)
-                            {
-                                if (useSpatialLocator)
-                                {
-                                    landmarkJson["location.x"] = landmarks_xpos[LINES_BODY[i][1]];
-                                    landmarkJson["location.y"] = landmarks_ypos[LINES_BODY[i][1]];
-                                    landmarkJson["location.z"] = landmarks_zpos[LINES_BODY[i][1]];
-                                }
-                                else
-                                {
-                                    auto spatialData = computeDepth(landmarks_x[LINES_BODY[i][1]],landmarks_y[LINES_BODY[i][1]],frame.rows,depthFrameOrig); 
-                                    /*auto depthData = spatialData[LINES_BODY[i][1]]; 
-                                    auto roi = depthData.config.roi;
-                                    roi = roi.denormalize(depthFrame.cols, depthFrame.rows);*/
-
-                                    for(auto depthData : spatialData) 
-                                    {
-                                        auto roi = depthData.config.roi;
-                                        roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
-                                        landmarks_xpos[LINES_BODY[i][1]] = (int)depthData.spatialCoordinates.x;
-                                        landmarks_ypos[LINES_BODY[i][1]] = (int)depthData.spatialCoordinates.y;
-                                        landmarks_zpos[LINES_BODY[i][1]] = (int)depthData.spatialCoordinates.z;
-
-                                        landmarkJson["location.x"] = landmarks_xpos[LINES_BODY[i][1]];
-                                        landmarkJson["location.y"] = landmarks_ypos[LINES_BODY[i][1]];
-                                        landmarkJson["location.z"] = landmarks_zpos[LINES_BODY[i][1]];
-                                    }
-                                }                                
-                            }
-                            bodyPose.push_back(landmarkJson);
+                            landmark.X = landmarks_xpos[LINES_BODY[i][1]];
+                            landmark.Y = landmarks_ypos[LINES_BODY[i][1]];
+                            landmark.Z = landmarks_zpos[LINES_BODY[i][1]];
                         }
                     }
-                    
                 }
-                bodyPoseJson["landmarks"] = bodyPose;
             }
             
-            // Get Preview image
-            if (getPreview && frame.cols>0 && frame.rows>0)
-            {
-                cv::Mat resizedMat(height, width, frame.type());
-                cv::resize(frame, resizedMat, resizedMat.size(), cv::INTER_CUBIC);
+        }
+    }
+    
+    // Get Preview image
+    if (getPreview && previewNew && frame.cols>0 && frame.rows>0)
+    {
+        cv::Mat resizedMat(height, width, frame.type());
+        cv::resize(frame, resizedMat, resizedMat.size(), cv::INTER_CUBIC);
 
-                toARGB(resizedMat, frameInfo->colorPreviewData);
-            }
+        toARGB(resizedMat, frameInfo->colorPreviewData);
+    }
+
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    if (useIMU) GetIMU(deviceNum, results.imu);
+}
+
+
+extern "C"
+{
+   /**
+    * Pipeline creation based on streams template
+    *
+    * @param config pipeline configuration 
+    * @returns pipeline 
+    */
+    EXPORT_API bool InitBodyPose(PipelineConfig *config)
+    {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
+
+        dai::Pipeline pipeline = createBodyPosePipeline(config);
+       
+        // If deviceId is empty .. just pick first available device
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
+
+        // intrinsics for host side spatial lookups
+        int deviceNum = config->deviceNum;
+        bool depthAlign = config->depthAlign > 0;
+        auto onStarted = [deviceNum, depthAlign](std::shared_ptr<dai::Device> device)
+        {
+            InitSpatialEngine(deviceNum, device, depthAlign);
+        };
+
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy,{},BundlePolicy(),onStarted);
+
+        bool res = DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy);
+        if (res) onStarted(GetDevice(deviceNum));
+
+        return res;
+    }
+
+    /**
+    * Pipeline results
+    *
+    * @param frameInfo camera images pointers
+    * @param getPreview True if color preview image is requested, False otherwise. Requires previewSize in pipeline creation.
+    * @param width Unity preview width canvas
+    * @param height Unity preview height canvas
+    * @param useDepth True if depth information is requested, False otherwise. Requires confidenceThreshold in pipeline creation.
+    * @param retrieveInformation True if system information is requested, False otherwise. Requires rate in pipeline creation.
+    * @param useIMU True if IMU information is requested, False otherwise. Requires freq in pipeline creation.
+    * @param deviceNum Device selection on unity dropdown
+    * @returns Json with results or information about device availability. 
+    */    
+    
+    EXPORT_API const char* BodyPoseResults(FrameInfo *frameInfo, bool getPreview, int width, int height, bool useDepth, bool drawBodyPoseInPreview, float bodyLandmarkScoreThreshold, bool retrieveInformation, bool useIMU, bool useSpatialLocator, int deviceNum)
+    {
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        bodyPoseResults(*results, frameInfo, getPreview, width, height, useDepth, drawBodyPoseInPreview, bodyLandmarkScoreThreshold, retrieveInformation, useIMU, useSpatialLocator, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
 
-            // SYSTEM INFORMATION
-            if (retrieveInformation) bodyPoseJson["sysinfo"] = GetDeviceInfo(device);//infoJson;        
-            if (useIMU) bodyPoseJson["imu"] = GetIMU(device);
+        //{[{"index":0,"xpos","ypos","location.x":0,"location.y":0,"location.z":0},{"index":1,"location.x":0,"location.y":0,"location.z":0}]}
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
 
-            // RETURN JSON
-            char* ret = (char*)::malloc(strlen(bodyPoseJson.dump().c_str())+1);
-            ::memcpy(ret, bodyPoseJson.dump().c_str(),strlen(bodyPoseJson.dump().c_str()));
-            ret[strlen(bodyPoseJson.dump().c_str())] = 0;
+        if (results->numLandmarks > 0)
+        {
+            json.key("landmarks").beginArray();
+            for (int i = 0; i < results->numLandmarks; i++)
+            {
+                const LandmarkResult& landmark = results->landmarks[i];
 
-            return ret;
+                json.beginObject();
+                json.field("index", landmark.index);
+                json.field("xpos", landmark.xpos);
+                json.field("ypos", landmark.ypos);
+                if (landmark.hasSpatial)
+                {
+                    json.field("location.x", landmark.X);
+                    json.field("location.y", landmark.Y);
+                    json.field("location.z", landmark.Z);
+                }
+                json.endObject();
+            }
+            json.endArray();
         }
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
+
+        // RETURN JSON
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
+
+    /**
+    * Pipeline results, binary interface. Same parameters as BodyPoseResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (landmarks, sysinfo, imu)
+    */
+    EXPORT_API FrameResults* BodyPoseResultsBinary(FrameInfo *frameInfo, bool getPreview, int width, int height, bool useDepth, bool drawBodyPoseInPreview, float bodyLandmarkScoreThreshold, bool retrieveInformation, bool useIMU, bool useSpatialLocator, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        bodyPoseResults(*results, frameInfo, getPreview, width, height, useDepth, drawBodyPoseInPreview, bodyLandmarkScoreThreshold, retrieveInformation, useIMU, useSpatialLocator, deviceNum);
+        return EndResults(deviceNum, results);
     }
 }
\ No newline at end of file
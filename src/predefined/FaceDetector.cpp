@@ -15,6 +15,7 @@
 // ------------------------------------------------------------------------
 // Plugin itself
 
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <random>
@@ -26,6 +27,8 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/predefined/FaceDetector.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
@@ -36,6 +39,26 @@
 dai::SpatialLocationCalculatorConfigData sconfig;
 dai::SpatialLocationCalculatorAlgorithm calculationAlgorithm;
 
+// camera aspect ratio (width/height) when preview is display stream, detections are mapped from NN letterbox. 0: preview is NN input
+static float displayAspect[DAI_MAX_DEVICES];
+
+/**
+* Map normalized point from NN letterbox (square, camera frame centered with bars) to camera frame
+*/
+static void letterboxToFrame(float aspect, float& x, float& y)
+{
+    if (aspect >= 1.0f)
+    {
+        float content = 1.0f / aspect;
+        y = std::min(std::max((y - (1.0f - content) * 0.5f) / content, 0.0f), 1.0f);
+    }
+    else
+    {
+        float content = aspect;
+        x = std::min(std::max((x - (1.0f - content) * 0.5f) / content, 0.0f), 1.0f);
+    }
+}
+
 /**
 * Pipeline creation based on streams template
 *
@@ -50,6 +73,8 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
     auto colorCam = pipeline.create<dai::node::ColorCamera>();
 
     // Color camera preview
+    bool display = config->displayWidth > 0 && config->displayHeight > 0;
+    displayAspect[config->deviceNum] = 0.0f;
     if (config->previewSizeWidth > 0 && config->previewSizeHeight > 0)
     {
         xlinkOut = pipeline.create<dai::node::XLinkOut>();
@@ -94,6 +119,7 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
             resy = resy * ((float)config->ispScaleF1/(float)config->ispScaleF2);
         }
         colorCam->setPreviewSize(resx,resy);
+        if (display) displayAspect[config->deviceNum] = (float)resx / (float)resy;
     }
 
     // Color camera properties
@@ -106,6 +132,9 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
 
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
+
 
     // letterbox
     auto manip1 = pipeline.create<dai::node::ImageManip>();
@@ -118,9 +147,26 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
 
     // not for letterbox
     manip1->out.link(nn1->input);
-    manip1->out.link(xlinkOut->input);
     //colorCam->preview.link(nn1->input);
 
+    if (xlinkOut)
+    {
+        if (display)
+        {
+            // display branch: full field of view resized on device, full resolution preview never crosses the link
+            auto manipDisplay = pipeline.create<dai::node::ImageManip>();
+            manipDisplay->initialConfig.setResize(config->displayWidth, config->displayHeight);
+            manipDisplay->initialConfig.setKeepAspectRatio(false);
+            manipDisplay->setMaxOutputFrameSize(config->displayWidth * config->displayHeight * 3);
+            manipDisplay->inputImage.setBlocking(false);
+            manipDisplay->inputImage.setQueueSize(1);
+            colorCam->preview.link(manipDisplay->inputImage);
+            manipDisplay->out.link(xlinkOut->input);
+        }
+        // NN input passthrough (letterbox)
+        else manip1->out.link(xlinkOut->input);
+    }
+
     // output of neural network
     auto nnOut = pipeline.create<dai::node::XLinkOut>();
     nnOut->setStreamName("detections");
@@ -161,6 +207,9 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
         if (config->medianFilter == 2) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_5x5);
         if (config->medianFilter == 3) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_7x7);
 
+        // confidence, median and LR-check can be changed while running (DAISetStereoConfig)
+        AddStereoControl(pipeline, config->deviceNum, stereo);
+
         stereo->setDefaultProfilePreset(dai::node::StereoDepth::PresetMode::HIGH_DENSITY);
 
         // Spatial Locator
@@ -223,8 +272,9 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -239,275 +289,312 @@ dai::Pipeline createFaceDetectorPipeline(PipelineConfig *config)
     return pipeline;
 }
 
-extern "C"
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void faceDetectorResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
 {
-   /**
-    * Pipeline creation based on streams template
-    *
-    * @param config pipeline configuration
-    * @returns pipeline
-    */
-    EXPORT_API bool InitFaceDetector(PipelineConfig *config)
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL)
     {
-        dai::Pipeline pipeline = createFaceDetectorPipeline(config);
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
 
-        // If deviceId is empty .. just pick first available device
-        bool res = false;
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
+    }
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
+    // preview image
+    cv::Mat frame;
+    std::shared_ptr<dai::ImgFrame> imgFrame;
 
-        return res;
-    }
+    // other images
+    cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
 
-    /**
-    * Pipeline results
-    *
-    * @param frameInfo camera images pointers
-    * @param getPreview True if color preview image is requested, False otherwise. Requires previewSize in pipeline creation.
-    * @param useDepth True if depth information is requested, False otherwise. Requires confidenceThreshold in pipeline creation.
-    * @param retrieveInformation True if system information is requested, False otherwise. Requires rate in pipeline creation.
-    * @param useIMU True if IMU information is requested, False otherwise. Requires freq in pipeline creation.
-    * @param deviceNum Device selection on unity dropdown
-    * @returns Json with results or information about device availability.
-    */
+    std::shared_ptr<dai::DataInputQueue> spatialCalcConfigInQueue;
 
-    /**
-    * Example of json returned
-    * { "faces": [ {"label":0,"score":0.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,"ymax":0.0,"xcenter":0.0,"ycenter":0.0},{"label":1,"score":1.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,* "ymax":0.0,"xcenter":0.0,"ycenter":0.0}],"best":{"label":1,"score":1.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,"ymax":0.0,"xcenter":0.0,"ycenter":0.0},"fps":0.0}
-    */
+    // preview, detections and depth of same capture from acquisition thread. isNew is false if bundle was already processed
+    // worker held until results are written, frames can be views of its messages
+    bool isNew = false;
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    AcquiredBundle* bundle = GetBundle(acquisition, &isNew);
+    AcquiredMessage* acquired;
 
-    EXPORT_API const char* FaceDetectorResults(FrameInfo *frameInfo, bool getPreview, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
-    {
-        using namespace std;
-        using namespace std::chrono;
+    // if depth images are requested. All images.
+    if (useDepth) spatialCalcConfigInQueue = GetInputQueue(deviceNum, "spatialCalcConfig");
 
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL)
+    int countd = 0;
+
+    // if preview image is requested. True in this case.
+    if (getPreview && bundle)
+    {
+        acquired = bundle->get("preview");
+        if (acquired)
         {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
+            frame = acquired->frame;
+            // only draw and upload new frames
+            if (isNew) countd = 1;
         }
+    }
+
+    results.previewWidth = frame.cols;
+    results.previewHeight = frame.rows;
 
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
+    int count;
+    // In this case we allocate before Texture2D (ARGB32) and memcpy pointer data
+    if (useDepth)
+    {
+        // Depth
+        // depth of same capture, ROIs are mapped with its size
+        acquired = bundle ? bundle->get("depth") : NULL;
+        count = acquired ? 1 : 0;
+        if (count > 0)
         {
-            // preview image
-            cv::Mat frame;
-            std::shared_ptr<dai::ImgFrame> imgFrame;
+            depthFrameOrig = acquired->frame;
+            // only frame size is used to map ROIs, no visualization needed
+            depthFrame = depthFrameOrig;
+        }
+    }
 
-            // other images
-            cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
+    // Face detection results
+    struct Detection {
+        unsigned int label;
+        float score;
+        float x_min;
+        float y_min;
+        float x_max;
+        float y_max;
+    };
+
+    vector<Detection> dets;
+
+    // display stream: map detections from NN letterbox to camera frame. Depth ROIs use same field of view
+    float aspect = displayAspect[deviceNum];
+    int depthMode = aspect > 0.0f ? 2 : 1;
+
+    // detections of preview frame
+    std::vector<float> detData;
+    acquired = bundle ? bundle->get("detections") : NULL;
+    if (acquired) detData = acquired->get<dai::NNData>()->getFirstLayerFp16();
+    float maxScore = 0.0;
+    int maxPos = 0;
+
+    dai::SpatialLocationCalculatorConfig cfg;
+
+    // depth thresholds of ROIs sent to device, can be changed while running (DAISetSpatialThresholds)
+    float lowerThreshold = 100, upperThreshold = 10000;
+    GetSpatialThresholds(deviceNum, lowerThreshold, upperThreshold);
+    sconfig.depthThresholds.lowerThreshold = (uint32_t) lowerThreshold;
+    sconfig.depthThresholds.upperThreshold = (uint32_t) upperThreshold;
+
+    if(detData.size() > 0){
+        int i = 0;
+        while (detData[i*7] != -1.0f && i*7 < (int)detData.size()) {
+
+            Detection d;
+            d.label = detData[i*7 + 1];
+            d.score = detData[i*7 + 2];
+            if (d.score > maxScore)
+            {
+                maxScore = d.score;
+                maxPos = i;
+            }
+            d.x_min = detData[i*7 + 3];
+            d.y_min = detData[i*7 + 4];
+            d.x_max = detData[i*7 + 5];
+            d.y_max = detData[i*7 + 6];
+            i++;
 
-            // face info
-            nlohmann::json faceDetectorJson = {};
+            if (aspect > 0.0f)
+            {
+                letterboxToFrame(aspect, d.x_min, d.y_min);
+                letterboxToFrame(aspect, d.x_max, d.y_max);
+            }
 
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
-            std::shared_ptr<dai::DataOutputQueue> spatialCalcQueue;
-            std::shared_ptr<dai::DataInputQueue> spatialCalcConfigInQueue;
+            if (faceScoreThreshold <= d.score)
+            {
+                int x1 = d.x_min * frame.cols;
+                int y1 = d.y_min * frame.rows;
+                int x2 = d.x_max * frame.cols;
+                int y2 = d.y_max * frame.rows;
+                int mx = x1 + ((x2 - x1) / 2);
+                int my = y1 + ((y2 - y1) / 2);
+
+                //sconfig.roi = prepareComputeDepth(depthFrame,frame,mx,my,0);
+                sconfig.roi = prepareComputeDepth(depthFrame,frame,mx,my,depthMode);
+                sconfig.calculationAlgorithm = calculationAlgorithm;
+                cfg.addROI(sconfig);
+
+                dets.push_back(d);
+            }
+        }
+    }
 
-            // face detector results
-            auto detections = device->getOutputQueue("detections",1,false);
 
-            // if preview image is requested. True in this case.
-            if (getPreview) preview = device->getOutputQueue("preview",1,false);
+    // send spatial
+    if (dets.size() > 0)
+    {
 
-            // if depth images are requested. All images.
-            if (useDepth)
-            {
-                depthQueue = device->getOutputQueue("depth", 8, false);
-                spatialCalcQueue = device->getOutputQueue("spatialData", 8, false);
-                spatialCalcConfigInQueue = device->getInputQueue("spatialCalcConfig");
-            }
+        // get spatial. Reply for these ROIs (or previous ones until it arrives), locations are in dets order
+        std::vector<dai::SpatialLocations> spatialData;
+        if (useDepth)
+        {
+            spatialCalcConfigInQueue->send(cfg);
+            getSpatialReply(deviceNum, cfg, spatialData);
+        }
+
+        int i = 0;
+        // write results
+        for(auto d : dets) {
+            int x1 = d.x_min * frame.cols;
+            int y1 = d.y_min * frame.rows;
+            int x2 = d.x_max * frame.cols;
+            int y2 = d.y_max * frame.rows;
+            int mx = x1 + ((x2 - x1) / 2);
+            int my = y1 + ((y2 - y1) / 2);
 
-            int countd;
+            if (getPreview && countd > 0 && drawAllFacesInPreview) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
 
-            if (getPreview)
+            DetectionResult* face = AddDetection(results);
+            if (face != NULL)
             {
-                auto imgFrames = preview->tryGetAll<dai::ImgFrame>();
-                countd = imgFrames.size();
-                if (countd > 0) {
-                    auto imgFrame = imgFrames[countd-1];
-                    if(imgFrame){
-                        frame = toMat(imgFrame->getData(), imgFrame->getWidth(), imgFrame->getHeight(), 3, 1);
-                    }
+                face->label = d.label;
+                face->score = d.score;
+                face->xmin = d.x_min;
+                face->ymin = d.y_min;
+                face->xmax = d.x_max;
+                face->ymax = d.y_max;
+                face->xcenter = mx;
+                face->ycenter = my;
+
+                if (useDepth && i < (int)spatialData.size()) {
+                    face->hasSpatial = 1;
+                    face->X = (int)spatialData.at(i).spatialCoordinates.x;
+                    face->Y = (int)spatialData.at(i).spatialCoordinates.y;
+                    face->Z = (int)spatialData.at(i).spatialCoordinates.z;
                 }
             }
 
-            vector<std::shared_ptr<dai::ImgFrame>> imgDepthFrames,imgDispFrames,imgMonoRFrames,imgMonoLFrames;
-            std::shared_ptr<dai::ImgFrame> imgDepthFrame,imgDispFrame,imgMonoRFrame,imgMonoLFrame;
-
-            int count;
-            // In this case we allocate before Texture2D (ARGB32) and memcpy pointer data
-            if (useDepth)
+            if (i == maxPos)
             {
-                // Depth
-                imgDepthFrames = depthQueue->tryGetAll<dai::ImgFrame>();
-                count = imgDepthFrames.size();
-                if (count > 0)
+                if (face != NULL) results.best = results.numDetections - 1;
+
+                if (getPreview && countd > 0 && drawBestFaceInPreview)
                 {
-                    imgDepthFrame = imgDepthFrames[count-1];
-                    depthFrameOrig = imgDepthFrame->getFrame();
-                    cv::normalize(depthFrameOrig, depthFrame, 255, 0, cv::NORM_INF, CV_8UC1);
-                    cv::equalizeHist(depthFrame, depthFrame);
-                    cv::cvtColor(depthFrame, depthFrame, cv::COLOR_GRAY2BGR);
+                    cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
                 }
             }
 
-            // Face detection results
-            struct Detection {
-                unsigned int label;
-                float score;
-                float x_min;
-                float y_min;
-                float x_max;
-                float y_max;
-            };
-
-            vector<Detection> dets;
-
-            auto det = detections->get<dai::NNData>();
-            std::vector<float> detData = det->getFirstLayerFp16();
-            float maxScore = 0.0;
-            int maxPos = 0;
-
-            nlohmann::json facesArr = {};
-            nlohmann::json bestFace = {};
-
-            dai::SpatialLocationCalculatorConfig cfg;
-
-            if(detData.size() > 0){
-                int i = 0;
-                while (detData[i*7] != -1.0f && i*7 < (int)detData.size()) {
-
-                    Detection d;
-                    d.label = detData[i*7 + 1];
-                    d.score = detData[i*7 + 2];
-                    if (d.score > maxScore)
-                    {
-                        maxScore = d.score;
-                        maxPos = i;
-                    }
-                    d.x_min = detData[i*7 + 3];
-                    d.y_min = detData[i*7 + 4];
-                    d.x_max = detData[i*7 + 5];
-                    d.y_max = detData[i*7 + 6];
-                    i++;
-
-                    if (faceScoreThreshold <= d.score)
-                    {
-                        int x1 = d.x_min * frame.cols;
-                        int y1 = d.y_min * frame.rows;
-                        int x2 = d.x_max * frame.cols;
-                        int y2 = d.y_max * frame.rows;
-                        int mx = x1 + ((x2 - x1) / 2);
-                        int my = y1 + ((y2 - y1) / 2);
-
-                        //sconfig.roi = prepareComputeDepth(depthFrame,frame,mx,my,0);
-                        sconfig.roi = prepareComputeDepth(depthFrame,frame,mx,my,1);
-                        sconfig.calculationAlgorithm = calculationAlgorithm;
-                        cfg.addROI(sconfig);
-
-                        dets.push_back(d);
-                    }
-                }
-            }
+            i++;
+        }
+    }
 
+    if (getPreview && countd>0) toARGB(frame,frameInfo->colorPreviewData);
 
-            // send spatial
-            if (dets.size() > 0)
-            {
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    // IMU
+    if (useIMU) GetIMU(deviceNum, results.imu, bundle ? bundle->timestamp : 0);
 
-                if (useDepth) spatialCalcConfigInQueue->send(cfg);
-
-                // get spatial
-                std::vector<dai::SpatialLocations> spatialData;
-                if (useDepth) spatialData = spatialCalcQueue->get<dai::SpatialLocationCalculatorData>()->getSpatialLocations();
-
-                int i = 0;
-                // write jsons
-                for(auto d : dets) {
-                    nlohmann::json face;
-                    face["label"] = d.label;
-                    face["score"] = d.score;
-                    face["xmin"] = d.x_min;
-                    face["ymin"] = d.y_min;
-                    face["xmax"] = d.x_max;
-                    face["ymax"] = d.y_max;
-                    int x1 = d.x_min * frame.cols;
-                    int y1 = d.y_min * frame.rows;
-                    int x2 = d.x_max * frame.cols;
-                    int y2 = d.y_max * frame.rows;
-                    int mx = x1 + ((x2 - x1) / 2);
-                    int my = y1 + ((y2 - y1) / 2);
-                    face["xcenter"] = mx;
-                    face["ycenter"] = my;
-
-                    if (getPreview && countd > 0 && drawAllFacesInPreview) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
-
-                    if (useDepth) {
-                        auto roi = spatialData[i].config.roi;
-                        roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
-
-                        face["X"] = (int)spatialData.at(i).spatialCoordinates.x;
-                        face["Y"] = (int)spatialData.at(i).spatialCoordinates.y;
-                        face["Z"] = (int)spatialData.at(i).spatialCoordinates.z;
-                    }
-                    facesArr.push_back(face);
-
-                    if (i == maxPos)
-                    {
-                        bestFace["label"] = d.label;
-                        bestFace["score"] = d.score;
-                        bestFace["xmin"] = d.x_min;
-                        bestFace["ymin"] = d.y_min;
-                        bestFace["xmax"] = d.x_max;
-                        bestFace["ymax"] = d.y_max;
-                        bestFace["xcenter"] = mx;
-                        bestFace["ycenter"] = my;
-
-                        if (useDepth) {
-                            bestFace["X"] = (int)spatialData.at(i).spatialCoordinates.x;
-                            bestFace["Y"] = (int)spatialData.at(i).spatialCoordinates.y;
-                            bestFace["Z"] = (int)spatialData.at(i).spatialCoordinates.z;
-                        }
-
-                        if (getPreview && countd > 0 && drawBestFaceInPreview)
-                        {
-                            cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
-                        }
-                    }
-
-                    i++;
-                }
-            }
+}
 
-            if (getPreview && countd>0) toARGB(frame,frameInfo->colorPreviewData);
 
-            faceDetectorJson["faces"] = facesArr;
-            faceDetectorJson["best"] = bestFace;
+extern "C"
+{
+   /**
+    * Pipeline creation based on streams template
+    *
+    * @param config pipeline configuration
+    * @returns pipeline
+    */
+    EXPORT_API bool InitFaceDetector(PipelineConfig *config)
+    {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
 
-            // SYSTEM INFORMATION
-            if (retrieveInformation) faceDetectorJson["sysinfo"] = GetDeviceInfo(device);
-            // IMU
-            if (useIMU) faceDetectorJson["imu"] = GetIMU(device);
+        dai::Pipeline pipeline = createFaceDetectorPipeline(config);
 
-            char* ret = (char*)::malloc(strlen(faceDetectorJson.dump().c_str())+1);
-            ::memcpy(ret, faceDetectorJson.dump().c_str(),strlen(faceDetectorJson.dump().c_str()));
-            ret[strlen(faceDetectorJson.dump().c_str())] = 0;
+        // preview, detections and depth matched by capture, within half frame period
+        float fps = config->colorCameraFPS > 0.0f ? config->colorCameraFPS : 30.0f;
+        BundlePolicy bundle({"preview", "detections", "depth"}, 500.0f / fps);
 
-            return ret;
-        }
+        // If deviceId is empty .. just pick first available device
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
+
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy,{},bundle);
+        return DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy,{},bundle);
+    }
+
+    /**
+    * Pipeline results
+    *
+    * @param frameInfo camera images pointers
+    * @param getPreview True if color preview image is requested, False otherwise. Requires previewSize in pipeline creation.
+    * @param useDepth True if depth information is requested, False otherwise. Requires confidenceThreshold in pipeline creation.
+    * @param retrieveInformation True if system information is requested, False otherwise. Requires rate in pipeline creation.
+    * @param useIMU True if IMU information is requested, False otherwise. Requires freq in pipeline creation.
+    * @param deviceNum Device selection on unity dropdown
+    * @returns Json with results or information about device availability. At most DAI_MAX_DETECTIONS faces,
+    * "dropped_detections" counts faces over the cap when there are more
+    */
+
+    /**
+    * Example of json returned
+    * { "faces": [ {"label":0,"score":0.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,"ymax":0.0,"xcenter":0.0,"ycenter":0.0},{"label":1,"score":1.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,* "ymax":0.0,"xcenter":0.0,"ycenter":0.0}],"best":{"label":1,"score":1.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,"ymax":0.0,"xcenter":0.0,"ycenter":0.0},"fps":0.0}
+    */
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+    EXPORT_API const char* FaceDetectorResults(FrameInfo *frameInfo, bool getPreview, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
+    {
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        faceDetectorResults(*results, frameInfo, getPreview, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
+
+        // face info
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
+
+        json.key("faces").beginArray();
+        for (int i = 0; i < results->numDetections; i++) WriteDetection(json, results->detections[i]);
+        json.endArray();
+        if (results->droppedDetections > 0) json.field("dropped_detections", results->droppedDetections);
+
+        json.key("best");
+        if (results->best >= 0) WriteDetection(json, results->detections[results->best]);
+        else json.null();
+
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        // IMU
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
+
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
+
+    /**
+    * Pipeline results, binary interface. Same parameters as FaceDetectorResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (faces, best face, sysinfo, imu)
+    */
+    EXPORT_API FrameResults* FaceDetectorResultsBinary(FrameInfo *frameInfo, bool getPreview, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        faceDetectorResults(*results, frameInfo, getPreview, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        return EndResults(deviceNum, results);
     }
 
 
@@ -26,12 +26,20 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/predefined/FaceEmotion.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
+#include "depthai-unity/predefined/SecondStage.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
 #include "nlohmann/json.hpp"
 
+// second stage input buffers per device
+static TensorPool tensorPool[DAI_MAX_DEVICES];
+// second stage replies per face of last detections, reported until new detections arrive
+static std::vector<std::shared_ptr<dai::NNData>> secondStageReplies[DAI_MAX_DEVICES];
+
 /**
 * Pipeline creation based on streams template
 *
@@ -65,6 +73,9 @@ dai::Pipeline createFaceEmotionPipeline(PipelineConfig *config)
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
 
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
+
     // neural network
     auto nn1 = pipeline.create<dai::node::NeuralNetwork>();
     nn1->setBlobPath(config->nnPath1);
@@ -122,6 +133,9 @@ dai::Pipeline createFaceEmotionPipeline(PipelineConfig *config)
         if (config->medianFilter == 2) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_5x5);
         if (config->medianFilter == 3) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_7x7);
 
+        // confidence, median and LR-check can be changed while running (DAISetStereoConfig)
+        AddStereoControl(pipeline, config->deviceNum, stereo);
+
         // Linking
         left->out.link(stereo->left);
         right->out.link(stereo->right);
@@ -154,8 +168,9 @@ dai::Pipeline createFaceEmotionPipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -170,6 +185,255 @@ dai::Pipeline createFaceEmotionPipeline(PipelineConfig *config)
     return pipeline;
 }
 
+// emotion scores, null if second stage didn't reply
+static void writeEmotion(JsonWriter& json, const EmotionResult& emotion)
+{
+    if (!emotion.valid)
+    {
+        json.null();
+        return;
+    }
+    json.beginObject();
+    json.field("neutral", emotion.neutral);
+    json.field("happy", emotion.happy);
+    json.field("sad", emotion.sad);
+    json.field("surprise", emotion.surprise);
+    json.field("anger", emotion.anger);
+    json.endObject();
+}
+
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void faceEmotionResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, int width, int height, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL) 
+    {
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
+
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
+    }
+
+    // preview image
+    cv::Mat frame;
+    std::shared_ptr<dai::ImgFrame> imgFrame;
+
+    // other images
+    cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
+
+    // latest frames from acquisition thread. isNew is false if frame was already processed
+    // worker held until results are written, frames can be views of its messages
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    bool previewNew = false;
+    AcquiredMessage* acquired;
+
+    // second stage is request/response, landm_out is not acquired
+    auto landm_in = GetInputQueue(deviceNum, "landm_in");
+    auto landm_out = GetOutputQueue(deviceNum, "landm_out");
+
+    // if preview image is requested. True in this case.
+    if (getPreview)
+    {
+        acquired = GetAcquired(acquisition, "preview", &previewNew);
+        if (acquired) frame = acquired->frame;
+    }
+
+    struct Detection {
+        unsigned int label;
+        float score;
+        float x_min;
+        float y_min;
+        float x_max;
+        float y_max;
+    };
+
+    vector<Detection> dets;
+
+    // face detections (latest, could be from previous results call). Second stage only runs on new ones
+    std::vector<float> detData;
+    bool detectionsNew = false;
+    acquired = GetAcquired(acquisition, "detections", &detectionsNew);
+    if (acquired) detData = acquired->get<dai::NNData>()->getFirstLayerFp16();
+    float maxScore = 0.0;
+    int maxPos = 0;
+
+    results.previewWidth = frame.cols;
+    results.previewHeight = frame.rows;
+
+    int count = 0;
+
+    if (useDepth)
+    {            
+        // latest depth
+        bool depthNew = false;
+        acquired = GetAcquired(acquisition, "depth", &depthNew);
+        count = acquired ? 1 : 0;
+        if (count > 0)
+        {
+            depthFrameOrig = acquired->frame;
+            // host side spatial lookups on this frame (summed-area tables only rebuilt for new frames)
+            float lowerThreshold = 100, upperThreshold = 50000;
+            GetSpatialThresholds(deviceNum, lowerThreshold, upperThreshold);
+            if (depthNew) GetSpatialEngine(deviceNum).update(depthFrameOrig, lowerThreshold, upperThreshold);
+            // only frame size is used to map ROIs, no visualization needed
+            depthFrame = depthFrameOrig;
+        }
+    }
+    
+    if(detData.size() > 0){
+        int i = 0;
+        while (detData[i*7] != -1.0f && i*7 < (int)detData.size()) {
+            
+            Detection d;
+            d.label = detData[i*7 + 1];
+            d.score = detData[i*7 + 2];
+            if (d.score >= faceScoreThreshold)
+            {
+                if (d.score > maxScore) 
+                {
+                    maxScore = d.score;
+                    maxPos = i;
+                }
+                d.x_min = detData[i*7 + 3];
+                d.y_min = detData[i*7 + 4];
+                d.x_max = detData[i*7 + 5];
+                d.y_max = detData[i*7 + 6];
+                dets.push_back(d);
+            }
+            i++;
+        }
+    }
+
+    // faces waiting for second stage
+    struct Face {
+        int x1, y1, x2, y2, mx, my;
+        // index in results detections
+        int result;
+    };
+    std::vector<Face> faces;
+    std::vector<std::shared_ptr<dai::RawBuffer>> tensors;
+
+    int i = 0;
+    for(const auto& d : dets){
+        int x1 = d.x_min * frame.cols;
+        int y1 = d.y_min * frame.rows;
+        int x2 = d.x_max * frame.cols;
+        int y2 = d.y_max * frame.rows;
+        int mx = x1 + ((x2 - x1) / 2);
+        int my = y1 + ((y2 - y1) / 2);
+
+        // m_mx = mx;
+        // m_my = my;
+
+        if (faceScoreThreshold <= d.score)
+        {
+            if (x1 <= 0) x1 = 0;
+            if (y1 <= 0) y1 = 0;
+            if (x2 >= 300) x2 = 300;
+            if (y2 >= 300) y2 = 300;
+            cv::Rect faceRect = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)) & cv::Rect(0, 0, frame.cols, frame.rows);
+
+            // second stage input. Crops are taken before any drawing on preview
+            DetectionResult* face = NULL;
+            if (faceRect.width > 0 && faceRect.height > 0) face = AddDetection(results);
+            if (face != NULL)
+            {
+                face->label = d.label;
+                face->score = d.score;
+                face->xmin = d.x_min;
+                face->ymin = d.y_min;
+                face->xmax = d.x_max;
+                face->ymax = d.y_max;
+                face->xcenter = mx;
+                face->ycenter = my;
+                if (i == maxPos) results.best = results.numDetections - 1;
+
+                if (detectionsNew)
+                {
+                    auto tensor = tensorPool[deviceNum].acquire();
+                    toPlanarTensor(frame, faceRect, cv::Size(64,64), TensorType::U8, 0, tensor->data);
+                    tensors.push_back(tensor);
+                }
+                faces.push_back({x1, y1, x2, y2, mx, my, results.numDetections - 1});
+            }
+        }
+        i++;
+    }
+
+    // ------------------------- SECOND STAGE - FACE EMOTION
+    // all faces in flight at once, results correlated by sequence number. Calls in between reuse replies
+    if (detectionsNew) secondStageReplies[deviceNum] = RunSecondStage(landm_in, landm_out, tensors);
+    const std::vector<std::shared_ptr<dai::NNData>>& detfaces = secondStageReplies[deviceNum];
+
+    for (size_t k = 0; k < faces.size(); k++)
+    {
+        int x1 = faces[k].x1, y1 = faces[k].y1, x2 = faces[k].x2, y2 = faces[k].y2;
+        int mx = faces[k].mx, my = faces[k].my;
+        DetectionResult& face = results.detections[faces[k].result];
+        EmotionResult& faceEmotion = results.emotions[faces[k].result];
+
+        // faces can differ from replies if preview size changed since detections arrived
+        std::vector<float> detfaceYData;
+        if (k < detfaces.size() && detfaces[k]) detfaceYData = detfaces[k]->getFirstLayerFp16();
+
+        if (detfaceYData.size() >= 5)
+        {
+            faceEmotion.valid = 1;
+            faceEmotion.neutral = detfaceYData[0];
+            faceEmotion.happy = detfaceYData[1];
+            faceEmotion.sad = detfaceYData[2];
+            faceEmotion.surprise = detfaceYData[3];
+            faceEmotion.anger = detfaceYData[4];
+        }
+
+        if (useDepth && count>0)
+        {
+            auto spatialData = computeDepth(GetSpatialEngine(deviceNum),mx,my,frame.rows); 
+
+            for(auto depthData : spatialData) {
+                auto roi = depthData.config.roi;
+                roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
+
+                face.hasSpatial = 1;
+                face.X = (int)depthData.spatialCoordinates.x;
+                face.Y = (int)depthData.spatialCoordinates.y;
+                face.Z = (int)depthData.spatialCoordinates.z;
+            }
+        }
+
+        if (drawBestFaceInPreview && previewNew) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
+    }
+
+    if (getPreview && previewNew && frame.cols>0 && frame.rows>0) 
+    {
+        cv::Mat resizedMat(height, width, frame.type());
+        cv::resize(frame, resizedMat, resizedMat.size(), cv::INTER_CUBIC);
+
+        toARGB(frame,frameInfo->colorPreviewData);
+    }
+
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    // IMU
+    if (useIMU) GetIMU(deviceNum, results.imu);
+
+}
+
+
 extern "C"
 {
     /**
@@ -180,14 +444,29 @@ extern "C"
     */
     EXPORT_API bool InitFaceEmotion(PipelineConfig *config)
     {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
+
         dai::Pipeline pipeline = createFaceEmotionPipeline(config);
 
         // If deviceId is empty .. just pick first available device
-        bool res = false;
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
+
+        // intrinsics for host side spatial lookups
+        int deviceNum = config->deviceNum;
+        bool depthAlign = config->depthAlign > 0;
+        auto onStarted = [deviceNum, depthAlign](std::shared_ptr<dai::Device> device)
+        {
+            InitSpatialEngine(deviceNum, device, depthAlign);
+        };
+
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy,{"landm_out"},BundlePolicy(),onStarted);
+
+        bool res = DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy,{"landm_out"});
+        if (res) onStarted(GetDevice(deviceNum));
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);        
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
-        
         return res;
     }
 
@@ -210,267 +489,50 @@ extern "C"
 
     EXPORT_API const char* FaceEmotionResults(FrameInfo *frameInfo, bool getPreview, int width, int height, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
     {
-        using namespace std;
-        using namespace std::chrono;
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        faceEmotionResults(*results, frameInfo, getPreview, width, height, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
 
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL) 
-        {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
-        }
+        // {"best":{"label":1,"score":1.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,"ymax":0.0,"xcenter":0.0,"ycenter":0.0},"emotion":{"happy":0.0,"sad":0.0,"surprise":0.0,.....}}
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
 
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
-        {
-            // preview image
-            cv::Mat frame;
-            std::shared_ptr<dai::ImgFrame> imgFrame;
+        json.key("best");
+        if (results->best >= 0) WriteDetection(json, results->detections[results->best]);
+        else json.null();
 
-            // other images
-            cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
+        json.key("bestFaceEmotion");
+        if (results->best >= 0) writeEmotion(json, results->emotions[results->best]);
+        else json.null();
 
-            // {"best":{"label":1,"score":1.0,"xmin":0.0,"ymin":0.0,"xmax":0.0,"ymax":0.0,"xcenter":0.0,"ycenter":0.0},"emotion":{"happy":0.0,"sad":0.0,"surprise":0.0,.....}}
-            nlohmann::json faceEmotionJson;
+        json.key("faces").beginArray();
+        for (int i = 0; i < results->numDetections; i++) WriteDetection(json, results->detections[i]);
+        json.endArray();
 
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
+        json.key("emotions").beginArray();
+        for (int i = 0; i < results->numDetections; i++) writeEmotion(json, results->emotions[i]);
+        json.endArray();
 
-            // if preview image is requested. True in this case.
-            if (getPreview) preview = device->getOutputQueue("preview",1,false);
-            
-            // face emotion results
-            auto detections = device->getOutputQueue("detections",1,false);
-            
-            auto landm_in = device->getInputQueue("landm_in");
-            auto landm_out = device->getOutputQueue("landm_out");
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        // IMU
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
 
-            // if depth images are requested. All images.
-            if (useDepth) depthQueue = device->getOutputQueue("depth", 1, false);
-            
-            if (getPreview)
-            {
-                auto imgFrames = preview->tryGetAll<dai::ImgFrame>();
-                auto countd = imgFrames.size();
-                if (countd > 0) {
-                    auto imgFrame = imgFrames[countd-1];
-                    if(imgFrame){
-                        frame = toMat(imgFrame->getData(), imgFrame->getWidth(), imgFrame->getHeight(), 3, 1);
-                    }
-                }
-            }
-        
-            struct Detection {
-                unsigned int label;
-                float score;
-                float x_min;
-                float y_min;
-                float x_max;
-                float y_max;
-            };
-
-            vector<Detection> dets;
-
-            auto det = detections->get<dai::NNData>();
-            std::vector<float> detData = det->getFirstLayerFp16();
-            float maxScore = 0.0;
-            int maxPos = 0;
-
-            nlohmann::json facesArr = {};
-            nlohmann::json emotionsArr = {};
-            nlohmann::json bestFace = {};
-            nlohmann::json bestFaceEmotion = {};
-
-            int count;
-            vector<std::shared_ptr<dai::ImgFrame>> imgDepthFrames;
-            std::shared_ptr<dai::ImgFrame> imgDepthFrame;
-
-            if (useDepth)
-            {            
-                imgDepthFrames = depthQueue->tryGetAll<dai::ImgFrame>();
-                count = imgDepthFrames.size();
-                if (count > 0)
-                {
-                    imgDepthFrame = imgDepthFrames[count-1];
-                    depthFrameOrig = imgDepthFrame->getFrame();
-                    cv::normalize(depthFrameOrig, depthFrame, 255, 0, cv::NORM_INF, CV_8UC1);
-                    cv::equalizeHist(depthFrame, depthFrame);
-                    cv::cvtColor(depthFrame, depthFrame, cv::COLOR_GRAY2BGR);
-                }
-            }
-            
-            if(detData.size() > 0){
-                int i = 0;
-                while (detData[i*7] != -1.0f && i*7 < (int)detData.size()) {
-                    
-                    Detection d;
-                    d.label = detData[i*7 + 1];
-                    d.score = detData[i*7 + 2];
-                    if (d.score >= faceScoreThreshold)
-                    {
-                        if (d.score > maxScore) 
-                        {
-                            maxScore = d.score;
-                            maxPos = i;
-                        }
-                        d.x_min = detData[i*7 + 3];
-                        d.y_min = detData[i*7 + 4];
-                        d.x_max = detData[i*7 + 5];
-                        d.y_max = detData[i*7 + 6];
-                        dets.push_back(d);
-                    }
-                    i++;
-                }
-            }
-            int i = 0;
-            cv::Mat faceFrame;
-            for(const auto& d : dets){
-                int x1 = d.x_min * frame.cols;
-                int y1 = d.y_min * frame.rows;
-                int x2 = d.x_max * frame.cols;
-                int y2 = d.y_max * frame.rows;
-                int mx = x1 + ((x2 - x1) / 2);
-                int my = y1 + ((y2 - y1) / 2);
-
-                // m_mx = mx;
-                // m_my = my;
-
-                if (faceScoreThreshold <= d.score)
-                {
-                    if (i==maxPos)
-                    {
-                        bestFace["label"] = d.label;
-                        bestFace["score"] = d.score;
-                        bestFace["xmin"] = d.x_min;
-                        bestFace["ymin"] = d.y_min;
-                        bestFace["xmax"] = d.x_max;
-                        bestFace["ymax"] = d.y_max;
-                        bestFace["xcenter"] = mx;
-                        bestFace["ycenter"] = my;
-                    }
-
-                    nlohmann::json face;
-
-                    face["label"] = d.label;
-                    face["score"] = d.score;
-                    face["xmin"] = d.x_min;
-                    face["ymin"] = d.y_min;
-                    face["xmax"] = d.x_max;
-                    face["ymax"] = d.y_max;
-                    face["xcenter"] = mx;
-                    face["ycenter"] = my;
-
-                    if (x1 > 0 && y1 > 0 && x2 < 300 && y2 < 300)
-                        faceFrame = frame(cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)));
-                    else  
-                    {
-                        if (x1 <= 0) x1 = 0;
-                        if (y1 <= 0) y1 = 0;
-                        if (x2 >= 300) x2 = 300;
-                        if (y2 >= 300) y2 = 300;
-                        faceFrame = frame(cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)));
-                    }
-
-                    // ------------------------- SECOND STAGE - FACE EMOTION
-
-                    dai::NNData data_in;
-
-                    auto tensor = std::make_shared<dai::RawBuffer>();
-                    if (faceFrame.cols > 0 && faceFrame.rows > 0)
-                    {
-                        cv::Mat frame2 = resizeKeepAspectRatio(faceFrame, cv::Size(64,64), cv::Scalar(0));
-
-                        toPlanar(frame2, tensor->data);
-
-                        landm_in->send(tensor);
-
-                        auto detface = landm_out->get<dai::NNData>();
-                        std::vector<float> detfaceYData = detface->getFirstLayerFp16();
-                        
-                        nlohmann::json faceEmotion;
-
-                        if (detfaceYData.size() > 0)
-                        {
-                            if (i == maxPos)
-                            {
-                                bestFaceEmotion["neutral"] = detfaceYData[0];
-                                bestFaceEmotion["happy"] = detfaceYData[1];
-                                bestFaceEmotion["sad"] = detfaceYData[2];
-                                bestFaceEmotion["surprise"] = detfaceYData[3];
-                                bestFaceEmotion["anger"] = detfaceYData[4];
-                            }
-
-                            faceEmotion["neutral"] = detfaceYData[0];
-                            faceEmotion["happy"] = detfaceYData[1];
-                            faceEmotion["sad"] = detfaceYData[2];
-                            faceEmotion["surprise"] = detfaceYData[3];
-                            faceEmotion["anger"] = detfaceYData[4];
-                        }
-
-                        if (useDepth && count>0)
-                        {
-                            auto spatialData = computeDepth(mx,my,frame.rows,depthFrameOrig); 
-
-                            for(auto depthData : spatialData) {
-                                auto roi = depthData.config.roi;
-                                roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
-
-                                if (i == maxPos)
-                                {
-                                    bestFace["X"] = (int)depthData.spatialCoordinates.x;
-                                    bestFace["Y"] = (int)depthData.spatialCoordinates.y;
-                                    bestFace["Z"] = (int)depthData.spatialCoordinates.z;
-                                }
-
-                                face["X"] = (int)depthData.spatialCoordinates.x;
-                                face["Y"] = (int)depthData.spatialCoordinates.y;
-                                face["Z"] = (int)depthData.spatialCoordinates.z;
-                            }
-                        }
-
-                        facesArr.push_back(face);
-                        emotionsArr.push_back(faceEmotion);
-
-                        if (drawBestFaceInPreview) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
-                    }
-                }
-                i++;
-            }
-
-            if (getPreview && frame.cols>0 && frame.rows>0) 
-            {
-                cv::Mat resizedMat(height, width, frame.type());
-                cv::resize(frame, resizedMat, resizedMat.size(), cv::INTER_CUBIC);
-
-                toARGB(frame,frameInfo->colorPreviewData);
-            }
-
-            // SYSTEM INFORMATION
-            if (retrieveInformation) faceEmotionJson["sysinfo"] = GetDeviceInfo(device);        
-            // IMU
-            if (useIMU) faceEmotionJson["imu"] = GetIMU(device);
-
-            // RETURN JSON
-            faceEmotionJson["best"] = bestFace;
-            faceEmotionJson["bestFaceEmotion"] = bestFaceEmotion;
-            faceEmotionJson["faces"] = facesArr;
-            faceEmotionJson["emotions"] = emotionsArr;
-
-            char* ret = (char*)::malloc(strlen(faceEmotionJson.dump().c_str())+1);
-            ::memcpy(ret, faceEmotionJson.dump().c_str(),strlen(faceEmotionJson.dump().c_str()));
-            ret[strlen(faceEmotionJson.dump().c_str())] = 0;
-
-            return ret;
-        }
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+    /**
+    * Pipeline results, binary interface. Same parameters as FaceEmotionResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (faces, emotions of each face, best face, sysinfo, imu)
+    */
+    EXPORT_API FrameResults* FaceEmotionResultsBinary(FrameInfo *frameInfo, bool getPreview, int width, int height, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        faceEmotionResults(*results, frameInfo, getPreview, width, height, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        return EndResults(deviceNum, results);
     }
 
 
@@ -26,12 +26,20 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/predefined/HeadPose.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
+#include "depthai-unity/predefined/SecondStage.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
 #include "nlohmann/json.hpp"
 
+// second stage input buffers per device
+static TensorPool tensorPool[DAI_MAX_DEVICES];
+// second stage replies per face of last detections, reported until new detections arrive
+static std::vector<std::shared_ptr<dai::NNData>> secondStageReplies[DAI_MAX_DEVICES];
+
 /**
 * Pipeline creation based on streams template
 *
@@ -65,6 +73,9 @@ dai::Pipeline createHeadPosePipeline(PipelineConfig *config)
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
 
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
+
     // neural network
     auto nn1 = pipeline.create<dai::node::NeuralNetwork>();
     nn1->setBlobPath(config->nnPath1);
@@ -154,8 +165,9 @@ dai::Pipeline createHeadPosePipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -170,6 +182,237 @@ dai::Pipeline createHeadPosePipeline(PipelineConfig *config)
     return pipeline;
 }
 
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void headPoseResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, int width, int height, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL) 
+    {
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
+
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
+    }
+
+    // preview image
+    cv::Mat frame;
+    std::shared_ptr<dai::ImgFrame> imgFrame;
+
+    // other images
+    cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
+
+    // latest frames from acquisition thread. isNew is false if frame was already processed
+    // worker held until results are written, frames can be views of its messages
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    bool previewNew = false;
+    AcquiredMessage* acquired;
+
+    // second stage is request/response, landm_out is not acquired
+    auto landm_in = GetInputQueue(deviceNum, "landm_in");
+    auto landm_out = GetOutputQueue(deviceNum, "landm_out");
+
+    // if preview image is requested. True in this case.
+    if (getPreview)
+    {
+        acquired = GetAcquired(acquisition, "preview", &previewNew);
+        if (acquired) frame = acquired->frame;
+    }
+
+    struct Detection {
+        unsigned int label;
+        float score;
+        float x_min;
+        float y_min;
+        float x_max;
+        float y_max;
+    };
+
+    vector<Detection> dets;
+
+    // face detections (latest, could be from previous results call). Second stage only runs on new ones
+    std::vector<float> detData;
+    bool detectionsNew = false;
+    acquired = GetAcquired(acquisition, "detections", &detectionsNew);
+    if (acquired) detData = acquired->get<dai::NNData>()->getFirstLayerFp16();
+    float maxScore = 0.0;
+    int maxPos = 0;
+
+    results.previewWidth = frame.cols;
+    results.previewHeight = frame.rows;
+
+    if(detData.size() > 0){
+        int i = 0;
+        while (detData[i*7] != -1.0f && i*7 < (int)detData.size()) {
+            
+            Detection d;
+            d.label = detData[i*7 + 1];
+            d.score = detData[i*7 + 2];
+            if (d.score >= faceScoreThreshold)
+            {
+                if (d.score > maxScore) 
+                {
+                    maxScore = d.score;
+                    maxPos = i;
+                }
+                d.x_min = detData[i*7 + 3];
+                d.y_min = detData[i*7 + 4];
+                d.x_max = detData[i*7 + 5];
+                d.y_max = detData[i*7 + 6];
+                dets.push_back(d);
+            }
+            i++;
+        }
+    }
+    // faces waiting for second stage
+    struct Face {
+        int x1, y1, x2, y2;
+        // index in results detections
+        int index;
+    };
+    std::vector<Face> faces;
+    std::vector<std::shared_ptr<dai::RawBuffer>> tensors;
+
+    int i = 0;
+    for(const auto& d : dets){
+        int x1 = d.x_min * frame.cols;
+        int y1 = d.y_min * frame.rows;
+        int x2 = d.x_max * frame.cols;
+        int y2 = d.y_max * frame.rows;
+        int mx = x1 + ((x2 - x1) / 2);
+        int my = y1 + ((y2 - y1) / 2);
+
+        // m_mx = mx;
+        // m_my = my;
+
+        if (faceScoreThreshold <= d.score)
+        {
+            if (x1 <= 0) x1 = 0;
+            if (y1 <= 0) y1 = 0;
+            if (x2 >= 300) x2 = 300;
+            if (y2 >= 300) y2 = 300;
+            cv::Rect faceRect = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)) & cv::Rect(0, 0, frame.cols, frame.rows);
+
+            // second stage input. Crops are taken before any drawing on preview
+            DetectionResult* face = NULL;
+            if (faceRect.width > 0 && faceRect.height > 0) face = AddDetection(results);
+            if (face != NULL)
+            {
+                face->label = d.label;
+                face->score = d.score;
+                face->xmin = d.x_min;
+                face->ymin = d.y_min;
+                face->xmax = d.x_max;
+                face->ymax = d.y_max;
+                face->xcenter = mx;
+                face->ycenter = my;
+                if (i == maxPos) results.best = results.numDetections - 1;
+
+                if (detectionsNew)
+                {
+                    auto tensor = tensorPool[deviceNum].acquire();
+                    toPlanarTensor(frame, faceRect, cv::Size(60,60), TensorType::U8, 0, tensor->data);
+                    tensors.push_back(tensor);
+                }
+                faces.push_back({x1, y1, x2, y2, results.numDetections - 1});
+            }
+        }
+        i++;
+    }
+
+    // ------------------------- SECOND STAGE - HEAD POSE
+    // all faces in flight at once, results correlated by sequence number. Calls in between reuse replies
+    if (detectionsNew) secondStageReplies[deviceNum] = RunSecondStage(landm_in, landm_out, tensors);
+    const std::vector<std::shared_ptr<dai::NNData>>& detfaces = secondStageReplies[deviceNum];
+
+    for (size_t k = 0; k < faces.size(); k++)
+    {
+        int x1 = faces[k].x1, y1 = faces[k].y1, x2 = faces[k].x2, y2 = faces[k].y2;
+        // faces can differ from replies if preview size changed since detections arrived
+        auto detface = k < detfaces.size() ? detfaces[k] : nullptr;
+
+        float yaw = 0.0f, pitch = 0.0f, roll = 0.0f;
+        HeadPoseResult& headPose = results.headPoses[faces[k].index];
+
+        std::vector<float> detfaceYData;
+        if (detface) detfaceYData = detface->getLayerFp16("angle_y_fc");
+        if (detfaceYData.size() > 0)
+        {
+            if(detfaceYData.size() > 0){
+                yaw = detfaceYData[0];
+            }
+            std::vector<float> detfacePData = detface->getLayerFp16("angle_p_fc");
+            if(detfacePData.size() > 0){
+                pitch = detfacePData[0];
+            }
+            std::vector<float> detfaceRData = detface->getLayerFp16("angle_r_fc");
+            if(detfaceRData.size() > 0){
+                roll = detfaceRData[0];
+            }
+
+            headPose.valid = 1;
+            headPose.yaw = yaw;
+            headPose.roll = roll;
+            headPose.pitch = pitch;
+            
+            roll = roll * 3.141596 / 180;
+            pitch = pitch * 3.141596 / 180;
+            yaw = -(yaw * 3.141596 / 180); 
+
+            if (drawBestFaceInPreview && previewNew)
+            {
+                int size = 50;
+                int origin0 = (x2 - x1)/2;
+                int origin1 = (y2 - y1)/2;
+                // X axis (red)
+                int rx1 = size * (cos(yaw) * cos(roll)) + origin0;
+                int ry1 = size * (cos(pitch) * sin(roll) + cos(roll) * sin(pitch) * sin(yaw)) + origin1;
+                cv::line(frame, cv::Point(origin0, origin1), cv::Point(rx1, ry1), cv::Scalar(0, 0, 255), 3);
+
+                // Y axis (green)
+                int rx2 = size * (-cos(yaw) * sin(roll)) + origin0;
+                int ry2 = size * (-cos(pitch) * cos(roll) - sin(pitch) * sin(yaw) * sin(roll)) + origin1;
+                cv::line(frame, cv::Point(origin0, origin1), cv::Point(rx2, ry2), cv::Scalar(0, 255, 0), 3);
+
+                // Z axis (blue)
+                int rx3 = size * (-sin(yaw)) + origin0;
+                int ry3 = size * (cos(yaw) * sin(pitch)) + origin1;
+                cv::line(frame, cv::Point(origin0, origin1), cv::Point(rx3,ry3), cv::Scalar(255, 0, 0), 2);
+            }
+        }
+
+        if (drawBestFaceInPreview && previewNew) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
+    }
+
+    if (getPreview && previewNew && frame.cols>0 && frame.rows>0) 
+    {
+        cv::Mat resizedMat(height, width, frame.type());
+        cv::resize(frame, resizedMat, resizedMat.size(), cv::INTER_CUBIC);
+
+        toARGB(frame,frameInfo->colorPreviewData);
+    }
+
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    // IMU
+    if (useIMU) GetIMU(deviceNum, results.imu);
+
+}
+
+
 extern "C"
 {
     /**
@@ -180,15 +423,18 @@ extern "C"
     */
     EXPORT_API bool InitHeadPose(PipelineConfig *config)
     {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
+
         dai::Pipeline pipeline = createHeadPosePipeline(config);
 
         // If deviceId is empty .. just pick first available device
-        bool res = false;
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);        
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
-        
-        return res;
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy,{"landm_out"});
+        return DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy,{"landm_out"});
     }
 
     /**
@@ -200,7 +446,8 @@ extern "C"
     * @param retrieveInformation True if system information is requested, False otherwise. Requires rate in pipeline creation.
     * @param useIMU True if IMU information is requested, False otherwise. Requires freq in pipeline creation.
     * @param deviceNum Device selection on unity dropdown
-    * @returns Json with results or information about device availability. 
+    * @returns Json with results or information about device availability. At most DAI_MAX_DETECTIONS faces,
+    * "dropped_detections" counts faces over the cap when there are more
     */    
 
     /**
@@ -209,254 +456,60 @@ extern "C"
 
     EXPORT_API const char* HeadPoseResults(FrameInfo *frameInfo, bool getPreview, int width, int height, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
     {
-        using namespace std;
-        using namespace std::chrono;
-
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL) 
-        {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
-        }
-
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
-        {
-            // preview image
-            cv::Mat frame;
-            std::shared_ptr<dai::ImgFrame> imgFrame;
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        headPoseResults(*results, frameInfo, getPreview, width, height, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
 
-            // other images
-            cv::Mat depthFrame, depthFrameOrig, dispFrameOrig, dispFrame, monoRFrameOrig, monoRFrame, monoLFrameOrig, monoLFrame;
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
 
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
+        json.key("best");
+        if (results->best >= 0) WriteDetection(json, results->detections[results->best]);
+        else json.null();
 
-            // if preview image is requested. True in this case.
-            if (getPreview) preview = device->getOutputQueue("preview",1,false);
-            
-            // face emotion results
-            auto detections = device->getOutputQueue("detections",1,false);
-            
-            auto landm_in = device->getInputQueue("landm_in");
-            auto landm_out = device->getOutputQueue("landm_out");
+        json.key("faces").beginArray();
+        for (int i = 0; i < results->numDetections; i++) WriteDetection(json, results->detections[i]);
+        json.endArray();
+        if (results->droppedDetections > 0) json.field("dropped_detections", results->droppedDetections);
 
-            // if depth images are requested. All images.
-            //if (useDepth) depthQueue = device->getOutputQueue("depth", 1, false);
-            
-            if (getPreview)
-            {
-                auto imgFrames = preview->tryGetAll<dai::ImgFrame>();
-                auto countd = imgFrames.size();
-                if (countd > 0) {
-                    auto imgFrame = imgFrames[countd-1];
-                    if(imgFrame){
-                        frame = toMat(imgFrame->getData(), imgFrame->getWidth(), imgFrame->getHeight(), 3, 1);
-                    }
-                }
-            }
-        
-            struct Detection {
-                unsigned int label;
-                float score;
-                float x_min;
-                float y_min;
-                float x_max;
-                float y_max;
-            };
-
-            vector<Detection> dets;
-
-            auto det = detections->get<dai::NNData>();
-            std::vector<float> detData = det->getFirstLayerFp16();
-            float maxScore = 0.0;
-            int maxPos = 0;
-
-            nlohmann::json facesArr = {};
-            nlohmann::json bestFace = {};
-            nlohmann::json headPoseArr = {};
-            nlohmann::json headPoseJson = {};
-
-            vector<std::shared_ptr<dai::ImgFrame>> imgDepthFrames;
-            std::shared_ptr<dai::ImgFrame> imgDepthFrame;
-            
-            if(detData.size() > 0){
-                int i = 0;
-                while (detData[i*7] != -1.0f && i*7 < (int)detData.size()) {
-                    
-                    Detection d;
-                    d.label = detData[i*7 + 1];
-                    d.score = detData[i*7 + 2];
-                    if (d.score >= faceScoreThreshold)
-                    {
-                        if (d.score > maxScore) 
-                        {
-                            maxScore = d.score;
-                            maxPos = i;
-                        }
-                        d.x_min = detData[i*7 + 3];
-                        d.y_min = detData[i*7 + 4];
-                        d.x_max = detData[i*7 + 5];
-                        d.y_max = detData[i*7 + 6];
-                        dets.push_back(d);
-                    }
-                    i++;
-                }
-            }
-            int i = 0;
-            cv::Mat faceFrame;
-            for(const auto& d : dets){
-                int x1 = d.x_min * frame.cols;
-                int y1 = d.y_min * frame.rows;
-                int x2 = d.x_max * frame.cols;
-                int y2 = d.y_max * frame.rows;
-                int mx = x1 + ((x2 - x1) / 2);
-                int my = y1 + ((y2 - y1) / 2);
-
-                // m_mx = mx;
-                // m_my = my;
-
-                if (faceScoreThreshold <= d.score)
-                {
-                    if (i==maxPos)
-                    {
-                        bestFace["label"] = d.label;
-                        bestFace["score"] = d.score;
-                        bestFace["xmin"] = d.x_min;
-                        bestFace["ymin"] = d.y_min;
-                        bestFace["xmax"] = d.x_max;
-                        bestFace["ymax"] = d.y_max;
-                        bestFace["xcenter"] = mx;
-                        bestFace["ycenter"] = my;
-                    }
-
-                    nlohmann::json face;
-
-                    face["label"] = d.label;
-                    face["score"] = d.score;
-                    face["xmin"] = d.x_min;
-                    face["ymin"] = d.y_min;
-                    face["xmax"] = d.x_max;
-                    face["ymax"] = d.y_max;
-                    face["xcenter"] = mx;
-                    face["ycenter"] = my;
-
-                    if (x1 > 0 && y1 > 0 && x2 < 300 && y2 < 300)
-                        faceFrame = frame(cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)));
-                    else  
-                    {
-                        if (x1 <= 0) x1 = 0;
-                        if (y1 <= 0) y1 = 0;
-                        if (x2 >= 300) x2 = 300;
-                        if (y2 >= 300) y2 = 300;
-                        faceFrame = frame(cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)));
-                    }
-
-                    // ------------------------- SECOND STAGE - HEAD POSE
-
-                    dai::NNData data_in;
-
-                    auto tensor = std::make_shared<dai::RawBuffer>();
-                    if (faceFrame.cols > 0 && faceFrame.rows > 0)
-                    {
-                        float yaw, pitch, roll;
-                        cv::Mat frame2 = resizeKeepAspectRatio(faceFrame, cv::Size(60,60), cv::Scalar(0));
-
-                        toPlanar(frame2, tensor->data);
-
-                        landm_in->send(tensor);
-
-                        auto detface = landm_out->get<dai::NNData>();
-                        
-                        nlohmann::json headPose;
-
-                        std::vector<float> detfaceYData = detface->getLayerFp16("angle_y_fc");
-                        if (detfaceYData.size() > 0)
-                        {
-                            if(detfaceYData.size() > 0){
-                                yaw = detfaceYData[0];
-                            }
-                            std::vector<float> detfacePData = detface->getLayerFp16("angle_p_fc");
-                            if(detfacePData.size() > 0){
-                                pitch = detfacePData[0];
-                            }
-                            std::vector<float> detfaceRData = detface->getLayerFp16("angle_r_fc");
-                            if(detfaceRData.size() > 0){
-                                roll = detfaceRData[0];
-                            }
-
-                            headPose["yaw"] = yaw;
-                            headPose["roll"] = roll;
-                            headPose["pitch"] = pitch;
-                            
-                            roll = roll * 3.141596 / 180;
-                            pitch = pitch * 3.141596 / 180;
-                            yaw = -(yaw * 3.141596 / 180); 
-
-                            if (drawBestFaceInPreview)
-                            {
-                                int size = 50;
-                                int origin0 = (x2 - x1)/2;
-                                int origin1 = (y2 - y1)/2;
-                                // X axis (red)
-                                int rx1 = size * (cos(yaw) * cos(roll)) + origin0;
-                                int ry1 = size * (cos(pitch) * sin(roll) + cos(roll) * sin(pitch) * sin(yaw)) + origin1;
-                                cv::line(frame, cv::Point(origin0, origin1), cv::Point(rx1, ry1), cv::Scalar(0, 0, 255), 3);
-
-                                // Y axis (green)
-                                int rx2 = size * (-cos(yaw) * sin(roll)) + origin0;
-                                int ry2 = size * (-cos(pitch) * cos(roll) - sin(pitch) * sin(yaw) * sin(roll)) + origin1;
-                                cv::line(frame, cv::Point(origin0, origin1), cv::Point(rx2, ry2), cv::Scalar(0, 255, 0), 3);
-
-                                // Z axis (blue)
-                                int rx3 = size * (-sin(yaw)) + origin0;
-                                int ry3 = size * (cos(yaw) * sin(pitch)) + origin1;
-                                cv::line(frame, cv::Point(origin0, origin1), cv::Point(rx3,ry3), cv::Scalar(255, 0, 0), 2);
-                            }
-                        }
-
-                        facesArr.push_back(face);
-                        headPoseArr.push_back(headPose);
-
-                        if (drawBestFaceInPreview) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), cv::Scalar(255,255,255));
-                    }
-                }
-                i++;
-            }
-
-            if (getPreview && frame.cols>0 && frame.rows>0) 
+        json.key("headPoses").beginArray();
+        for (int i = 0; i < results->numDetections; i++)
+        {
+            // null if second stage didn't reply
+            const HeadPoseResult& pose = results->headPoses[i];
+            if (!pose.valid)
             {
-                cv::Mat resizedMat(height, width, frame.type());
-                cv::resize(frame, resizedMat, resizedMat.size(), cv::INTER_CUBIC);
-
-                toARGB(frame,frameInfo->colorPreviewData);
+                json.null();
+                continue;
             }
+            json.beginObject();
+            json.field("yaw", pose.yaw);
+            json.field("roll", pose.roll);
+            json.field("pitch", pose.pitch);
+            json.endObject();
+        }
+        json.endArray();
 
-            // SYSTEM INFORMATION
-            if (retrieveInformation) headPoseJson["sysinfo"] = GetDeviceInfo(device);        
-            // IMU
-            if (useIMU) headPoseJson["imu"] = GetIMU(device);
-
-            // RETURN JSON
-            headPoseJson["best"] = bestFace;
-            headPoseJson["faces"] = facesArr;
-            headPoseJson["headPoses"] = headPoseArr;
-
-            char* ret = (char*)::malloc(strlen(headPoseJson.dump().c_str())+1);
-            ::memcpy(ret, headPoseJson.dump().c_str(),strlen(headPoseJson.dump().c_str()));
-            ret[strlen(headPoseJson.dump().c_str())] = 0;
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        // IMU
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
 
-            return ret;
-        }
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+    /**
+    * Pipeline results, binary interface. Same parameters as HeadPoseResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (faces, head pose of each face, best face, sysinfo, imu)
+    */
+    EXPORT_API FrameResults* HeadPoseResultsBinary(FrameInfo *frameInfo, bool getPreview, int width, int height, bool drawBestFaceInPreview, bool drawAllFacesInPreview, float faceScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        headPoseResults(*results, frameInfo, getPreview, width, height, drawBestFaceInPreview, drawAllFacesInPreview, faceScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        return EndResults(deviceNum, results);
     }
 
 
@@ -26,6 +26,8 @@
 #include "depthai/device/Device.hpp"
 
 #include "depthai-unity/predefined/ObjectDetector.hpp"
+#include "depthai-unity/device/Acquisition.hpp"
+#include "depthai-unity/device/Control.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
@@ -77,6 +79,9 @@ dai::Pipeline createObjectDetectorPipeline(PipelineConfig *config)
     if (config->colorCameraColorOrder == 1) colorCam->setColorOrder(dai::ColorCameraProperties::ColorOrder::RGB);
     colorCam->setFps(config->colorCameraFPS);
 
+    // focus and exposure can be changed while running (DAISetCameraFocus, DAISetCameraExposure)
+    AddCameraControl(pipeline, config->deviceNum, colorCam);
+
     // NN
     spatialDetectionNetwork->setBlobPath(config->nnPath1);
     spatialDetectionNetwork->setConfidenceThreshold(0.5f);
@@ -134,6 +139,9 @@ dai::Pipeline createObjectDetectorPipeline(PipelineConfig *config)
         if (config->medianFilter == 2) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_5x5);
         if (config->medianFilter == 3) stereo->initialConfig.setMedianFilter(dai::MedianFilter::KERNEL_7x7);
 
+        // confidence, median and LR-check can be changed while running (DAISetStereoConfig)
+        AddStereoControl(pipeline, config->deviceNum, stereo);
+
         // Linking
         left->out.link(stereo->left);
         right->out.link(stereo->right);
@@ -177,8 +185,9 @@ dai::Pipeline createObjectDetectorPipeline(PipelineConfig *config)
 
         xlinkOutImu->setStreamName("imu");
 
-        // enable ROTATION_VECTOR at 400 hz rate
+        // enable ROTATION_VECTOR, raw accelerometer and gyroscope at freq rate (every report is kept by IMU collector)
         imu->enableIMUSensor(dai::IMUSensor::ROTATION_VECTOR, config->freq);
+        imu->enableIMUSensor({dai::IMUSensor::ACCELEROMETER_RAW, dai::IMUSensor::GYROSCOPE_RAW}, config->freq);
         // above this threshold packets will be sent in batch of X, if the host is not blocked and USB bandwidth is available
         imu->setBatchReportThreshold(config->batchReportThreshold);
         // maximum number of IMU packets in a batch, if it's reached device will block sending until host can receive it
@@ -193,6 +202,128 @@ dai::Pipeline createObjectDetectorPipeline(PipelineConfig *config)
     return pipeline;
 }
 
+/**
+* Pipeline results shared by json and binary interfaces
+*
+* @param results results to fill
+*/
+static void objectDetectorResults(FrameResults& results, FrameInfo *frameInfo, bool getPreview, float objectScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
+{
+    using namespace std;
+    using namespace std::chrono;
+
+    // Get device deviceNum
+    std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
+    // Device no available
+    if (device == NULL) 
+    {
+        results.error = RESULTS_NO_DEVICE;
+        return;
+    }
+
+    // Device not running pipeline
+    if (!IsDeviceRunning(deviceNum))
+    {
+        results.error = RESULTS_DEVICE_NOT_RUNNING;
+        return;
+    }
+
+    // preview, detections and depth of same capture from acquisition thread. isNew is false if bundle was already processed
+    // worker held until results are written, frames can be views of its messages
+    bool isNew = false;
+    std::shared_ptr<DeviceAcquisition> acquisition = GetAcquisition(deviceNum);
+    AcquiredBundle* bundle = GetBundle(acquisition, &isNew);
+    AcquiredMessage* acquired;
+
+    int countd = 0;
+    auto color = cv::Scalar(255, 255, 255);
+
+    // if preview image is requested. True in this case.
+    cv::Mat frame;
+    if (getPreview && bundle)
+    {
+        acquired = bundle->get("preview");
+        if (acquired)
+        {
+            frame = acquired->frame;
+            // only draw and upload new frames
+            if (isNew) countd = 1;
+        }
+    }
+
+    // object detector results of preview frame
+    std::vector<dai::SpatialImgDetection> detections;
+    acquired = bundle ? bundle->get("detections") : NULL;
+    if (acquired) detections = acquired->get<dai::SpatialImgDetections>()->detections;
+
+    // if depth images are requested. All images.
+    cv::Mat depthFrame;
+    acquired = bundle ? bundle->get("depth") : NULL;
+    if (acquired) depthFrame = acquired->frame;
+
+    int count;
+    // In this case we allocate before Texture2D (ARGB32) and memcpy pointer data 
+    
+    acquired = GetAcquired(acquisition, "boundingBoxDepthMapping", &isNew);
+    if(!detections.empty() && !depthFrame.empty() && acquired && isNew) {
+        
+        auto roiDatas = acquired->get<dai::SpatialLocationCalculatorConfig>()->getConfigData();
+
+        for(auto roiData : roiDatas) {
+            auto roi = roiData.roi;
+            roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
+            auto topLeft = roi.topLeft();
+            auto bottomRight = roi.bottomRight();
+            auto xmin = (int)topLeft.x;
+            auto ymin = (int)topLeft.y;
+            auto xmax = (int)bottomRight.x;
+            auto ymax = (int)bottomRight.y;
+
+            cv::rectangle(depthFrame, cv::Rect(cv::Point(xmin, ymin), cv::Point(xmax, ymax)), color, cv::FONT_HERSHEY_SIMPLEX);
+        }
+    }
+
+    results.previewWidth = frame.cols;
+    results.previewHeight = frame.rows;
+
+    for(const auto& detection : detections) {
+
+        int x1 = detection.xmin * frame.cols;
+        int y1 = detection.ymin * frame.rows;
+        int x2 = detection.xmax * frame.cols;
+        int y2 = detection.ymax * frame.rows;
+
+        if (detection.confidence>=objectScoreThreshold) 
+        {
+            if (countd > 0) cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), color, cv::FONT_HERSHEY_SIMPLEX);
+        
+            DetectionResult* object = AddDetection(results);
+            if (object == NULL) continue;
+            object->label = detection.label;
+            object->score = detection.confidence;
+            object->xmin = detection.xmin;
+            object->ymin = detection.ymin;
+            object->xmax = detection.xmax;
+            object->ymax = detection.ymax;
+            object->xcenter = (x1 + x2) / 2;
+            object->ycenter = (y1 + y2) / 2;
+            object->hasSpatial = 1;
+            object->X = (int)detection.spatialCoordinates.x;
+            object->Y = (int)detection.spatialCoordinates.y;
+            object->Z = (int)detection.spatialCoordinates.z;
+        }
+    }
+
+    if (countd > 0) toARGB(frame,frameInfo->colorPreviewData);
+
+    // SYSTEM INFORMATION
+    if (retrieveInformation) GetDeviceInfo(deviceNum, results.sysinfo);
+    // IMU
+    if (useIMU) GetIMU(deviceNum, results.imu, bundle ? bundle->timestamp : 0);
+
+}
+
+
 extern "C"
 {
    /**
@@ -203,15 +334,22 @@ extern "C"
     */
     EXPORT_API bool InitObjectDetector(PipelineConfig *config)
     {
+        // per device tables are indexed by deviceNum while building pipeline
+        if (!ValidDeviceNum(config->deviceNum)) return false;
+
         dai::Pipeline pipeline = createObjectDetectorPipeline(config);
 
+        // preview (NN passthrough), detections and depth (NN passthrough) matched by capture, within half frame period
+        float fps = config->colorCameraFPS > 0.0f ? config->colorCameraFPS : 30.0f;
+        BundlePolicy bundle({"preview", "detections", "depth"}, 500.0f / fps);
+
         // If deviceId is empty .. just pick first available device
-        bool res = false;
+        const char* deviceId = (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) ? NULL : config->deviceId;
+        StreamPolicy policy(config->queueMaxSize,config->queueBlocking);
 
-        if (strcmp(config->deviceId,"NONE")==0 || strcmp(config->deviceId,"")==0) res = DAIStartPipeline(pipeline,config->deviceNum,NULL);        
-        else res = DAIStartPipeline(pipeline,config->deviceNum,config->deviceId);
-        
-        return res;
+        // device boots on background thread, Init returns once device is claimed
+        if (config->asyncBoot) return DAIStartPipelineAsync(pipeline,config->deviceNum,deviceId,policy,{},bundle);
+        return DAIStartPipeline(pipeline,config->deviceNum,deviceId,policy,{},bundle);
     }
 
     /**
@@ -223,7 +361,8 @@ extern "C"
     * @param retrieveInformation True if system information is requested, False otherwise. Requires rate in pipeline creation.
     * @param useIMU True if IMU information is requested, False otherwise. Requires freq in pipeline creation.
     * @param deviceNum Device selection on unity dropdown
-    * @returns Json with results or information about device availability. 
+    * @returns Json with results or information about device availability. At most DAI_MAX_DETECTIONS objects,
+    * "dropped_detections" counts objects over the cap when there are more
     */    
 
     /**
@@ -233,127 +372,55 @@ extern "C"
 
     EXPORT_API const char* ObjectDetectorResults(FrameInfo *frameInfo, bool getPreview, float objectScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum)
     {
-        using namespace std;
-        using namespace std::chrono;
+        FrameResults* results = BeginResults(deviceNum, NULL);
+        objectDetectorResults(*results, frameInfo, getPreview, objectScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        if (results->error != RESULTS_OK) return ResultsErrorString(deviceNum, *results);
 
-        // Get device deviceNum
-        std::shared_ptr<dai::Device> device = GetDevice(deviceNum);
-        // Device no available
-        if (device == NULL) 
-        {
-            char* ret = (char*)::malloc(strlen("{\"error\":\"NO_DEVICE\"}"));
-            ::memcpy(ret, "{\"error\":\"NO_DEVICE\"}",strlen("{\"error\":\"NO_DEVICE\"}"));
-            ret[strlen("{\"error\":\"NO_DEVICE\"}")] = 0;
-            return ret;
-        }
+        // object info
+        JsonWriter& json = BeginJsonResults(deviceNum);
+        json.beginObject();
 
-        // If device deviceNum is running pipeline
-        if (IsDeviceRunning(deviceNum))
+        json.key("objects").beginArray();
+        for (int i = 0; i < results->numDetections; i++)
         {
-            // object info
-            nlohmann::json objectDetectorJson = {};
-
-            std::shared_ptr<dai::DataOutputQueue> preview;
-            std::shared_ptr<dai::DataOutputQueue> depthQueue;
-            
-            // object detector results
-            auto detectionNNQueue = device->getOutputQueue("detections",4,false);
-            
-            // if preview image is requested. True in this case.
-            if (getPreview) preview = device->getOutputQueue("preview",4,false);
-            
-            // if depth images are requested. All images.
-            depthQueue = device->getOutputQueue("depth", 4, false);
-            
-            auto xoutBoundingBoxDepthMappingQueue = device->getOutputQueue("boundingBoxDepthMapping", 4, false);
-
-            int countd;
-            auto color = cv::Scalar(255, 255, 255);
-
-            auto imgFrame = preview->get<dai::ImgFrame>();
-            auto inDet = detectionNNQueue->get<dai::SpatialImgDetections>();
-            auto depth = depthQueue->get<dai::ImgFrame>();
-
-            cv::Mat frame = imgFrame->getCvFrame();
-            cv::Mat depthFrame = depth->getFrame();
-
-            int count;
-            // In this case we allocate before Texture2D (ARGB32) and memcpy pointer data 
-            
-            auto detections = inDet->detections;
-            if(!detections.empty()) {
-                
-                auto boundingBoxMapping = xoutBoundingBoxDepthMappingQueue->get<dai::SpatialLocationCalculatorConfig>();
-                auto roiDatas = boundingBoxMapping->getConfigData();
-
-                for(auto roiData : roiDatas) {
-                    auto roi = roiData.roi;
-                    roi = roi.denormalize(depthFrame.cols, depthFrame.rows);
-                    auto topLeft = roi.topLeft();
-                    auto bottomRight = roi.bottomRight();
-                    auto xmin = (int)topLeft.x;
-                    auto ymin = (int)topLeft.y;
-                    auto xmax = (int)bottomRight.x;
-                    auto ymax = (int)bottomRight.y;
-
-                    cv::rectangle(depthFrame, cv::Rect(cv::Point(xmin, ymin), cv::Point(xmax, ymax)), color, cv::FONT_HERSHEY_SIMPLEX);
-                }
-            }
-
-            nlohmann::json objectsArr = {};
-
-            for(const auto& detection : detections) {
-
-                int x1 = detection.xmin * frame.cols;
-                int y1 = detection.ymin * frame.rows;
-                int x2 = detection.xmax * frame.cols;
-                int y2 = detection.ymax * frame.rows;
-
-                int labelIndex = detection.label;
-                std::string labelStr = to_string(labelIndex);
-                if(labelIndex < labelMap.size()) {
-                    labelStr = labelMap[labelIndex];
-                }
-
-                if (detection.confidence>=objectScoreThreshold) 
-                {
-                    cv::rectangle(frame, cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)), color, cv::FONT_HERSHEY_SIMPLEX);
-                
-                    nlohmann::json object;
-                    object["label"] = labelStr;
-                    object["score"] = detection.confidence * 100;
-                    object["xmin"] = x1; 
-                    object["xmax"] = x2; 
-                    object["ymin"] = y1; 
-                    object["ymax"] = y2; 
-                    object["X"] = (int)detection.spatialCoordinates.x;
-                    object["Y"] = (int)detection.spatialCoordinates.y;
-                    object["Z"] = (int)detection.spatialCoordinates.z;
-
-                    objectsArr.push_back(object);
-                }
-            }
-
-            toARGB(frame,frameInfo->colorPreviewData);
-
-            objectDetectorJson["objects"] = objectsArr;
-
-            // SYSTEM INFORMATION
-            if (retrieveInformation) objectDetectorJson["sysinfo"] = GetDeviceInfo(device);        
-            // IMU
-            if (useIMU) objectDetectorJson["imu"] = GetIMU(device);
-
-            char* ret = (char*)::malloc(strlen(objectDetectorJson.dump().c_str())+1);
-            ::memcpy(ret, objectDetectorJson.dump().c_str(),strlen(objectDetectorJson.dump().c_str()));
-            ret[strlen(objectDetectorJson.dump().c_str())] = 0;
-
-            return ret;
+            const DetectionResult& detection = results->detections[i];
+
+            json.beginObject();
+            if (detection.label >= 0 && detection.label < (int)labelMap.size()) json.field("label", labelMap[detection.label]);
+            else json.field("label", std::to_string(detection.label));
+            json.field("score", detection.score * 100);
+            json.field("xmin", (int)(detection.xmin * results->previewWidth));
+            json.field("xmax", (int)(detection.xmax * results->previewWidth));
+            json.field("ymin", (int)(detection.ymin * results->previewHeight));
+            json.field("ymax", (int)(detection.ymax * results->previewHeight));
+            json.field("X", detection.X);
+            json.field("Y", detection.Y);
+            json.field("Z", detection.Z);
+            json.endObject();
         }
+        json.endArray();
+        if (results->droppedDetections > 0) json.field("dropped_detections", results->droppedDetections);
+
+        // SYSTEM INFORMATION
+        if (retrieveInformation) WriteSysInfo(json.key("sysinfo"), results->sysinfo);
+        // IMU
+        if (useIMU) WriteIMU(json.key("imu"), results->imu);
 
-        char* ret = (char*)::malloc(strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ::memcpy(ret, "{\"error\":\"DEVICE_NOT_RUNNING\"}",strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}"));
-        ret[strlen("{\"error\":\"DEVICE_NOT_RUNNING\"}")] = 0;
-        return ret;
+        json.endObject();
+        return EndJsonResults(deviceNum);
+    }
+
+    /**
+    * Pipeline results, binary interface. Same parameters as ObjectDetectorResults
+    *
+    * @param results caller results or NULL to use plugin owned results
+    * @returns results (detections with label index and score [0,1], sysinfo, imu)
+    */
+    EXPORT_API FrameResults* ObjectDetectorResultsBinary(FrameInfo *frameInfo, bool getPreview, float objectScoreThreshold, bool useDepth, bool retrieveInformation, bool useIMU, int deviceNum, FrameResults* results)
+    {
+        results = BeginResults(deviceNum, results);
+        objectDetectorResults(*results, frameInfo, getPreview, objectScoreThreshold, useDepth, retrieveInformation, useIMU, deviceNum);
+        return EndResults(deviceNum, results);
     }
 
 
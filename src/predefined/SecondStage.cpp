@@ -0,0 +1,58 @@
+#pragma GCC diagnostic ignored "-Wdouble-promotion"
+
+// ------------------------------------------------------------------------
+// Plugin itself
+
+#include <atomic>
+
+// Inludes common necessary includes for development using depthai library
+#include "depthai/depthai.hpp"
+
+#include "depthai-unity/predefined/SecondStage.hpp"
+
+// sequence numbers of second stage requests. Unique across calls, so late replies of previous frames are discarded
+static std::atomic<int64_t> nextSequenceNum{0};
+
+std::shared_ptr<dai::RawBuffer> TensorPool::acquire()
+{
+    for (const auto& buffer : buffers)
+    {
+        if (buffer.use_count() == 1) return buffer;
+    }
+
+    buffers.push_back(std::make_shared<dai::RawBuffer>());
+    return buffers.back();
+}
+
+std::vector<std::shared_ptr<dai::NNData>> RunSecondStage(std::shared_ptr<dai::DataInputQueue> in, std::shared_ptr<dai::DataOutputQueue> out,
+                                                         const std::vector<std::shared_ptr<dai::RawBuffer>>& tensors,
+                                                         std::chrono::milliseconds timeout)
+{
+    std::vector<std::shared_ptr<dai::NNData>> results(tensors.size());
+    if (!in || !out || tensors.empty()) return results;
+
+    int64_t base = nextSequenceNum.fetch_add((int64_t)tensors.size());
+
+    // all requests back-to-back, NN node keeps sequence number of its input
+    for (size_t k = 0; k < tensors.size(); k++)
+    {
+        tensors[k]->sequenceNum = base + (int64_t)k;
+        in->send(tensors[k]);
+    }
+
+    size_t received = 0;
+    while (received < tensors.size())
+    {
+        bool timedOut = false;
+        auto reply = out->get<dai::NNData>(timeout, timedOut);
+        if (timedOut || !reply) break;
+
+        int64_t k = reply->getSequenceNum() - base;
+        if (k < 0 || k >= (int64_t)tensors.size() || results[k]) continue;
+
+        results[k] = reply;
+        received++;
+    }
+
+    return results;
+}
@@ -1,7 +1,12 @@
 #include "utility.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 // libraries
 #include "fp16/fp16.h"
+#include "opencv2/core/hal/intrin.hpp"
 
 #include "errno.h"
 
@@ -25,57 +30,184 @@ int createDirectory(std::string directory)
 }
 
 
-cv::Mat toMat(const std::vector<uint8_t>& data, int w, int h , int numPlanes, int bpp){
-    
-    cv::Mat frame;
+// fp16 -> u8 lookup table. 64K entries covering every half float bit pattern, saturated to [0,255]
+static const std::uint8_t* fp16ToU8Table()
+{
+    static std::vector<std::uint8_t> table = []() {
+        std::vector<std::uint8_t> t(65536);
+        for (int i = 0; i < 65536; i++)
+        {
+            float v = fp16_ieee_to_fp32_value((uint16_t)i) * 255.0f;
+            t[i] = (v > 0.0f) ? cv::saturate_cast<uint8_t>(v) : 0;
+        }
+        return t;
+    }();
+    return table.data();
+}
 
-    if(numPlanes == 3){
-        frame = cv::Mat(h, w, CV_8UC3);
+// 3 planes (c0,c1,c2) -> interleaved (c0,c1,c2)
+static void planarU8ToInterleaved(const std::uint8_t* data, int total, std::uint8_t* dst)
+{
+    const std::uint8_t* p0 = data;
+    const std::uint8_t* p1 = data + total;
+    const std::uint8_t* p2 = data + total * 2;
+    int i = 0;
 
-        // optimization (cache)
-        for(int i = 0; i < w*h; i++) {
-            uint8_t b = data.data()[i + w*h * 0];
-            frame.data[i*3+0] = b;
-        }
-        for(int i = 0; i < w*h; i++) {                
-            uint8_t g = data.data()[i + w*h * 1];    
-            frame.data[i*3+1] = g;
+#if CV_SIMD128
+    if (cv::useOptimized())
+    {
+        for (; i <= total - 16; i += 16)
+        {
+            cv::v_uint8x16 c0 = cv::v_load(p0 + i);
+            cv::v_uint8x16 c1 = cv::v_load(p1 + i);
+            cv::v_uint8x16 c2 = cv::v_load(p2 + i);
+            cv::v_store_interleave(dst + i*3, c0, c1, c2);
         }
-        for(int i = 0; i < w*h; i++) {
-            uint8_t r = data.data()[i + w*h * 2];
-            frame.data[i*3+2] = r;
+    }
+#endif
+
+    for (; i < total; i++)
+    {
+        dst[i*3+0] = p0[i];
+        dst[i*3+1] = p1[i];
+        dst[i*3+2] = p2[i];
+    }
+}
+
+// interleaved (c0,c1,c2) -> interleaved (c2,c1,c0)
+static void interleavedU8SwapRB(const std::uint8_t* data, int total, std::uint8_t* dst)
+{
+    int i = 0;
+
+#if CV_SIMD128
+    if (cv::useOptimized())
+    {
+        for (; i <= total - 16; i += 16)
+        {
+            cv::v_uint8x16 c0, c1, c2;
+            cv::v_load_deinterleave(data + i*3, c0, c1, c2);
+            cv::v_store_interleave(dst + i*3, c2, c1, c0);
         }
-                    
-    } else {
-        if(bpp == 3){
-            frame = cv::Mat(h, w, CV_8UC3);
-            for(int i = 0; i < w*h*bpp; i+=3) {
-                uint8_t b,g,r;
-                b = data.data()[i + 2];
-                g = data.data()[i + 1];
-                r = data.data()[i + 0];    
-                frame.at<cv::Vec3b>( (i/bpp) / w, (i/bpp) % w) = cv::Vec3b(b,g,r);
-            }
+    }
+#endif
 
-        } else if(bpp == 6) {
-            //first denormalize
-            //dump
-            
-            frame = cv::Mat(h, w, CV_8UC3);
-            for(int y = 0; y < h; y++){
-                for(int x = 0; x < w; x++){
-
-                    const uint16_t* fp16 = (const uint16_t*) (data.data() + (y*w+x)*bpp);                        
-                    uint8_t r = (uint8_t) (fp16_ieee_to_fp32_value(fp16[0]) * 255.0f);
-                    uint8_t g = (uint8_t) (fp16_ieee_to_fp32_value(fp16[1]) * 255.0f);
-                    uint8_t b = (uint8_t) (fp16_ieee_to_fp32_value(fp16[2]) * 255.0f);
-                    frame.at<cv::Vec3b>(y, x) = cv::Vec3b(b,g,r);
-                }
-            }
-            
+    for (; i < total; i++)
+    {
+        std::uint8_t c0 = data[i*3+0];
+        dst[i*3+0] = data[i*3+2];
+        dst[i*3+1] = data[i*3+1];
+        dst[i*3+2] = c0;
+    }
+}
+
+#if CV_SIMD128 && CV_VERSION_MAJOR >= 4
+// 16 fp16 values -> u8, same result as fp16ToU8Table (x255, clamped to [0,255] before rounding so NaN/inf match the table)
+static inline cv::v_uint8x16 fp16ToU8x16(const uint16_t* src)
+{
+    const cv::float16_t* p = (const cv::float16_t*) src;
+    cv::v_float32x4 scale = cv::v_setall_f32(255.0f), zero = cv::v_setzero_f32();
+    cv::v_int32x4 q[4];
+    for (int k = 0; k < 4; k++) q[k] = cv::v_round(cv::v_min(cv::v_max(cv::v_load_expand(p + k*4) * scale, zero), scale));
+    return cv::v_pack_u(cv::v_pack(q[0], q[1]), cv::v_pack(q[2], q[3]));
+}
+#endif
+
+// 3 fp16 planes (c0,c1,c2) -> interleaved u8 (c0,c1,c2)
+static void planarFP16ToInterleaved(const std::uint8_t* data, int total, std::uint8_t* dst)
+{
+    const std::uint8_t* lut = fp16ToU8Table();
+    const uint16_t* p0 = (const uint16_t*) data;
+    const uint16_t* p1 = p0 + total;
+    const uint16_t* p2 = p0 + total * 2;
+    int i = 0;
+
+#if CV_SIMD128 && CV_VERSION_MAJOR >= 4
+    // half -> float conversion (F16C/NEON when enabled in OpenCV baseline) instead of 3 table lookups per pixel
+    if (cv::useOptimized())
+    {
+        for (; i <= total - 16; i += 16)
+        {
+            cv::v_store_interleave(dst + i*3, fp16ToU8x16(p0 + i), fp16ToU8x16(p1 + i), fp16ToU8x16(p2 + i));
         }
     }
+#endif
 
+    for (; i < total; i++)
+    {
+        dst[i*3+0] = lut[p0[i]];
+        dst[i*3+1] = lut[p1[i]];
+        dst[i*3+2] = lut[p2[i]];
+    }
+}
+
+// interleaved fp16 (c0,c1,c2) -> interleaved u8 (c2,c1,c0)
+static void interleavedFP16SwapRB(const std::uint8_t* data, int total, std::uint8_t* dst)
+{
+    const std::uint8_t* lut = fp16ToU8Table();
+    const uint16_t* src = (const uint16_t*) data;
+
+    for (int i = 0; i < total; i++)
+    {
+        dst[i*3+0] = lut[src[i*3+2]];
+        dst[i*3+1] = lut[src[i*3+1]];
+        dst[i*3+2] = lut[src[i*3+0]];
+    }
+}
+
+void toBGR(const std::uint8_t* data, int w, int h, PreviewLayout layout, std::uint8_t* dst)
+{
+    int total = w * h;
+
+    switch (layout)
+    {
+        case PreviewLayout::PLANAR_U8:
+            planarU8ToInterleaved(data, total, dst);
+            break;
+        case PreviewLayout::PLANAR_FP16:
+            planarFP16ToInterleaved(data, total, dst);
+            break;
+        case PreviewLayout::INTERLEAVED_RGB_U8:
+            interleavedU8SwapRB(data, total, dst);
+            break;
+        case PreviewLayout::INTERLEAVED_BGR_U8:
+            if (dst != data) std::memcpy(dst, data, (size_t)total * 3);
+            break;
+        case PreviewLayout::INTERLEAVED_RGB_FP16:
+            interleavedFP16SwapRB(data, total, dst);
+            break;
+    }
+}
+
+// numPlanes/bpp pair used by callers -> layout. False for unknown layouts
+static bool previewLayout(int numPlanes, int bpp, PreviewLayout& layout)
+{
+    if (numPlanes == 3 && bpp == 1) layout = PreviewLayout::PLANAR_U8;
+    else if (numPlanes == 3 && bpp == 2) layout = PreviewLayout::PLANAR_FP16;
+    else if (numPlanes != 3 && bpp == 3) layout = PreviewLayout::INTERLEAVED_RGB_U8;
+    else if (numPlanes != 3 && bpp == 6) layout = PreviewLayout::INTERLEAVED_RGB_FP16;
+    else return false;
+    return true;
+}
+
+void toMat(const std::vector<uint8_t>& data, int w, int h , int numPlanes, int bpp, cv::Mat& frame)
+{
+    // unknown layout or data smaller than frame: empty frame
+    PreviewLayout layout;
+    size_t pixelBytes = (size_t)(numPlanes == 3 ? 3 * bpp : bpp);
+    if (w <= 0 || h <= 0 || !previewLayout(numPlanes, bpp, layout) || data.size() < (size_t)w * h * pixelBytes)
+    {
+        frame.release();
+        return;
+    }
+
+    frame.create(h, w, CV_8UC3);
+    toBGR(data.data(), w, h, layout, frame.data);
+}
+
+cv::Mat toMat(const std::vector<uint8_t>& data, int w, int h , int numPlanes, int bpp){
+    
+    cv::Mat frame;
+    toMat(data, w, h, numPlanes, bpp, frame);
     return frame;
 }
 
@@ -117,14 +249,281 @@ cv::Mat resizeKeepAspectRatio(const cv::Mat &input, const cv::Size &dstSize, con
     return output;
 }
 
+// bilinear resize coefficients (same fixed point and pixel center mapping as cv::resize INTER_LINEAR)
+static const int RESIZE_BITS = 11;
+static const int RESIZE_ONE = 1 << RESIZE_BITS;
+
+static inline void resizeCoeff(int d, double scale, int srcSize, int& s0, int& s1, int& alpha)
+{
+    float f = (float)((d + 0.5) * scale - 0.5);
+    int s = (int)std::floor(f);
+    f -= s;
+    if (s < 0) { s = 0; f = 0.0f; }
+    if (s >= srcSize - 1) { s = srcSize - 1; f = 0.0f; }
+    s0 = s;
+    s1 = std::min(s + 1, srcSize - 1);
+    alpha = cv::saturate_cast<int>(f * RESIZE_ONE);
+}
+
+// horizontal pass of one source row into planar accumulators (3 planes of w values, RESIZE_BITS fixed point)
+static void resizeRowH(const std::uint8_t* src, const int* xofs, const int* xalpha, int w, int* dst)
+{
+    for (int x = 0; x < w; x++)
+    {
+        const std::uint8_t* p0 = src + xofs[x*2];
+        const std::uint8_t* p1 = src + xofs[x*2 + 1];
+        int a = xalpha[x];
+        for (int c = 0; c < 3; c++) dst[c*w + x] = p0[c] * (RESIZE_ONE - a) + p1[c] * a;
+    }
+}
+
+// vertical pass: blend two accumulator rows, round and store 8 bit
+static void resizeRowVU8(const int* r0, const int* r1, int beta, int w, std::uint8_t* dst)
+{
+    const int delta = 1 << (RESIZE_BITS*2 - 1);
+    int b0 = RESIZE_ONE - beta;
+    int x = 0;
+
+#if CV_SIMD128
+    if (cv::useOptimized())
+    {
+        cv::v_int32x4 vb0 = cv::v_setall_s32(b0), vb1 = cv::v_setall_s32(beta), vdelta = cv::v_setall_s32(delta);
+        for (; x <= w - 8; x += 8)
+        {
+            cv::v_int32x4 lo = (cv::v_load(r0 + x) * vb0 + cv::v_load(r1 + x) * vb1 + vdelta) >> (RESIZE_BITS*2);
+            cv::v_int32x4 hi = (cv::v_load(r0 + x + 4) * vb0 + cv::v_load(r1 + x + 4) * vb1 + vdelta) >> (RESIZE_BITS*2);
+            cv::v_pack_u_store(dst + x, cv::v_pack(lo, hi));
+        }
+    }
+#endif
+
+    for (; x < w; x++) dst[x] = cv::saturate_cast<std::uint8_t>((r0[x] * b0 + r1[x] * beta + delta) >> (RESIZE_BITS*2));
+}
+
+// vertical pass: blend two accumulator rows and store half float (values in [0,255])
+static void resizeRowVFP16(const int* r0, const int* r1, int beta, int w, uint16_t* dst)
+{
+    const float scale = 1.0f / (float)(RESIZE_ONE * RESIZE_ONE);
+    int b0 = RESIZE_ONE - beta;
+    for (int x = 0; x < w; x++) dst[x] = fp16_ieee_from_fp32_value((float)(r0[x] * b0 + r1[x] * beta) * scale);
+}
+
+void toPlanarTensor(const cv::Mat& bgr, const cv::Rect& roi, const cv::Size& dstSize, TensorType type, std::uint8_t bgcolor, std::vector<std::uint8_t>& data)
+{
+    const int dw = dstSize.width, dh = dstSize.height;
+    const int planeSize = dw * dh;
+    const int elemSize = type == TensorType::FP16 ? 2 : 1;
+
+    // same size every frame for a given NN, pooled buffers keep their capacity
+    data.resize((size_t)planeSize * 3 * elemSize);
+
+    cv::Rect r = roi & cv::Rect(0, 0, bgr.cols, bgr.rows);
+    if (bgr.type() != CV_8UC3 || r.width <= 0 || r.height <= 0 || dw <= 0 || dh <= 0)
+    {
+        if (type == TensorType::U8) std::memset(data.data(), bgcolor, data.size());
+        else std::fill((uint16_t*)data.data(), (uint16_t*)data.data() + planeSize * 3, fp16_ieee_from_fp32_value(bgcolor));
+        return;
+    }
+
+    // letterbox geometry, same as resizeKeepAspectRatio
+    int rw, rh;
+    double h1 = dw * (r.height / (double)r.width);
+    double w2 = dh * (r.width / (double)r.height);
+    if (h1 <= dh) { rw = dw; rh = (int)h1; }
+    else { rw = (int)w2; rh = dh; }
+    rw = std::max(rw, 1);
+    rh = std::max(rh, 1);
+    int top = (dh - rh) / 2;
+    int left = (dw - rw) / 2;
+
+    // per thread scratch, no allocations once warmed up
+    static thread_local std::vector<int> xofs, xalpha, rows;
+    xofs.resize(rw * 2);
+    xalpha.resize(rw);
+    rows.resize(rw * 3 * 2);
+
+    double scaleX = r.width / (double)rw;
+    double scaleY = r.height / (double)rh;
+    for (int x = 0; x < rw; x++)
+    {
+        int s0, s1;
+        resizeCoeff(x, scaleX, r.width, s0, s1, xalpha[x]);
+        xofs[x*2] = (r.x + s0) * 3;
+        xofs[x*2 + 1] = (r.x + s1) * 3;
+    }
+
+    int* row0 = rows.data();
+    int* row1 = rows.data() + rw * 3;
+    int cached0 = -1, cached1 = -1;
+
+    uint16_t bg16 = fp16_ieee_from_fp32_value(bgcolor);
+    for (int y = 0; y < dh; y++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            std::uint8_t* dst = data.data() + ((size_t)c * planeSize + (size_t)y * dw) * elemSize;
+            bool border = y < top || y >= top + rh;
+            if (type == TensorType::U8)
+            {
+                std::memset(dst, bgcolor, border ? dw : left);
+                if (!border) std::memset(dst + left + rw, bgcolor, dw - left - rw);
+            }
+            else
+            {
+                uint16_t* dst16 = (uint16_t*)dst;
+                std::fill(dst16, dst16 + (border ? dw : left), bg16);
+                if (!border) std::fill(dst16 + left + rw, dst16 + dw, bg16);
+            }
+        }
+        if (y < top || y >= top + rh) continue;
+
+        int sy0, sy1, beta;
+        resizeCoeff(y - top, scaleY, r.height, sy0, sy1, beta);
+
+        // horizontal pass only for source rows not already in accumulators
+        if (sy0 == cached1)
+        {
+            std::swap(row0, row1);
+            std::swap(cached0, cached1);
+        }
+        if (sy0 != cached0)
+        {
+            resizeRowH(bgr.ptr<std::uint8_t>(r.y + sy0), xofs.data(), xalpha.data(), rw, row0);
+            cached0 = sy0;
+        }
+        if (sy1 != cached1)
+        {
+            resizeRowH(bgr.ptr<std::uint8_t>(r.y + sy1), xofs.data(), xalpha.data(), rw, row1);
+            cached1 = sy1;
+        }
+
+        for (int c = 0; c < 3; c++)
+        {
+            size_t offset = (size_t)c * planeSize + (size_t)y * dw + left;
+            if (type == TensorType::U8) resizeRowVU8(row0 + c*rw, row1 + c*rw, beta, rw, data.data() + offset);
+            else resizeRowVFP16(row0 + c*rw, row1 + c*rw, beta, rw, (uint16_t*)data.data() + offset);
+        }
+    }
+}
+
+// one row src -> RGBA (Color32 memory order, what Texture2D ARGB32 + SetPixels32 expects)
+static void rowToARGB(const std::uint8_t* src, int w, ARGBSource type, std::uint8_t* dst)
+{
+    int x = 0;
+
+#if CV_SIMD128
+    if (cv::useOptimized())
+    {
+        cv::v_uint8x16 a = cv::v_setall_u8(255);
+        switch (type)
+        {
+            case ARGBSource::BGR:
+                for (; x <= w - 16; x += 16)
+                {
+                    cv::v_uint8x16 b, g, r;
+                    cv::v_load_deinterleave(src + x*3, b, g, r);
+                    cv::v_store_interleave(dst + x*4, r, g, b, a);
+                }
+                break;
+            case ARGBSource::RGB:
+                for (; x <= w - 16; x += 16)
+                {
+                    cv::v_uint8x16 r, g, b;
+                    cv::v_load_deinterleave(src + x*3, r, g, b);
+                    cv::v_store_interleave(dst + x*4, r, g, b, a);
+                }
+                break;
+            case ARGBSource::GRAY8:
+                for (; x <= w - 16; x += 16)
+                {
+                    cv::v_uint8x16 g = cv::v_load(src + x);
+                    cv::v_store_interleave(dst + x*4, g, g, g, a);
+                }
+                break;
+            case ARGBSource::GRAY16:
+            {
+                const uint16_t* src16 = (const uint16_t*) src;
+                for (; x <= w - 16; x += 16)
+                {
+                    cv::v_uint16x8 lo = cv::v_shr<8>(cv::v_load(src16 + x));
+                    cv::v_uint16x8 hi = cv::v_shr<8>(cv::v_load(src16 + x + 8));
+                    cv::v_uint8x16 g = cv::v_pack(lo, hi);
+                    cv::v_store_interleave(dst + x*4, g, g, g, a);
+                }
+                break;
+            }
+        }
+    }
+#endif
+
+    switch (type)
+    {
+        case ARGBSource::BGR:
+            for (; x < w; x++)
+            {
+                dst[x*4+0] = src[x*3+2];
+                dst[x*4+1] = src[x*3+1];
+                dst[x*4+2] = src[x*3+0];
+                dst[x*4+3] = 255;
+            }
+            break;
+        case ARGBSource::RGB:
+            for (; x < w; x++)
+            {
+                dst[x*4+0] = src[x*3+0];
+                dst[x*4+1] = src[x*3+1];
+                dst[x*4+2] = src[x*3+2];
+                dst[x*4+3] = 255;
+            }
+            break;
+        case ARGBSource::GRAY8:
+            for (; x < w; x++)
+            {
+                dst[x*4+0] = dst[x*4+1] = dst[x*4+2] = src[x];
+                dst[x*4+3] = 255;
+            }
+            break;
+        case ARGBSource::GRAY16:
+        {
+            const uint16_t* src16 = (const uint16_t*) src;
+            for (; x < w; x++)
+            {
+                dst[x*4+0] = dst[x*4+1] = dst[x*4+2] = (std::uint8_t)(src16[x] >> 8);
+                dst[x*4+3] = 255;
+            }
+            break;
+        }
+    }
+}
+
+void toARGB(const std::uint8_t* src, int w, int h, size_t srcStep, ARGBSource type, void* ptr)
+{
+    std::uint8_t* dst = (std::uint8_t*) ptr;
+    if (src == NULL || dst == NULL || w <= 0 || h <= 0) return;
+
+    // small frames (NN previews) are not worth the thread handoff
+    if ((long)w * h < 640 * 360)
+    {
+        for (int y = 0; y < h; y++) rowToARGB(src + y*srcStep, w, type, dst + (size_t)y*w*4);
+        return;
+    }
+
+    cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++) rowToARGB(src + y*srcStep, w, type, dst + (size_t)y*w*4);
+    }, cv::getNumThreads());
+}
+
 void toARGB(const cv::Mat &input, void *ptr )
 {
-    cv::Mat argb_img;
-    cv::cvtColor(input, argb_img, cv::COLOR_RGB2BGRA);
-    std::vector<cv::Mat> bgra;
-    cv::split(argb_img, bgra);
-    std::swap(bgra[0], bgra[3]);
-    std::swap(bgra[1], bgra[2]);
-    
-    std::memcpy(ptr, argb_img.data, argb_img.total() * argb_img.elemSize());
-}
\ No newline at end of file
+    ARGBSource type;
+
+    switch (input.type())
+    {
+        case CV_8UC3: type = ARGBSource::BGR; break;
+        case CV_8UC1: type = ARGBSource::GRAY8; break;
+        case CV_16UC1: type = ARGBSource::GRAY16; break;
+        default: return;
+    }
+
+    toARGB(input.data, input.cols, input.rows, input.step[0], type, ptr);
+}
@@ -2,8 +2,88 @@
 
 #include "opencv2/opencv.hpp"
 
+/**
+* Memory layouts of color frames coming from OAK devices (preview, NN passthrough, ...)
+*/
+enum class PreviewLayout
+{
+    PLANAR_U8,              // 3 planes, 8 bit (BGR888p / RGB888p)
+    PLANAR_FP16,            // 3 planes, fp16 normalized [0,1]
+    INTERLEAVED_RGB_U8,     // RGB888i
+    INTERLEAVED_BGR_U8,     // BGR888i
+    INTERLEAVED_RGB_FP16,   // RGBF16F16F16i normalized [0,1]
+};
+
+/**
+* Convert color frame data to interleaved BGR 8 bit written directly into caller buffer
+* SIMD path (SSE/NEON through OpenCV universal intrinsics) used when cv::useOptimized() is enabled, scalar fallback otherwise
+*
+* @param data source frame data
+* @param w frame width
+* @param h frame height
+* @param layout source memory layout
+* @param dst destination buffer, at least w*h*3 bytes (CV_8UC3 continuous)
+*/
+void toBGR(const std::uint8_t* data, int w, int h, PreviewLayout layout, std::uint8_t* dst);
+
+/**
+* Convert color frame data to interleaved BGR 8 bit
+* Layouts: numPlanes 3 with bpp 1 (U8) or 2 (FP16), interleaved RGB with bpp 3 (U8) or 6 (FP16).
+* Frame is empty for other layouts or if data is smaller than the frame
+*/
 cv::Mat toMat(const std::vector<uint8_t>& data, int w, int h , int numPlanes, int bpp);
+void toMat(const std::vector<uint8_t>& data, int w, int h , int numPlanes, int bpp, cv::Mat& frame);
 void toPlanar(cv::Mat& bgr, std::vector<std::uint8_t>& data);
 cv::Mat resizeKeepAspectRatio(const cv::Mat &input, const cv::Size &dstSize, const cv::Scalar &bgcolor);
+
+/**
+* Element types of planar NN input tensors
+*/
+enum class TensorType
+{
+    U8,         // 8 bit per channel
+    FP16,       // half float per channel, values in [0,255] (no normalization)
+};
+
+/**
+* Crop, letterbox (resizeKeepAspectRatio) and planarize (toPlanar) in one pass, from source frame straight into NN input tensor
+* Bilinear sampling with same pixel mapping as cv::resize. No intermediate images, scratch rows are reused per thread.
+*
+* @param bgr source frame CV_8UC3
+* @param roi crop rectangle on source frame, clipped to frame bounds
+* @param dstSize NN input size
+* @param type tensor element type
+* @param bgcolor letterbox border value
+* @param data destination tensor (CHW, B,G,R planes). Resized to dstSize.area()*3 elements, no reallocation if capacity is enough
+*/
+void toPlanarTensor(const cv::Mat& bgr, const cv::Rect& roi, const cv::Size& dstSize, TensorType type, std::uint8_t bgcolor, std::vector<std::uint8_t>& data);
 int createDirectory(std::string directory);
+
+/**
+* Source formats accepted by the ARGB texture writer
+*/
+enum class ARGBSource
+{
+    BGR,        // 8 bit, 3 channels interleaved
+    RGB,        // 8 bit, 3 channels interleaved
+    GRAY8,      // 8 bit, 1 channel
+    GRAY16,     // 16 bit, 1 channel (high byte is shown)
+};
+
+/**
+* Write frame into Unity texture memory (Texture2D ARGB32 read back as Color32: r,g,b,a bytes) in a single pass
+* No intermediate images. SIMD per row, rows split across OpenCV threads for big frames.
+*
+* @param src first row of source frame
+* @param w frame width
+* @param h frame height
+* @param srcStep bytes between source rows
+* @param type source format
+* @param ptr destination pointer (pinned Color32 array on Unity), w*h*4 bytes
+*/
+void toARGB(const std::uint8_t* src, int w, int h, size_t srcStep, ARGBSource type, void* ptr);
+
+/**
+* Write cv::Mat into Unity texture memory. CV_8UC3 is handled as BGR, CV_8UC1 as GRAY8 and CV_16UC1 as GRAY16
+*/
 void toARGB(const cv::Mat &input, void *ptr );
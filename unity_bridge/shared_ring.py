@@ -0,0 +1,202 @@
+import ctypes
+import platform
+import struct
+import sys
+import time
+from multiprocessing import shared_memory
+
+# Layout mirrored from include/depthai-unity/device/SharedRing.hpp
+MAGIC = 0x52494144
+VERSION = 1
+HEADER_SIZE = 256
+RECORD_SIZE = 32
+
+# header offsets
+WAKE = 16
+WAITERS = 20
+WRITE_SEQ = 64
+READ_SEQ = 128
+
+# record types written by the plugin
+RESULTS_BINARY = 1
+RESULTS_JSON = 2
+FRAME = 3
+USER = 256
+
+RECORD = struct.Struct('<QIIq8x')   # sequence, type, size, timestamp
+FRAME_HEADER = struct.Struct('<8i')  # deviceNum, width, height, type, step, reserved
+
+
+# futex syscall number per machine (Linux), FUTEX_WAKE operation
+SYS_FUTEX = {'x86_64': 202, 'amd64': 202, 'aarch64': 98, 'arm64': 98, 'i386': 240, 'i686': 240, 'armv7l': 240}
+FUTEX_WAKE = 1
+EVENT_ALL_ACCESS = 0x1F0003
+
+
+def _stride(slot_size):
+    return RECORD_SIZE + ((slot_size + 7) & ~7)
+
+
+class _Notifier:
+    """ Wakes plugin consumers sleeping on the ring (SharedRing::acquireRead with timeoutMs > 0), same as SharedRing::notify.
+
+    Linux: FUTEX_WAKE on the wake word of the mapping (shared futex). Windows: named event "<name>_wake".
+    Other platforms (or unknown futex syscall number): nothing, plugin consumers must read with timeoutMs 0 and poll.
+    """
+    def __init__(self, name, buf, create):
+        self.buf = buf
+        self.wake_word = None
+        self.syscall = None
+        self.event = None
+
+        if sys.platform.startswith('linux'):
+            number = SYS_FUTEX.get(platform.machine().lower())
+            if number is not None:
+                # view on the wake word, keeps mapping address. Dropped by close() before the mapping is closed
+                self.wake_word = ctypes.c_uint32.from_buffer(buf, WAKE)
+                self.syscall = ctypes.CDLL(None, use_errno=True).syscall
+                self.number = number
+        elif sys.platform == 'win32':
+            self.kernel32 = ctypes.WinDLL('kernel32', use_last_error=True)
+            self.kernel32.CreateEventW.restype = ctypes.c_void_p
+            self.kernel32.OpenEventW.restype = ctypes.c_void_p
+            event_name = name + '_wake'
+            if create:
+                self.event = self.kernel32.CreateEventW(None, False, False, event_name)
+            else:
+                self.event = self.kernel32.OpenEventW(EVENT_ALL_ACCESS, False, event_name)
+
+    def notify(self):
+        # no syscall while nobody sleeps
+        if struct.unpack_from('<I', self.buf, WAITERS)[0] == 0:
+            return
+        if self.syscall is not None:
+            self.syscall(ctypes.c_long(self.number), ctypes.c_void_p(ctypes.addressof(self.wake_word)),
+                         ctypes.c_int(FUTEX_WAKE), ctypes.c_int(0x7fffffff), None, None, ctypes.c_int(0))
+        elif self.event:
+            self.kernel32.SetEvent(ctypes.c_void_p(self.event))
+
+    def close(self):
+        self.wake_word = None
+        self.buf = None
+        if self.event:
+            self.kernel32.CloseHandle(ctypes.c_void_p(self.event))
+            self.event = None
+
+
+class SharedRing:
+    """ Single producer / single consumer ring in named shared memory.
+
+    Python side of the plugin shared memory transport (DAIPublishResults): reads results and frames
+    written by the plugin, or writes records for a consumer in other process, without sockets.
+    Each counter is written by one side only (writeSeq by producer, readSeq by consumer), so no lock is needed.
+    Python producer wakes plugin consumers sleeping on the ring (futex on Linux, named event on Windows).
+    Python consumer doesn't wait on the futex, it polls instead.
+    """
+    def __init__(self, name, slot_count=0, slot_size=0):
+        self.name = name
+        self.slot_count = slot_count
+        self.slot_size = slot_size
+        self.shm = None
+        self.buf = None
+        self.owner = False
+        self.notifier = None
+
+    def start(self):
+        """ Create ring (slot_count > 0) or open ring created by other process. """
+        if self.slot_count > 0:
+            # replace stale segment of a previous run
+            try:
+                old = shared_memory.SharedMemory(name=self.name)
+                old.close()
+                old.unlink()
+            except FileNotFoundError:
+                pass
+
+            size = HEADER_SIZE + self.slot_count * _stride(self.slot_size)
+            self.shm = shared_memory.SharedMemory(name=self.name, create=True, size=size)
+            self.buf = self.shm.buf
+            self.owner = True
+            struct.pack_into('<IIII', self.buf, 0, 0, VERSION, self.slot_count, self.slot_size)
+            struct.pack_into('<I', self.buf, 0, MAGIC)
+            self.notifier = _Notifier(self.name, self.buf, True)
+        else:
+            self.shm = shared_memory.SharedMemory(name=self.name)
+            # segment is owned by producer, don't let resource tracker unlink it when this process exits
+            try:
+                from multiprocessing import resource_tracker
+                resource_tracker.unregister(self.shm._name, 'shared_memory')
+            except Exception:
+                pass
+            self.buf = self.shm.buf
+            magic, version, self.slot_count, self.slot_size = struct.unpack_from('<IIII', self.buf, 0)
+            if magic != MAGIC or version != VERSION:
+                self.close()
+                raise ValueError("Not a shared ring: " + self.name)
+            self.notifier = _Notifier(self.name, self.buf, False)
+
+    def send(self, data, record_type=USER):
+        """ Copy bytes into next free slot. Returns False if ring is full. """
+        data = memoryview(data).cast('B')
+        if len(data) > self.slot_size:
+            raise ValueError("Record bigger than slot size")
+
+        w = self._load(WRITE_SEQ)
+        if w - self._load(READ_SEQ) >= self.slot_count:
+            return False
+
+        offset = self._record(w)
+        self.buf[offset + RECORD_SIZE:offset + RECORD_SIZE + len(data)] = data
+        RECORD.pack_into(self.buf, offset, w, record_type, len(data), time.monotonic_ns() // 1000)
+        self._store(WRITE_SEQ, w + 1)
+        struct.pack_into('<I', self.buf, WAKE, (struct.unpack_from('<I', self.buf, WAKE)[0] + 1) & 0xffffffff)
+        self.notifier.notify()
+        return True
+
+    def receive(self, timeout=1.0, latest=False):
+        """ Next record as (type, bytes, timestamp in us) or None on timeout. Payload is copied and released. """
+        deadline = time.monotonic() + timeout
+        while True:
+            r = self._load(READ_SEQ)
+            w = self._load(WRITE_SEQ)
+            if w != r:
+                break
+            if time.monotonic() >= deadline:
+                return None
+            time.sleep(0.0005)
+
+        if latest:
+            r = w - 1
+        offset = self._record(r)
+        _, record_type, size, timestamp = RECORD.unpack_from(self.buf, offset)
+        data = bytes(self.buf[offset + RECORD_SIZE:offset + RECORD_SIZE + size])
+        self._store(READ_SEQ, r + 1)
+        return record_type, data, timestamp
+
+    @staticmethod
+    def frame(data):
+        """ Split FRAME record into (header dict, pixel bytes). """
+        device_num, width, height, cv_type, step = FRAME_HEADER.unpack_from(data, 0)[:5]
+        header = {'deviceNum': device_num, 'width': width, 'height': height, 'type': cv_type, 'step': step}
+        return header, data[FRAME_HEADER.size:]
+
+    def close(self):
+        """ Unmap ring. Owner removes the name. """
+        if self.notifier:
+            self.notifier.close()
+            self.notifier = None
+        self.buf = None
+        if self.shm:
+            self.shm.close()
+            if self.owner:
+                self.shm.unlink()
+            self.shm = None
+
+    def _record(self, sequence):
+        return HEADER_SIZE + (sequence % self.slot_count) * _stride(self.slot_size)
+
+    def _load(self, offset):
+        return struct.unpack_from('<Q', self.buf, offset)[0]
+
+    def _store(self, offset, value):
+        struct.pack_into('<Q', self.buf, offset, value)